@@ -26,16 +26,38 @@
 #include <math.h>
 
 #include <algorithm>
+#include <array>
 #include <vector>
 
 #include <boost/predef/other/endian.h>
 #include <boost/log/trivial.hpp>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 // Boost pool: Don't use mutexes to synchronize memory allocation.
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
 
 #include "stl.h"
 
+// Connect edge which_edge_a of facet_a with edge which_edge_b of facet_b.
+// An edge index is increased by 3 if the edge is stored backwards.
+static inline void connect_neighbors(stl_file *stl, int facet_a, int which_edge_a, int facet_b, int which_edge_b)
+{
+	// Facet a's neighbor is facet b
+	stl->neighbors_start[facet_a].neighbor[which_edge_a % 3] = facet_b;	/* sets the .neighbor part */
+	stl->neighbors_start[facet_a].which_vertex_not[which_edge_a % 3] = (which_edge_b + 2) % 3; /* sets the .which_vertex_not part */
+
+	// Facet b's neighbor is facet a
+	stl->neighbors_start[facet_b].neighbor[which_edge_b % 3] = facet_a;	/* sets the .neighbor part */
+	stl->neighbors_start[facet_b].which_vertex_not[which_edge_b % 3] = (which_edge_a + 2) % 3; /* sets the .which_vertex_not part */
+
+	if ((which_edge_a < 3 && which_edge_b < 3) || (which_edge_a > 2 && which_edge_b > 2)) {
+		// These facets are oriented in opposite directions, their normals are probably messed up.
+		stl->neighbors_start[facet_a].which_vertex_not[which_edge_a % 3] += 3;
+		stl->neighbors_start[facet_b].which_vertex_not[which_edge_b % 3] += 3;
+	}
+}
+
 struct HashEdge {
 	// Key of a hash edge: sorted vertices of the edge.
 	uint32_t       key[6];
@@ -242,19 +264,7 @@ private:
 	// Connect edge_a with edge_b, update edge connection statistics.
 	static void record_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
 	{
-		// Facet a's neighbor is facet b
-		stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		// Facet b's neighbor is facet a
-		stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
-			// These facets are oriented in opposite directions, their normals are probably messed up.
-			stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
-			stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
-		}
+		connect_neighbors(stl, edge_a.facet_number, edge_a.which_edge, edge_b.facet_number, edge_b.which_edge);
 
 		// Count successful connects:
 		// Total connects:
@@ -454,21 +464,108 @@ void stl_check_facets_exact(stl_file *stl)
 		  	++ i;
   	}
 
-  	// Initialize hash table.
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
 	for (auto &neighbor : stl->neighbors_start)
 		neighbor.reset();
 
-  	// Connect neighbor edges.
-	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
+	const uint32_t num_facets = stl->stats.number_of_facets;
+	for (uint32_t i = 0; i < num_facets; ++ i) {
 		const stl_facet &facet = stl->facet_start[i];
 		for (int j = 0; j < 3; ++ j) {
-			HashEdge edge;
-			edge.facet_number = i;
-			edge.which_edge = j;
-			edge.load_exact(stl, &facet.vertex[j], &facet.vertex[(j + 1) % 3]);
-			hash_table.insert_edge_exact(stl, edge);
+	    	stl_vertex diff = (facet.vertex[j] - facet.vertex[(j + 1) % 3]).cwiseAbs();
+	    	float max_diff = std::max(diff(0), std::max(diff(1), diff(2)));
+	    	stl->stats.shortest_edge = std::min(max_diff, stl->stats.shortest_edge);
+		}
+	}
+
+	// 1) Index the vertices, so that the edges may be compared by their vertex indices.
+	// The vertices are compared bitwise, with negative zeros switched to positive zeros.
+	std::vector<uint32_t> vertex_ids(size_t(num_facets) * 3);
+	{
+		auto vertex_key = [stl](uint32_t idx) {
+			std::array<uint32_t, 3> key;
+			memcpy(key.data(), stl->facet_start[idx / 3].vertex[idx % 3].data(), sizeof(stl_vertex));
+			for (uint32_t &k : key)
+				if (k == 0x80000000u)
+					// Negative zero, switch to positive zero.
+					k = 0;
+			return key;
+		};
+		std::vector<uint32_t> sorted(vertex_ids.size());
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(0, uint32_t(sorted.size())), [&sorted](const tbb::blocked_range<uint32_t> &range) {
+			for (uint32_t i = range.begin(); i < range.end(); ++ i)
+				sorted[i] = i;
+		});
+		tbb::parallel_sort(sorted.begin(), sorted.end(), [&vertex_key](uint32_t l, uint32_t r) { return vertex_key(l) < vertex_key(r); });
+		uint32_t vertex_id = 0;
+		for (size_t i = 0; i < sorted.size(); ++ i) {
+			if (i > 0 && vertex_key(sorted[i - 1]) != vertex_key(sorted[i]))
+				++ vertex_id;
+			vertex_ids[sorted[i]] = vertex_id;
+		}
+	}
+
+	// 2) Key the edges by their vertex indices, with an identical vertex ordering of equal edges.
+	// If an edge is stored backwards, its which_edge is increased by 3.
+	std::vector<uint64_t> edge_keys(vertex_ids.size());
+	std::vector<char>     which_edges(vertex_ids.size());
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, num_facets), [stl, &vertex_ids, &edge_keys, &which_edges](const tbb::blocked_range<uint32_t> &range) {
+		for (uint32_t i = range.begin(); i < range.end(); ++ i) {
+			const stl_facet &facet = stl->facet_start[i];
+			for (int j = 0; j < 3; ++ j) {
+				const stl_vertex &a = facet.vertex[j];
+				const stl_vertex &b = facet.vertex[(j + 1) % 3];
+				uint64_t id_a = vertex_ids[i * 3 + j];
+				uint64_t id_b = vertex_ids[i * 3 + (j + 1) % 3];
+				// This method is numerically robust.
+				bool     forward = (a(0) != b(0)) ? (a(0) < b(0)) : ((a(1) != b(1)) ? (a(1) < b(1)) : (a(2) < b(2)));
+				edge_keys[i * 3 + j]   = forward ? ((id_a << 32) | id_b) : ((id_b << 32) | id_a);
+				which_edges[i * 3 + j] = char(forward ? j : j + 3);
+			}
+		}
+	});
+
+	// 3) Sort the edges by their keys. Edges with equal keys stay sorted by their facet and edge index,
+	// that is in the order the edges used to be inserted into the edge hash table.
+	std::vector<uint32_t> sorted_edges(edge_keys.size());
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, uint32_t(sorted_edges.size())), [&sorted_edges](const tbb::blocked_range<uint32_t> &range) {
+		for (uint32_t i = range.begin(); i < range.end(); ++ i)
+			sorted_edges[i] = i;
+	});
+	tbb::parallel_sort(sorted_edges.begin(), sorted_edges.end(), [&edge_keys](uint32_t l, uint32_t r) {
+		return edge_keys[l] < edge_keys[r] || (edge_keys[l] == edge_keys[r] && l < r);
+	});
+
+	// 4) Connect the equal edges the same way the edge hash table did: An edge is connected to the first equal edge
+	// of another facet not connected yet. Each run of equal edges is processed by the thread, in which range it starts.
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, sorted_edges.size()), [stl, &edge_keys, &which_edges, &sorted_edges](const tbb::blocked_range<size_t> &range) {
+		std::vector<uint32_t> unconnected;
+		for (size_t run_begin = range.begin(); run_begin < range.end(); ++ run_begin) {
+			const uint64_t key = edge_keys[sorted_edges[run_begin]];
+			if (run_begin > 0 && edge_keys[sorted_edges[run_begin - 1]] == key)
+				// Not a start of a run of equal edges.
+				continue;
+			unconnected.clear();
+			for (size_t k = run_begin; k < sorted_edges.size() && edge_keys[sorted_edges[k]] == key; ++ k) {
+				const uint32_t edge  = sorted_edges[k];
+				const uint32_t facet = edge / 3;
+				auto it = std::find_if(unconnected.begin(), unconnected.end(), [facet](uint32_t other) { return other / 3 != facet; });
+				if (it == unconnected.end())
+					unconnected.emplace_back(edge);
+				else {
+					connect_neighbors(stl, int(facet), which_edges[edge], int(*it / 3), which_edges[*it]);
+					unconnected.erase(it);
+				}
+			}
 		}
+	});
+
+	// Count successful connects.
+	for (uint32_t i = 0; i < num_facets; ++ i) {
+		int num_neighbors = stl->neighbors_start[i].num_neighbors();
+		stl->stats.connected_edges         += num_neighbors;
+		stl->stats.connected_facets_1_edge += num_neighbors >= 1;
+		stl->stats.connected_facets_2_edge += num_neighbors >= 2;
+		stl->stats.connected_facets_3_edge += num_neighbors == 3;
 	}
 
 #if 0
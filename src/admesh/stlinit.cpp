@@ -26,10 +26,15 @@
 #include <math.h>
 #include <assert.h>
 
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/nowide/convert.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
 
+#include <tbb/parallel_for.h>
+
 #include "stl.h"
 
 #include "libslic3r/LocalesUtils.hpp"
@@ -232,6 +237,50 @@ static bool stl_read(stl_file *stl, FILE *fp, int first_facet, bool first)
   	return true;
 }
 
+/* Reads the facets of a binary STL file by memory mapping it and decoding the facets in parallel.
+   Returns false if the file could not be mapped, then the caller shall fall back to stl_read().
+   The facets are decoded into stl_file rather than straight into indexed_triangle_set, because the repair
+   on import and the mesh statistics work on the facets and their neighbors before the vertices are shared. */
+static bool stl_read_binary_mapped(stl_file *stl, const char *file)
+{
+	boost::iostreams::mapped_file_source mapped;
+	try {
+#ifdef _WIN32
+		// The file name is UTF-8 encoded as with boost::nowide::fopen(), while a narrow boost::filesystem::path would be interpreted in the ANSI code page.
+		mapped.open(boost::filesystem::path(boost::nowide::widen(file)));
+#else
+		mapped.open(boost::filesystem::path(file));
+#endif
+	} catch (const std::exception &) {
+		return false;
+	}
+	if (! mapped.is_open() || mapped.size() < HEADER_SIZE + size_t(stl->stats.number_of_facets) * SIZEOF_STL_FACET)
+		return false;
+
+	const char *data = mapped.data() + HEADER_SIZE;
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, stl->stats.number_of_facets, 4096),
+		[stl, data](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i) {
+			stl_facet &facet = stl->facet_start[i];
+			// We assume little-endian architecture!
+			memcpy(static_cast<void*>(&facet), data + i * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+#if BOOST_ENDIAN_BIG_BYTE
+			// Convert the loaded little endian data to big endian.
+			stl_internal_reverse_quads((char*)&facet, 48);
+#endif /* BOOST_ENDIAN_BIG_BYTE */
+		}
+	});
+
+	// The bounding box is accumulated in the order of the facets to produce the same result as stl_read()
+	// even if some of the vertices are not numbers.
+	bool first = true;
+	for (const stl_facet &facet : stl->facet_start)
+		stl_facet_stats(stl, facet, first);
+  	stl->stats.size = stl->stats.max - stl->stats.min;
+  	stl->stats.bounding_diameter = stl->stats.size.norm();
+	return true;
+}
+
 bool stl_open(stl_file *stl, const char *file)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
@@ -240,7 +289,11 @@ bool stl_open(stl_file *stl, const char *file)
 	if (fp == nullptr)
 		return false;
 	stl_allocate(stl);
-	bool result = stl_read(stl, fp, 0, true);
+	bool result;
+	if (stl->stats.type == binary && stl_read_binary_mapped(stl, file))
+		result = true;
+	else
+		result = stl_read(stl, fp, 0, true);
   	fclose(fp);
   	return result;
 }
@@ -0,0 +1,94 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Slic3r {
+
+char* MonotonicArena::allocate_slow(size_t bytes, size_t alignment)
+{
+    // Try the following blocks retained from before the last rewind, insert a new block if none of them is large enough.
+    size_t needed = bytes + alignment;
+    size_t idx    = m_blocks.empty() ? 0 : m_block + 1;
+    for (; idx < m_blocks.size() && m_blocks[idx].size < needed; ++ idx) ;
+    if (idx == m_blocks.size()) {
+        size_t size = std::max(m_block_size, needed);
+        m_blocks.push_back({ std::unique_ptr<char[]>(new char[size]), size });
+    } else if (idx > m_block + 1) {
+        // Move the large enough block just after the active one, the skipped blocks will be used next.
+        std::rotate(m_blocks.begin() + m_block + 1, m_blocks.begin() + idx, m_blocks.begin() + idx + 1);
+        idx = m_block + 1;
+    }
+    m_block = idx;
+    m_end   = m_blocks[idx].data.get() + m_blocks[idx].size;
+    char *ptr = align(m_blocks[idx].data.get(), alignment);
+    assert(ptr + bytes <= m_end);
+    return ptr;
+}
+
+void MonotonicArena::rewind(const Mark &mark)
+{
+    if (mark.ptr == nullptr) {
+        // Mark of an arena with no memory allocated yet.
+        m_block = 0;
+        m_ptr   = m_blocks.empty() ? nullptr : m_blocks.front().data.get();
+        m_end   = m_blocks.empty() ? nullptr : m_ptr + m_blocks.front().size;
+    } else {
+        assert(mark.block < m_blocks.size());
+        m_block = mark.block;
+        m_ptr   = mark.ptr;
+        m_end   = m_blocks[m_block].data.get() + m_blocks[m_block].size;
+    }
+}
+
+void MonotonicArena::release()
+{
+    m_blocks.clear();
+    m_block = 0;
+    m_ptr   = nullptr;
+    m_end   = nullptr;
+}
+
+void MonotonicArena::shrink(size_t max_retained)
+{
+    assert(m_block == 0 && (m_blocks.empty() || m_ptr == m_blocks.front().data.get()));
+    size_t retained = 0;
+    size_t num_retained = 0;
+    for (; num_retained < m_blocks.size() && retained + m_blocks[num_retained].size <= max_retained; ++ num_retained)
+        retained += m_blocks[num_retained].size;
+    if (num_retained == 0)
+        this->release();
+    else
+        m_blocks.erase(m_blocks.begin() + num_retained, m_blocks.end());
+}
+
+// Arena of each thread is allocated on the first use and the number of ArenaScopes active on the thread.
+static thread_local std::unique_ptr<MonotonicArena> s_thread_arena;
+static thread_local size_t                          s_thread_arena_scopes = 0;
+
+MonotonicArena* MonotonicArena::current()
+{
+    return s_thread_arena_scopes > 0 ? s_thread_arena.get() : nullptr;
+}
+
+// Memory retained by an idle thread arena for the next ArenaScope.
+static constexpr const size_t s_max_retained_idle = 4 * 1024 * 1024;
+
+ArenaScope::ArenaScope()
+{
+    if (! s_thread_arena)
+        s_thread_arena = std::make_unique<MonotonicArena>();
+    m_arena = s_thread_arena.get();
+    m_mark  = m_arena->mark();
+    ++ s_thread_arena_scopes;
+}
+
+ArenaScope::~ArenaScope()
+{
+    assert(s_thread_arena_scopes > 0 && m_arena == s_thread_arena.get());
+    m_arena->rewind(m_mark);
+    if (-- s_thread_arena_scopes == 0)
+        m_arena->shrink(s_max_retained_idle);
+}
+
+} // namespace Slic3r
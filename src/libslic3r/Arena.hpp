@@ -0,0 +1,124 @@
+#ifndef slic3r_Arena_hpp_
+#define slic3r_Arena_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Slic3r {
+
+// Monotonic (bump pointer) memory arena. Deallocation of a single allocation is a no-op,
+// memory is returned to the arena at once by rewinding it to a previously taken mark.
+// The arena keeps its memory blocks for reuse after rewinding.
+// Not thread safe, each thread owns its own arena, see ArenaScope.
+class MonotonicArena
+{
+public:
+    explicit MonotonicArena(size_t block_size = 256 * 1024) : m_block_size(block_size) {}
+    ~MonotonicArena() { this->release(); }
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena& operator=(const MonotonicArena &) = delete;
+
+    void* allocate(size_t bytes, size_t alignment) {
+        char *ptr = align(m_ptr, alignment);
+        if (ptr == nullptr || ptr + bytes > m_end)
+            ptr = this->allocate_slow(bytes, alignment);
+        m_ptr = ptr + bytes;
+        return ptr;
+    }
+
+    struct Mark {
+        size_t  block { 0 };
+        char   *ptr   { nullptr };
+    };
+    Mark    mark() const { return { m_block, m_ptr }; }
+    // Return all memory allocated after the mark was taken to the arena.
+    void    rewind(const Mark &mark);
+    // Free all memory blocks, the arena has to be empty.
+    void    release();
+    // Free the memory blocks above the first max_retained bytes of a fully rewound arena.
+    void    shrink(size_t max_retained);
+
+    // Arena of the calling thread if an ArenaScope is active on the calling thread, otherwise nullptr.
+    static MonotonicArena* current();
+
+private:
+    static char* align(char *ptr, size_t alignment)
+        { return ptr ? reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~uintptr_t(alignment - 1)) : nullptr; }
+    char*   allocate_slow(size_t bytes, size_t alignment);
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t                  size;
+    };
+    size_t              m_block_size;
+    std::vector<Block>  m_blocks;
+    // Index of the active block.
+    size_t              m_block { 0 };
+    char               *m_ptr   { nullptr };
+    char               *m_end   { nullptr };
+};
+
+// Activates the arena of the calling thread for the lifetime of the scope. All memory allocated through ArenaAllocator
+// on this thread while the scope is active is returned at once when the scope ends, for example after processing a layer.
+// Scopes may nest (a TBB worker waiting for nested parallel work may pick up a task opening its own scope),
+// the inner scope returns just the memory allocated since it was opened.
+// Containers using ArenaAllocator must not outlive the scope they were created in.
+class ArenaScope
+{
+public:
+    ArenaScope();
+    ~ArenaScope();
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope& operator=(const ArenaScope &) = delete;
+
+private:
+    MonotonicArena       *m_arena;
+    MonotonicArena::Mark  m_mark;
+};
+
+// Allocator allocating from the arena of the thread constructing it if an ArenaScope is active there,
+// from the heap otherwise. Thus containers using ArenaAllocator may be used by code running both inside and outside of an ArenaScope.
+template<typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    ArenaAllocator() : m_arena(MonotonicArena::current()) {}
+    explicit ArenaAllocator(MonotonicArena *arena) : m_arena(arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &rhs) : m_arena(rhs.arena()) {}
+
+    T*   allocate(size_t n) {
+        return m_arena ? static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))) : std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, size_t n) {
+        if (m_arena == nullptr)
+            std::allocator<T>().deallocate(p, n);
+    }
+    // A copy of a container allocates from the arena active at the copying thread.
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+    MonotonicArena* arena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &rhs) const { return m_arena == rhs.arena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &rhs) const { return m_arena != rhs.arena(); }
+
+private:
+    MonotonicArena *m_arena;
+};
+
+// Vector of temporaries, which are released at once at the end of the active ArenaScope.
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace Slic3r
+
+#endif // slic3r_Arena_hpp_
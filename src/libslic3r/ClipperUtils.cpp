@@ -159,12 +159,12 @@ bool has_duplicate_points(const ClipperLib::PolyTree &polytree)
 // Offset CCW contours outside, CW contours (holes) inside.
 // Don't calculate union of the output paths.
 template<typename PathsProvider, ClipperLib::EndType endType = ClipperLib::etClosedPolygon>
-static ClipperLib::Paths raw_offset(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+static ClipperLib::Paths raw_offset(ClipperUtils::Engine &engine, PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
 {
-    ClipperLib::ClipperOffset co;
+    ClipperLib::ClipperOffset &co = engine.offsetter;
     ClipperLib::Paths out;
     out.reserve(paths.size());
-    ClipperLib::Paths out_this;
+    ClipperLib::Paths &out_this = engine.offsetted;
     if (joinType == jtRound)
         co.ArcTolerance = miterLimit;
     else
@@ -188,7 +188,20 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, double offset, Clippe
     return out;
 }
 
+template<typename PathsProvider, ClipperLib::EndType endType = ClipperLib::etClosedPolygon>
+static ClipperLib::Paths raw_offset(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return raw_offset<PathsProvider, endType>(engine, std::forward<PathsProvider>(paths), offset, joinType, miterLimit);
+}
+
 // Offset outside by 10um, one by one.
+template<typename PathsProvider>
+static ClipperLib::Paths safety_offset(ClipperUtils::Engine &engine, PathsProvider &&paths)
+{
+    return raw_offset(engine, std::forward<PathsProvider>(paths), ClipperSafetyOffset, DefaultJoinType, DefaultMiterLimit);
+}
+
 template<typename PathsProvider>
 static ClipperLib::Paths safety_offset(PathsProvider &&paths)
 {
@@ -197,12 +210,14 @@ static ClipperLib::Paths safety_offset(PathsProvider &&paths)
 
 template<class TResult, class TSubj, class TClip>
 TResult clipper_do(
+    ClipperUtils::Engine          &engine,
     const ClipperLib::ClipType     clipType,
     TSubj &&                       subject,
     TClip &&                       clip,
     const ClipperLib::PolyFillType fillType)
 {
-    ClipperLib::Clipper clipper;
+    ClipperLib::Clipper &clipper = engine.clipper;
+    clipper.Clear();
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
@@ -210,6 +225,17 @@ TResult clipper_do(
     return retval;
 }
 
+template<class TResult, class TSubj, class TClip>
+TResult clipper_do(
+    const ClipperLib::ClipType     clipType,
+    TSubj &&                       subject,
+    TClip &&                       clip,
+    const ClipperLib::PolyFillType fillType)
+{
+    ClipperUtils::Engine engine;
+    return clipper_do<TResult>(engine, clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), fillType);
+}
+
 template<class TResult, class TSubj, class TClip>
 TResult clipper_do(
     const ClipperLib::ClipType     clipType,
@@ -227,17 +253,29 @@ TResult clipper_do(
 
 template<class TResult, class TSubj>
 TResult clipper_union(
+    ClipperUtils::Engine          &engine,
     TSubj &&                       subject,
     // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
     const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
 {
-    ClipperLib::Clipper clipper;
+    ClipperLib::Clipper &clipper = engine.clipper;
+    clipper.Clear();
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
     clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
+template<class TResult, class TSubj>
+TResult clipper_union(
+    TSubj &&                       subject,
+    // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
+    const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
+{
+    ClipperUtils::Engine engine;
+    return clipper_union<TResult>(engine, std::forward<TSubj>(subject), fillType);
+}
+
 // Perform union of input polygons using the positive rule, convert to ExPolygons.
 //FIXME is there any benefit of not doing the boolean / using pftEvenOdd?
 ExPolygons ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &input, bool do_union)
@@ -253,10 +291,17 @@ static ClipperLib::Paths raw_offset_polyline(PathsProvider &&paths, double offse
 }
 
 template<class TResult, typename PathsProvider>
-static TResult expand_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+static TResult expand_paths(ClipperUtils::Engine &engine, PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(offset > 0);
-    return clipper_union<TResult>(raw_offset(std::forward<PathsProvider>(paths), offset, joinType, miterLimit));
+    return clipper_union<TResult>(engine, raw_offset(engine, std::forward<PathsProvider>(paths), offset, joinType, miterLimit));
+}
+
+template<class TResult, typename PathsProvider>
+static TResult expand_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return expand_paths<TResult>(engine, std::forward<PathsProvider>(paths), offset, joinType, miterLimit);
 }
 
 // used by shrink_paths()
@@ -267,29 +312,45 @@ template<> void remove_outermost_polygon<ClipperLib::PolyTree>(ClipperLib::PolyT
     { solution.RemoveOutermostPolygon(); }
 
 template<class TResult, typename PathsProvider>
-static TResult shrink_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+static TResult shrink_paths(ClipperUtils::Engine &engine, PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(offset > 0);
     TResult out;
-    if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
+    if (auto raw = raw_offset(engine, std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
+        ClipperLib::Clipper &clipper = engine.clipper;
+        clipper.Clear();
         clipper.AddPaths(raw, ClipperLib::ptSubject, true);
         ClipperLib::IntRect r = clipper.GetBounds();
         clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
         clipper.ReverseSolution(true);
         clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        clipper.ReverseSolution(false);
         remove_outermost_polygon(out);
     }
     return out;
 }
 
 template<class TResult, typename PathsProvider>
-static TResult offset_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+static TResult shrink_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return shrink_paths<TResult>(engine, std::forward<PathsProvider>(paths), offset, joinType, miterLimit);
+}
+
+template<class TResult, typename PathsProvider>
+static TResult offset_paths(ClipperUtils::Engine &engine, PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(offset != 0);
     return offset > 0 ?
-        expand_paths<TResult>(std::forward<PathsProvider>(paths),   offset, joinType, miterLimit) :
-        shrink_paths<TResult>(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit);
+        expand_paths<TResult>(engine, std::forward<PathsProvider>(paths),   offset, joinType, miterLimit) :
+        shrink_paths<TResult>(engine, std::forward<PathsProvider>(paths), - offset, joinType, miterLimit);
+}
+
+template<class TResult, typename PathsProvider>
+static TResult offset_paths(PathsProvider &&paths, double offset, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return offset_paths<TResult>(engine, std::forward<PathsProvider>(paths), offset, joinType, miterLimit);
 }
 
 Slic3r::Polygons offset(const Slic3r::Polygon &polygon, const double delta, ClipperLib::JoinType joinType, double miterLimit)
@@ -306,12 +367,13 @@ Slic3r::Polygons offset(const Slic3r::Polylines &polylines, const double delta,
     { assert(delta > 0); return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::PolylinesProvider(polylines), delta, joinType, miterLimit))); }
 
 // returns number of expolygons collected (0 or 1).
-static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
+static int offset_expolygon_inner(ClipperUtils::Engine &engine, const Slic3r::ExPolygon &expoly, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
 {
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        ClipperLib::ClipperOffset &co = engine.offsetter;
+        co.Clear();
         if (joinType == jtRound)
             co.ArcTolerance = miterLimit;
         else
@@ -332,14 +394,15 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const double
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                ClipperLib::ClipperOffset &co = engine.offsetter;
+                co.Clear();
                 if (joinType == jtRound)
                     co.ArcTolerance = miterLimit;
                 else
                     co.MiterLimit = miterLimit;
                 co.ShortestEdgeLength = double(std::abs(delta * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
                 co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
-                ClipperLib::Paths out2;
+                ClipperLib::Paths &out2 = engine.offsetted;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
@@ -355,7 +418,7 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const double
         } else if (delta < 0) {
             // Negative offset. There is a chance, that the offsetted hole intersects the outer contour. 
             // Subtract the offsetted holes from the offsetted contours.            
-            if (auto output = clipper_do<ClipperLib::Paths>(ClipperLib::ctDifference, contours, holes, ClipperLib::pftNonZero); ! output.empty()) {
+            if (auto output = clipper_do<ClipperLib::Paths>(engine, ClipperLib::ctDifference, contours, holes, ClipperLib::pftNonZero); ! output.empty()) {
                 append(out, std::move(output));
             } else {
                 // The offsetted holes have eaten up the offsetted outer contour.
@@ -377,15 +440,16 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const double
     return 1;
 }
 
-static int offset_expolygon_inner(const Slic3r::Surface &surface, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
-    { return offset_expolygon_inner(surface.expolygon, delta, joinType, miterLimit, out); }
-static int offset_expolygon_inner(const Slic3r::Surface *surface, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
-    { return offset_expolygon_inner(surface->expolygon, delta, joinType, miterLimit, out); }
+static int offset_expolygon_inner(ClipperUtils::Engine &engine, const Slic3r::Surface &surface, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
+    { return offset_expolygon_inner(engine, surface.expolygon, delta, joinType, miterLimit, out); }
+static int offset_expolygon_inner(ClipperUtils::Engine &engine, const Slic3r::Surface *surface, const double delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::Paths &out)
+    { return offset_expolygon_inner(engine, surface->expolygon, delta, joinType, miterLimit, out); }
 
 ClipperLib::Paths expolygon_offset(const Slic3r::ExPolygon &expolygon, const double delta, ClipperLib::JoinType joinType, double miterLimit)
 {
+    ClipperUtils::Engine engine;
     ClipperLib::Paths out;
-    offset_expolygon_inner(expolygon, delta, joinType, miterLimit, out);
+    offset_expolygon_inner(engine, expolygon, delta, joinType, miterLimit, out);
     return out;
 }
 
@@ -393,7 +457,7 @@ ClipperLib::Paths expolygon_offset(const Slic3r::ExPolygon &expolygon, const dou
 // It is required, that the input expolygons do not overlap and that the holes of each ExPolygon don't intersect with their respective outer contours.
 // Each ExPolygon is offsetted separately. For outer offset, the the offsetted ExPolygons shall be united outside of this function.
 template<typename ExPolygonVector>
-static std::pair<ClipperLib::Paths, size_t> expolygons_offset_raw(const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
+static std::pair<ClipperLib::Paths, size_t> expolygons_offset_raw(ClipperUtils::Engine &engine, const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
 {
     // Offsetted ExPolygons before they are united.
     ClipperLib::Paths output;
@@ -402,30 +466,44 @@ static std::pair<ClipperLib::Paths, size_t> expolygons_offset_raw(const ExPolygo
     // If only one, then there is no need to do a final union.
     size_t expolygons_collected = 0;
     for (const auto &expoly : expolygons)
-        expolygons_collected += offset_expolygon_inner(expoly, delta, joinType, miterLimit, output);
+        expolygons_collected += offset_expolygon_inner(engine, expoly, delta, joinType, miterLimit, output);
     return std::make_pair(std::move(output), expolygons_collected);
 }
 
 // See comment on expolygon_offsets_raw. In addition, for positive offset the contours are united.
 template<typename ExPolygonVector>
-static ClipperLib::Paths expolygons_offset(const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
+static ClipperLib::Paths expolygons_offset(ClipperUtils::Engine &engine, const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
 {
-    auto [output, expolygons_collected] = expolygons_offset_raw(expolygons, delta, joinType, miterLimit);
+    auto [output, expolygons_collected] = expolygons_offset_raw(engine, expolygons, delta, joinType, miterLimit);
     // Unite the offsetted expolygons.
     return expolygons_collected > 1 && delta > 0 ?
         // There is a chance that the outwards offsetted expolygons may intersect. Perform a union.
-        clipper_union<ClipperLib::Paths>(output) :
+        clipper_union<ClipperLib::Paths>(engine, output) :
         // Negative offset. The shrunk expolygons shall not mutually intersect. Just copy the output.
         output;
 }
 
+template<typename ExPolygonVector>
+static ClipperLib::Paths expolygons_offset(const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return expolygons_offset(engine, expolygons, delta, joinType, miterLimit);
+}
+
 // See comment on expolygons_offset_raw. In addition, the polygons are always united to conver to polytree.
 template<typename ExPolygonVector>
-static ClipperLib::PolyTree expolygons_offset_pt(const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
+static ClipperLib::PolyTree expolygons_offset_pt(ClipperUtils::Engine &engine, const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
 {
-    auto [output, expolygons_collected] = expolygons_offset_raw(expolygons, delta, joinType, miterLimit);
+    auto [output, expolygons_collected] = expolygons_offset_raw(engine, expolygons, delta, joinType, miterLimit);
     // Unite the offsetted expolygons for both the 
-    return clipper_union<ClipperLib::PolyTree>(output);
+    return clipper_union<ClipperLib::PolyTree>(engine, output);
+}
+
+template<typename ExPolygonVector>
+static ClipperLib::PolyTree expolygons_offset_pt(const ExPolygonVector &expolygons, const double delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    ClipperUtils::Engine engine;
+    return expolygons_offset_pt(engine, expolygons, delta, joinType, miterLimit);
 }
 
 Slic3r::Polygons offset(const Slic3r::ExPolygon &expolygon, const double delta, ClipperLib::JoinType joinType, double miterLimit)
@@ -716,6 +794,132 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons & expolygons1, const Slic3r
     //return _clipper_ex(ClipperLib::ctUnion, to_polygons(subject1), to_polygons(subject2), safety_offset_);
 }
 
+// Call fn with the current state of the batch: the input if no operation was executed yet, otherwise the result of the last operation.
+template<typename Fn>
+ClipperLib::Paths ClipperBatch::visit(Fn &&fn)
+{
+    ClipperLib::Paths out = m_input_expolygons ? fn(ClipperUtils::ExPolygonsProvider(*m_input_expolygons)) :
+                            m_input_polygons   ? fn(ClipperUtils::PolygonsProvider(*m_input_polygons)) :
+                                                 fn(m_paths);
+    m_input_expolygons = nullptr;
+    m_input_polygons   = nullptr;
+    return out;
+}
+
+// The result of a boolean operation converted to ExPolygons, so that it is offsetted the same way as by offset_ex(diff_ex()):
+// The ExPolygons are offsetted one by one, the holes are offsetted together with their contours.
+Slic3r::ExPolygons ClipperBatch::boolean_expolygons()
+{
+    assert(m_paths_boolean);
+    m_paths_boolean = false;
+    return PolyTreeToExPolygons(clipper_union<ClipperLib::PolyTree>(m_engine, m_paths));
+}
+
+void ClipperBatch::flush()
+{
+    if (m_offset_pending) {
+        m_offset_pending = false;
+        m_paths = m_input_expolygons ?
+            expolygons_offset(m_engine, *m_input_expolygons, m_offset_delta, m_offset_join_type, m_offset_miter_limit) :
+            m_paths_boolean ?
+            expolygons_offset(m_engine, this->boolean_expolygons(), m_offset_delta, m_offset_join_type, m_offset_miter_limit) :
+            this->visit([this](auto &&paths) {
+                return offset_paths<ClipperLib::Paths>(m_engine, paths, m_offset_delta, m_offset_join_type, m_offset_miter_limit); });
+        m_input_expolygons = nullptr;
+    }
+}
+
+ClipperLib::Paths& ClipperBatch::paths()
+{
+    this->flush();
+    if (m_input_expolygons || m_input_polygons)
+        m_paths = this->visit([](auto &&paths) { return ClipperLib::Paths(paths.begin(), paths.end()); });
+    return m_paths;
+}
+
+ClipperBatch& ClipperBatch::offset(const double delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    this->flush();
+    m_offset_pending     = true;
+    m_offset_delta       = delta;
+    m_offset_join_type   = joinType;
+    m_offset_miter_limit = miterLimit;
+    return *this;
+}
+
+template<typename ClipProvider>
+ClipperBatch& ClipperBatch::boolean(ClipperLib::ClipType clipType, ClipProvider &&clip, ApplySafetyOffset do_safety_offset)
+{
+    assert(do_safety_offset == ApplySafetyOffset::No || clipType != ClipperLib::ctUnion);
+    this->flush();
+    m_paths = this->visit([this, clipType, &clip, do_safety_offset](auto &&subject) {
+        return do_safety_offset == ApplySafetyOffset::Yes ?
+            clipper_do<ClipperLib::Paths>(m_engine, clipType, subject, safety_offset(m_engine, clip), ClipperLib::pftNonZero) :
+            clipper_do<ClipperLib::Paths>(m_engine, clipType, subject, clip, ClipperLib::pftNonZero);
+    });
+    // Same as clipper_do_polytree(), which is used by the _ex boolean operations.
+    remove_small_areas(m_paths);
+    m_paths_boolean = true;
+    return *this;
+}
+
+ClipperBatch& ClipperBatch::diff(const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+ClipperBatch& ClipperBatch::diff(const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctDifference, ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+ClipperBatch& ClipperBatch::diff(ClipperBatch &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctDifference, clip.paths(), do_safety_offset); }
+ClipperBatch& ClipperBatch::intersection(const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctIntersection, ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+ClipperBatch& ClipperBatch::intersection(const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctIntersection, ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+ClipperBatch& ClipperBatch::intersection(ClipperBatch &clip, ApplySafetyOffset do_safety_offset)
+    { return this->boolean(ClipperLib::ctIntersection, clip.paths(), do_safety_offset); }
+ClipperBatch& ClipperBatch::union_()
+    { return this->boolean(ClipperLib::ctUnion, ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No); }
+ClipperBatch& ClipperBatch::union_(const Slic3r::Polygons &other)
+    { return this->boolean(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(other), ApplySafetyOffset::No); }
+ClipperBatch& ClipperBatch::union_(const Slic3r::ExPolygons &other)
+    { return this->boolean(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(other), ApplySafetyOffset::No); }
+ClipperBatch& ClipperBatch::union_(ClipperBatch &other)
+    { return this->boolean(ClipperLib::ctUnion, other.paths(), ApplySafetyOffset::No); }
+
+Slic3r::Polygons ClipperBatch::polygons()
+{
+    this->flush();
+    if (m_input_expolygons || m_input_polygons)
+        this->union_();
+    m_paths_boolean = false;
+    return to_polygons(std::move(m_paths));
+}
+
+Slic3r::ExPolygons ClipperBatch::expolygons()
+{
+    ClipperLib::PolyTree polytree;
+    if (m_offset_pending) {
+        // Offset directly into a PolyTree, saving one union.
+        m_offset_pending = false;
+        if (m_input_expolygons)
+            polytree = expolygons_offset_pt(m_engine, *m_input_expolygons, m_offset_delta, m_offset_join_type, m_offset_miter_limit);
+        else if (m_input_polygons)
+            polytree = offset_paths<ClipperLib::PolyTree>(m_engine, ClipperUtils::PolygonsProvider(*m_input_polygons), m_offset_delta, m_offset_join_type, m_offset_miter_limit);
+        else if (m_paths_boolean)
+            polytree = expolygons_offset_pt(m_engine, this->boolean_expolygons(), m_offset_delta, m_offset_join_type, m_offset_miter_limit);
+        else
+            polytree = offset_paths<ClipperLib::PolyTree>(m_engine, m_paths, m_offset_delta, m_offset_join_type, m_offset_miter_limit);
+    } else if (m_input_expolygons)
+        polytree = clipper_union<ClipperLib::PolyTree>(m_engine, ClipperUtils::ExPolygonsProvider(*m_input_expolygons));
+    else if (m_input_polygons)
+        polytree = clipper_union<ClipperLib::PolyTree>(m_engine, ClipperUtils::PolygonsProvider(*m_input_polygons));
+    else
+        polytree = clipper_union<ClipperLib::PolyTree>(m_engine, m_paths);
+    m_input_expolygons = nullptr;
+    m_input_polygons   = nullptr;
+    m_paths.clear();
+    m_paths_boolean    = false;
+    return PolyTreeToExPolygons(std::move(polytree));
+}
+
 #define CLIPPER_OFFSET_POWER_OF_2 17
 #define CLIPPER_OFFSET_SCALE (1 << CLIPPER_OFFSET_POWER_OF_2)
 #define CLIPPER_OFFSET_SCALE_ROUNDING_DELTA ((1 << (CLIPPER_OFFSET_POWER_OF_2 - 1)) - 1)
@@ -296,6 +296,14 @@ namespace ClipperUtils {
         const SurfacesPtr &m_surfaces;
         size_t             m_size;
     };
+
+    // Clipper objects and scratch buffers, which may be reused by a sequence of Clipper operations, see ClipperBatch.
+    struct Engine {
+        ClipperLib::Clipper         clipper;
+        ClipperLib::ClipperOffset   offsetter;
+        // Output of offsetting a single path.
+        ClipperLib::Paths           offsetted;
+    };
 }
 
 // Perform union of input polygons using the non-zero rule, convert to ExPolygons.
@@ -551,6 +559,67 @@ void traverse_pt(const ClipperLib::PolyNodes &nodes, ExOrJustPolygons *retval)
 }
 
 
+// Sequence of offsets and boolean operations executed by a single Clipper engine, for chains of operations
+// like the shrink / grow of the perimeter generator. The intermediate results are kept as ClipperLib::Paths,
+// they are not converted to ExPolygons and back between the operations, and the Clipper objects are reused by all the operations.
+// The results match the chains of the free functions: an offset of the input ExPolygons or of the result of a boolean operation
+// offsets the ExPolygons one by one like offset_ex() / offset_ex(diff_ex()), the boolean operations remove small areas
+// like diff_ex() / intersection_ex(), and the last offset of the sequence is executed directly into the ExPolygons like offset2_ex():
+//
+//     ExPolygons next = ClipperBatch(last).offset(- d1).offset(d2).intersection(ClipperBatch(last).offset(- d3)).expolygons();
+//
+// The input is referenced, not copied, it has to outlive the batch.
+class ClipperBatch
+{
+public:
+    explicit ClipperBatch(const Slic3r::ExPolygons &expolygons) : m_input_expolygons(&expolygons) {}
+    explicit ClipperBatch(const Slic3r::Polygons &polygons) : m_input_polygons(&polygons) {}
+    ClipperBatch(const ClipperBatch &) = delete;
+    ClipperBatch& operator=(const ClipperBatch &) = delete;
+
+    ClipperBatch& offset(const double delta, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+
+    ClipperBatch& diff(const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& diff(const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& diff(ClipperBatch &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& intersection(const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& intersection(const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& intersection(ClipperBatch &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+    ClipperBatch& union_();
+    ClipperBatch& union_(const Slic3r::Polygons &other);
+    ClipperBatch& union_(const Slic3r::ExPolygons &other);
+    ClipperBatch& union_(ClipperBatch &other);
+
+    // Result of the sequence, the batch is empty afterwards.
+    Slic3r::Polygons   polygons();
+    Slic3r::ExPolygons expolygons();
+
+private:
+    template<typename Fn>
+    ClipperLib::Paths   visit(Fn &&fn);
+    template<typename ClipProvider>
+    ClipperBatch&       boolean(ClipperLib::ClipType clipType, ClipProvider &&clip, ApplySafetyOffset do_safety_offset);
+    // Execute the pending offset.
+    void                flush();
+    // Convert the result of the last boolean operation to ExPolygons for the pending offset.
+    Slic3r::ExPolygons  boolean_expolygons();
+    // Execute the pending offset, convert the input to paths if no operation was executed yet.
+    ClipperLib::Paths&  paths();
+
+    ClipperUtils::Engine        m_engine;
+    const Slic3r::ExPolygons   *m_input_expolygons { nullptr };
+    const Slic3r::Polygons     *m_input_polygons   { nullptr };
+    // Result of the operations executed so far.
+    ClipperLib::Paths           m_paths;
+    // m_paths is the result of a boolean operation, to be offsetted as ExPolygons.
+    bool                        m_paths_boolean    { false };
+    // The last offset is postponed, so that expolygons() could offset directly into a PolyTree.
+    bool                        m_offset_pending   { false };
+    double                      m_offset_delta     { 0. };
+    ClipperLib::JoinType        m_offset_join_type { DefaultJoinType };
+    double                      m_offset_miter_limit { DefaultMiterLimit };
+};
+
 /* OTHER */
 Slic3r::Polygons simplify_polygons(const Slic3r::Polygons &subject, bool preserve_collinear = false);
 Slic3r::ExPolygons simplify_polygons_ex(const Slic3r::Polygons &subject, bool preserve_collinear = false);
@@ -14,11 +14,10 @@
 #include <cstdlib>
 #include <cmath>
 #include <algorithm>
+#include <bitset>
 #include <numeric>
 
-// Boost pool: Don't use mutexes to synchronize memory allocation.
-#define BOOST_POOL_NO_MT
-#include <boost/pool/object_pool.hpp>
+#include <tbb/parallel_for.h>
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/point.hpp>
@@ -237,12 +236,25 @@ static constexpr std::array<std::array<int, 8>, 3> child_traversal_order {
 
 struct Cube
 {
-    Vec3d center;
+    Vec3d    center;
 #ifndef NDEBUG
-    Vec3d center_octree;
+    Vec3d    center_octree;
 #endif // NDEBUG
-    std::array<Cube*, 8> children {}; // initialized to nullptrs
+    // Index of the first child cube into Octree::cubes of the depth below this cube.
+    // The children of a cube are stored next to each other, ordered by child_centers.
+    uint32_t first_child { 0 };
+    // Bit mask of the children present, indexed by child_centers.
+    uint8_t  child_mask  { 0 };
     Cube(const Vec3d &center) : center(center) {}
+
+    bool     has_children()          const { return this->child_mask != 0; }
+    bool     has_child(int child_idx) const { return (this->child_mask >> child_idx) & 1; }
+    // Index of a present child into Octree::cubes of the depth below this cube.
+    uint32_t child(int child_idx) const {
+        assert(this->has_child(child_idx));
+        // Skip the children present in front of child_idx.
+        return this->first_child + uint32_t(std::bitset<8>(this->child_mask & ((1u << child_idx) - 1u)).count());
+    }
 };
 
 struct CubeProperties
@@ -254,19 +266,22 @@ struct CubeProperties
     double line_xy_distance;// Defines maximal distance from a center of a cube on X and Y axis on which lines will be created
 };
 
+// Linear octree: The cubes of the same depth are stored in a single contiguous array, in the Morton order
+// (the children of a cube are stored next to each other, in the order of their parents).
+// The cubes are referenced by indices instead of pointers, which makes the octree compact and cache friendly
+// and allows building it one depth at a time in parallel.
 struct Octree
 {
-    // Octree will allocate its Cubes from the pool. The pool only supports deletion of the complete pool,
-    // perfect for building up our octree.
-    boost::object_pool<Cube>    pool;
-    Cube*                       root_cube { nullptr };
-    Vec3d                       origin;
-    std::vector<CubeProperties> cubes_properties;
+    // Cubes indexed by their depth, the same way as cubes_properties. The root cube is the only cube at the maximum depth,
+    // the smallest cubes are at depth zero.
+    std::vector<std::vector<Cube>> cubes;
+    Vec3d                          origin;
+    std::vector<CubeProperties>    cubes_properties;
 
     Octree(const Vec3d &origin, const std::vector<CubeProperties> &cubes_properties)
-        : root_cube(pool.construct(origin)), origin(origin), cubes_properties(cubes_properties) {}
+        : cubes(cubes_properties.size()), origin(origin), cubes_properties(cubes_properties) { cubes.back().emplace_back(origin); }
 
-    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth);
+    const Cube& root_cube() const { return cubes.back().front(); }
 };
 
 void OctreeDeleter::operator()(Octree *p) {
@@ -368,6 +383,7 @@ struct FillContext
     };
 
     FillContext(const Octree &octree, double z_position, int direction_idx) :
+        cubes(octree.cubes),
         cubes_properties(octree.cubes_properties),
         z_position(z_position),
         traversal_order(child_traversal_order[direction_idx]),
@@ -381,6 +397,7 @@ struct FillContext
     // Rotate the point, uses the same convention as Point::rotate().
     Vec2d rotate(const Vec2d& v) { return Vec2d(this->cos_a * v.x() - this->sin_a * v.y(), this->sin_a * v.x() + this->cos_a * v.y()); }
 
+    const std::vector<std::vector<Cube>> &cubes;
     const std::vector<CubeProperties>  &cubes_properties;
     // Top of the current layer.
     const double                        z_position;
@@ -424,7 +441,7 @@ static bool verify_traversal_order(
     for (int i = 0; i < 8; ++i) {
         int j = context.traversal_order[i];
         Vec3d cntr = to_world * (cube->center_octree + (child_centers[j] * (context.cubes_properties[depth].edge_length / 4.)));
-        assert(!cube->children[j] || cube->children[j]->center.isApprox(cntr));
+        assert(! cube->has_child(j) || context.cubes[depth - 1][cube->child(j)].center.isApprox(cntr));
         c[i] = cntr;
     }
     std::array<Vec3d, 10> dirs = {
@@ -490,14 +507,17 @@ static void generate_infill_lines_recursive(
         last_line.b = new_line.b;
     }
 
+    if (! cube->has_children())
+        return;
+
     // left child index
     address = address * 2 + 1;
     -- depth;
+    const std::vector<Cube> &children = context.cubes[depth];
     size_t i = 0;
     for (const int child_idx : context.traversal_order) {
-        const Cube *child = cube->children[child_idx];
-        if (child != nullptr)
-            generate_infill_lines_recursive(context, child, address, depth);
+        if (cube->has_child(child_idx))
+            generate_infill_lines_recursive(context, &children[cube->child(child_idx)], address, depth);
         if (++ i == 4)
             // right child index
             ++ address;
@@ -1338,7 +1358,7 @@ void Filler::_fill_surface_single(
         // Generate the infill lines along the octree cells, merge touching lines of the same direction.
         size_t num_lines = 0;
         for (auto &context : contexts) {
-            generate_infill_lines_recursive(context, adapt_fill_octree->root_cube, 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
+            generate_infill_lines_recursive(context, &adapt_fill_octree->root_cube(), 0, int(adapt_fill_octree->cubes_properties.size()) - 1);
             num_lines += context.output_lines.size() + context.temp_lines.size();
         }
 
@@ -1452,15 +1472,22 @@ static inline bool is_overhang_triangle(const Vec3d &a, const Vec3d &b, const Ve
     return n.dot(up) > 0.707 * n.norm();
 }
 
-static void transform_center(Cube *current_cube, const Eigen::Matrix3d &rot)
+// Slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
+// We will rather densify the octree a bit more than necessary instead of missing a triangle.
+static inline BoundingBoxf3 child_bbox(const Vec3d &parent_center, const BoundingBoxf3 &parent_bbox, int child_idx)
 {
-#ifndef NDEBUG
-    current_cube->center_octree = current_cube->center;
-#endif // NDEBUG
-    current_cube->center = rot * current_cube->center;
-    for (auto *child : current_cube->children)
-        if (child)
-            transform_center(child, rot);
+    const Vec3d &child_center_dir = child_centers[child_idx];
+    BoundingBoxf3 bbox;
+    for (int k = 0; k < 3; ++ k) {
+        if (child_center_dir[k] == -1.) {
+            bbox.min[k] = parent_bbox.min[k];
+            bbox.max[k] = parent_center[k] + EPSILON;
+        } else {
+            bbox.min[k] = parent_center[k] - EPSILON;
+            bbox.max[k] = parent_bbox.max[k];
+        }
+    }
+    return bbox;
 }
 
 OctreePtr build_octree(
@@ -1481,31 +1508,103 @@ OctreePtr build_octree(
     auto                        octree           = OctreePtr(new Octree(cube_center, cubes_properties));
 
     if (cubes_properties.size() > 1) {
-        Octree *octree_ptr = octree.get();
+        // Triangles to be inserted into the octree, indexed first by triangle_mesh.indices, then by overhang_triangles.
+        auto triangle = [&triangle_mesh, &overhang_triangles](uint32_t idx) -> std::array<Vec3d, 3> {
+            if (idx < triangle_mesh.indices.size()) {
+                const stl_triangle_vertex_indices &tri = triangle_mesh.indices[idx];
+                return { triangle_mesh.vertices[tri[0]].cast<double>(), triangle_mesh.vertices[tri[1]].cast<double>(), triangle_mesh.vertices[tri[2]].cast<double>() };
+            }
+            idx = 3 * (idx - uint32_t(triangle_mesh.indices.size()));
+            return { overhang_triangles[idx], overhang_triangles[idx + 1], overhang_triangles[idx + 2] };
+        };
+        std::vector<uint32_t> triangles;
+        {
+            auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
+            triangles.reserve(triangle_mesh.indices.size() + overhang_triangles.size() / 3);
+            for (uint32_t idx = 0; idx < uint32_t(triangle_mesh.indices.size()); ++ idx)
+                if (std::array<Vec3d, 3> tri = triangle(idx); ! support_overhangs_only || is_overhang_triangle(tri[0], tri[1], tri[2], up_vector))
+                    triangles.emplace_back(idx);
+            for (size_t i = 0; i < overhang_triangles.size(); i += 3)
+                triangles.emplace_back(uint32_t(triangle_mesh.indices.size() + i / 3));
+        }
+
+        // The octree is built top down, one depth at a time. The triangles are bucketed by the cubes of the current depth,
+        // a child cube is created if any of the triangles of its parent intersects the child cube.
         double edge_length_half = 0.5 * cubes_properties.back().edge_length;
         Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
-        int    max_depth = int(cubes_properties.size()) - 1;
-        auto process_triangle = [octree_ptr, max_depth, diag_half](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
-            octree_ptr->insert_triangle(
-                a, b, c,
-                octree_ptr->root_cube,
-                BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
-                max_depth);
-        };
-        auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
-        for (auto &tri : triangle_mesh.indices) {
-            auto a = triangle_mesh.vertices[tri[0]].cast<double>();
-            auto b = triangle_mesh.vertices[tri[1]].cast<double>();
-            auto c = triangle_mesh.vertices[tri[2]].cast<double>();
-            if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
-                process_triangle(a, b, c);
+        std::vector<std::vector<uint32_t>> cube_triangles { std::move(triangles) };
+        std::vector<BoundingBoxf3>         cube_bboxes { BoundingBoxf3(octree->root_cube().center - diag_half, octree->root_cube().center + diag_half) };
+        for (int depth = int(cubes_properties.size()) - 1; depth > 0; -- depth) {
+            std::vector<Cube> &parents = octree->cubes[depth];
+            // The triangles are only bucketed for the children, which will be split further.
+            const bool has_grandchildren = depth > 1;
+            // Triangles intersecting the children of each parent cube.
+            std::vector<std::array<std::vector<uint32_t>, 8>> child_triangles(has_grandchildren ? parents.size() : 0);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, parents.size()), [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t parent_idx = range.begin(); parent_idx < range.end(); ++ parent_idx) {
+                    Cube &parent = parents[parent_idx];
+                    std::array<BoundingBoxf3, 8> bboxes;
+                    for (int i = 0; i < 8; ++ i)
+                        bboxes[i] = child_bbox(parent.center, cube_bboxes[parent_idx], i);
+                    for (uint32_t idx : cube_triangles[parent_idx]) {
+                        std::array<Vec3d, 3> tri = triangle(idx);
+                        for (int i = 0; i < 8; ++ i)
+                            // The smallest cubes only need to know whether they are intersected by any triangle.
+                            if ((has_grandchildren || ! parent.has_child(i)) && triangle_AABB_intersects(tri[0], tri[1], tri[2], bboxes[i])) {
+                                if (has_grandchildren)
+                                    child_triangles[parent_idx][i].emplace_back(idx);
+                                parent.child_mask |= uint8_t(1 << i);
+                            }
+                        if (! has_grandchildren && parent.child_mask == 0xff)
+                            break;
+                    }
+                    // Release memory early.
+                    cube_triangles[parent_idx] = std::vector<uint32_t>();
+                }
+            });
+            uint32_t num_children = 0;
+            for (Cube &parent : parents) {
+                parent.first_child = num_children;
+                num_children += uint32_t(std::bitset<8>(parent.child_mask).count());
+            }
+            std::vector<Cube> &children = octree->cubes[depth - 1];
+            children.assign(num_children, Cube(Vec3d::Zero()));
+            std::vector<std::vector<uint32_t>> children_triangles(has_grandchildren ? num_children : 0);
+            std::vector<BoundingBoxf3>         children_bboxes(has_grandchildren ? num_children : 0);
+            const double child_offset = cubes_properties[depth - 1].edge_length / 2.;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, parents.size()), [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t parent_idx = range.begin(); parent_idx < range.end(); ++ parent_idx) {
+                    const Cube &parent = parents[parent_idx];
+                    for (int i = 0; i < 8; ++ i)
+                        if (parent.has_child(i)) {
+                            uint32_t child_idx = parent.child(i);
+                            children[child_idx].center = parent.center + (child_centers[i] * child_offset);
+                            if (has_grandchildren) {
+                                children_triangles[child_idx] = std::move(child_triangles[parent_idx][i]);
+                                children_bboxes[child_idx]    = child_bbox(parent.center, cube_bboxes[parent_idx], i);
+                            }
+                        }
+                }
+            });
+            // Release the buckets of this depth before bucketing the triangles of the depth below.
+            child_triangles = std::vector<std::array<std::vector<uint32_t>, 8>>();
+            cube_triangles  = std::move(children_triangles);
+            cube_bboxes     = std::move(children_bboxes);
         }
-        for (size_t i = 0; i < overhang_triangles.size(); i += 3)
-            process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+
         {
             // Transform the octree to world coordinates to reduce computation when extracting infill lines.
             auto rot = transform_to_world().toRotationMatrix();
-            transform_center(octree->root_cube, rot);
+            for (std::vector<Cube> &cubes : octree->cubes)
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, cubes.size()), [&cubes, &rot](const tbb::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i) {
+                        Cube &cube = cubes[i];
+#ifndef NDEBUG
+                        cube.center_octree = cube.center;
+#endif // NDEBUG
+                        cube.center = rot * cube.center;
+                    }
+                });
             octree->origin = rot * octree->origin;
         }
     }
@@ -1513,40 +1612,13 @@ OctreePtr build_octree(
     return octree;
 }
 
-void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth)
+std::vector<size_t> octree_cubes_per_depth(const Octree &octree)
 {
-    assert(current_cube);
-    assert(depth > 0);
-
-    --depth;
-
-    // Squared radius of a sphere around the child cube.
-    // const double r2_cube = Slic3r::sqr(0.5 * this->cubes_properties[depth].height + EPSILON);
-
-    for (size_t i = 0; i < 8; ++ i) {
-        const Vec3d &child_center_dir = child_centers[i];
-        // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
-        // We will rather densify the octree a bit more than necessary instead of missing a triangle.
-        BoundingBoxf3 bbox;
-        for (int k = 0; k < 3; ++ k) {
-            if (child_center_dir[k] == -1.) {
-                bbox.min[k] = current_bbox.min[k];
-                bbox.max[k] = current_cube->center[k] + EPSILON;
-            } else {
-                bbox.min[k] = current_cube->center[k] - EPSILON;
-                bbox.max[k] = current_bbox.max[k];
-            }
-        }
-        Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
-        //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
-        // dist2_to_triangle and r2_cube are commented out too.
-        if (triangle_AABB_intersects(a, b, c, bbox)) {
-            if (! current_cube->children[i])
-                current_cube->children[i] = this->pool.construct(child_center);
-            if (depth > 0)
-                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth);
-        }
-    }
+    std::vector<size_t> out;
+    out.reserve(octree.cubes.size());
+    for (const std::vector<Cube> &cubes : octree.cubes)
+        out.emplace_back(cubes.size());
+    return out;
 }
 
 } // namespace FillAdaptive
@@ -48,6 +48,9 @@ FillAdaptive::OctreePtr         build_octree(
     // If true, octree is densified below internal overhangs only.
     bool                         support_overhangs_only);
 
+// Number of cubes of the octree at each depth, starting with the smallest cubes.
+std::vector<size_t>             octree_cubes_per_depth(const Octree &octree);
+
 //
 // Some of the algorithms used by class FillAdaptive were inspired by
 // Cura Engine's class SubDivCube
@@ -259,13 +259,11 @@ Fill::do_gap_fill(const ExPolygons& gapfill_areas, const FillParams& params, Ext
     ExPolygons gapfill_areas_collapsed = offset2_ex(gapfill_areas, double(-min / 2), double(+min / 2));
     double minarea = double(params.flow.scaled_width()) * double(params.flow.scaled_width());
     if (params.config != nullptr) minarea = scale_d(params.config->gap_fill_min_area.get_abs_value(params.flow.width())) * double(params.flow.scaled_width());
-    for (const ExPolygon& ex : gapfill_areas_collapsed) {
-        //remove too small gaps that are too hard to fill.
-        //ie one that are smaller than an extrusion with width of min and a length of max.
-        if (ex.area() > minarea) {
-            Geometry::MedialAxis{ ex, params.flow.scaled_width() * 2, params.flow.scaled_width() / 5, coord_t(params.flow.height()) }.build(polylines_gapfill);
-        }
-    }
+    //remove too small gaps that are too hard to fill.
+    //ie one that are smaller than an extrusion with width of min and a length of max.
+    gapfill_areas_collapsed.erase(std::remove_if(gapfill_areas_collapsed.begin(), gapfill_areas_collapsed.end(),
+        [minarea](const ExPolygon& ex) { return ex.area() <= minarea; }), gapfill_areas_collapsed.end());
+    Geometry::MedialAxis::build_all(gapfill_areas_collapsed, params.flow.scaled_width() * 2, params.flow.scaled_width() / 5, coord_t(params.flow.height()), polylines_gapfill);
     if (!polylines_gapfill.empty() && !is_bridge(params.role)) {
         //test
 #ifdef _DEBUG
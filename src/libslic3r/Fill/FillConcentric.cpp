@@ -148,13 +148,11 @@ FillConcentricWGapFill::fill_surface_extrusion(
                 offset2_ex(gaps, -max / 2, +max / 2),
                 ApplySafetyOffset::Yes);
             ThickPolylines polylines;
-            for (const ExPolygon &ex : gaps_ex) {
-                //remove too small gaps that are too hard to fill.
-                //ie one that are smaller than an extrusion with width of min and a length of max.
-                if (ex.area() > min_gapfill_area) {
-                    Geometry::MedialAxis{ ex, coord_t(max), coord_t(min), scale_t(params.flow.height()) }.build(polylines);
-                }
-            }
+            //remove too small gaps that are too hard to fill.
+            //ie one that are smaller than an extrusion with width of min and a length of max.
+            gaps_ex.erase(std::remove_if(gaps_ex.begin(), gaps_ex.end(),
+                [min_gapfill_area](const ExPolygon &ex) { return ex.area() <= min_gapfill_area; }), gaps_ex.end());
+            Geometry::MedialAxis::build_all(gaps_ex, coord_t(max), coord_t(min), scale_t(params.flow.height()), polylines);
             if (!polylines.empty() && !is_bridge(good_role)) {
                 ExtrusionEntitiesPtr gap_fill_entities = Geometry::thin_variable_width(polylines, erGapFill, params.flow, scale_t(params.config->get_computed_value("resolution_internal")));
                 if (!gap_fill_entities.empty()) {
@@ -13,6 +13,7 @@
 #include <boost/random/uniform_int_distribution.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 
+#include "../Arena.hpp"
 #include "../ExtrusionEntityCollection.hpp"
 #include "../ClipperUtils.hpp"
 #include "../ExPolygon.hpp"
@@ -366,7 +367,8 @@ struct SegmentedIntersectionLine
     // x position of this vertical intersection line.
     coord_t                             pos;
     // List of intersection points with polygons, sorted increasingly by the y axis.
-    std::vector<SegmentIntersection>    intersections;
+    // Allocated from the per layer arena when filling a layer, there are many short lived short vectors.
+    ArenaVector<SegmentIntersection>    intersections;
 };
 
 static SegmentIntersection phony_outer_intersection(SegmentIntersection::SegmentIntersectionType type, coord_t pos)
@@ -413,7 +415,7 @@ public:
         // for the infill pattern, don't cut the corners.
         // default miterLimt = 3
         //double miterLimit = 10.;
-        assert(aoffset1 < 0);
+        assert(aoffset1 <= 0);
         assert(aoffset2 <= 0);
         assert(aoffset2 == 0 || aoffset2 < aoffset1);
 //        bool sticks_removed = 
@@ -1316,7 +1318,7 @@ static void pinch_contours_insert_phony_outer_intersections(std::vector<Segmente
     std::vector<size_t>                 insert_after;
     // Mapping of indices of current intersection line after inserting new outer points.
     std::vector<int32_t>                map;
-    std::vector<SegmentIntersection>    temp_intersections;
+    ArenaVector<SegmentIntersection>    temp_intersections;
 
     for (size_t i_vline = 1; i_vline < segs.size(); ++ i_vline) {
         SegmentedIntersectionLine &il = segs[i_vline];
@@ -15,10 +15,10 @@ DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outl
     m_supporting_radius(radius)
 {
     m_supporting_radius2 = double(radius) * double(radius);
-    // Sample source polygons with a regular grid sampling pattern.
-    for (const ExPolygon &expoly : union_ex(current_outline)) {
+    // Sample the overhang to be supported with a regular grid sampling pattern.
+    for (const ExPolygon &expoly : union_ex(current_overhang)) {
         for (const Point &p : sample_grid_pattern(expoly, m_cell_size)) {
-            // Find a squared distance to the source expolygon boundary.
+            // Find a squared distance to the boundary of the overhang.
             double d2 = std::numeric_limits<double>::max();
             for (size_t icontour = 0; icontour <= expoly.holes.size(); ++ icontour) {
                 const Polygon &contour = icontour == 0 ? expoly.contour : expoly.holes[icontour - 1];
@@ -39,9 +39,11 @@ DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outl
                a.dist_to_boundary < b.dist_to_boundary :
                (PointHash{}(a.loc) % prime_for_hash) < (PointHash{}(b.loc) % prime_for_hash);
         });
+    for (const UnsupportedCell &cell : m_unsupported_points)
+        m_unsupported_points_bbox.merge(cell.loc);
     for (auto it = m_unsupported_points.begin(); it != m_unsupported_points.end(); ++it) {
         UnsupportedCell& cell = *it;
-        m_unsupported_points_grid.emplace(Point{ cell.loc.x() / m_cell_size, cell.loc.y() / m_cell_size }, it);
+        m_unsupported_points_grid.emplace(this->to_grid_point(cell.loc), it);
     }
 }
 
@@ -49,7 +51,8 @@ void DistanceField::update(const Point& to_node, const Point& added_leaf)
 {
     Vec2d       v  = (added_leaf - to_node).cast<double>();
     auto        l2 = v.squaredNorm();
-    Vec2d       extent = Vec2d(-v.y(), v.x()) * m_supporting_radius / sqrt(l2);
+    // A leaf added at its node has no direction, only the circle at the leaf is supported.
+    Vec2d       extent = l2 > 0. ? Vec2d(Vec2d(-v.y(), v.x()) * m_supporting_radius / sqrt(l2)) : Vec2d::Zero();
 
     BoundingBox grid;
     {
@@ -60,15 +63,13 @@ void DistanceField::update(const Point& to_node, const Point& added_leaf)
         grid.merge(to_node + iextent);
         grid.merge(added_leaf - iextent);
         grid.merge(added_leaf + iextent);
-        grid.min /= m_cell_size;
-        grid.max /= m_cell_size;
+        grid.min = this->to_grid_point(grid.min);
+        grid.max = this->to_grid_point(grid.max);
     }
 
-    Point grid_loc;
     for (coord_t row = grid.min.y(); row <= grid.max.y(); ++ row) {
-        grid_loc.y() = row * m_cell_size;
-        for (coord_t col = grid.min.x(); col <= grid.max.y(); ++ col) {
-            grid_loc.x() = col * m_cell_size;
+        for (coord_t col = grid.min.x(); col <= grid.max.x(); ++ col) {
+            Point grid_loc = this->from_grid_point(Point(col, row));
             // Test inside a circle at the new leaf.
             if ((grid_loc - added_leaf).cast<double>().squaredNorm() > m_supporting_radius2) {
                 // Not inside a circle at the end of the new leaf.
@@ -84,7 +85,7 @@ void DistanceField::update(const Point& to_node, const Point& added_leaf)
             }
             // Inside a circle at the end of the new leaf, or inside a rotated rectangle.
             // Remove unsupported leafs at this grid location.
-            if (auto it = m_unsupported_points_grid.find(grid_loc); it != m_unsupported_points_grid.end()) {
+            if (auto it = m_unsupported_points_grid.find(Point(col, row)); it != m_unsupported_points_grid.end()) {
                 std::list<UnsupportedCell>::iterator& list_it = it->second;
                 UnsupportedCell& cell = *list_it;
                 if ((cell.loc - added_leaf).cast<double>().squaredNorm() <= m_supporting_radius2) {
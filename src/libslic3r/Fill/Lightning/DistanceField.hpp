@@ -4,6 +4,7 @@
 #ifndef LIGHTNING_DISTANCE_FIELD_H
 #define LIGHTNING_DISTANCE_FIELD_H
 
+#include "../../BoundingBox.hpp"
 #include "../../Point.hpp"
 #include "../../Polygon.hpp"
 
@@ -93,6 +94,26 @@ protected:
      * up the cell belonging to a certain position in the grid.
      */
     std::unordered_map<Point, std::list<UnsupportedCell>::iterator, PointHash> m_unsupported_points_grid;
+
+    /*!
+     * The origin of the grid, so that the grid coordinates of the unsupported
+     * points are not negative and each point is assigned a cell of its own.
+     */
+    BoundingBox m_unsupported_points_bbox;
+
+    /*!
+     * Grid coordinates of a point.
+     */
+    Point to_grid_point(const Point &point) const {
+        return (point - m_unsupported_points_bbox.min) / m_cell_size;
+    }
+
+    /*!
+     * Position of a grid point.
+     */
+    Point from_grid_point(const Point &point) const {
+        return Point(point.x() * m_cell_size, point.y() * m_cell_size) + m_unsupported_points_bbox.min;
+    }
 };
 
 } // namespace Slic3r::FillLightning
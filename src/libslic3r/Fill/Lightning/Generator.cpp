@@ -2,6 +2,7 @@
 //CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include "Generator.hpp"
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 
 #include "../../ClipperUtils.hpp"
@@ -9,6 +10,10 @@
 #include "../../Print.hpp"
 #include "../../Surface.hpp"
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
 /* Possible future tasks/optimizations,etc.:
  * - Improve connecting heuristic to favor connecting to shorter trees
  * - Change which node of a tree is the root when that would be better in reconnectRoots.
@@ -38,14 +43,14 @@ Generator::Generator(const PrintObject &print_object)
     const double               layer_thickness      = object_config.layer_height;
 
     m_infill_extrusion_width = scaled<float>(region_config.infill_extrusion_width.percent ? default_infill_extrusion_width * 0.01 * region_config.infill_extrusion_width : region_config.infill_extrusion_width);
-    m_supporting_radius = scaled<coord_t>(m_infill_extrusion_width * 0.001 / region_config.fill_density);
+    m_supporting_radius = coord_t(m_infill_extrusion_width * 100. / region_config.fill_density);
 
     const double lightning_infill_overhang_angle = M_PI / 4; // 45 degrees
     const double lightning_infill_prune_angle = M_PI / 4; // 45 degrees
     const double lightning_infill_straightening_angle = M_PI / 4; // 45 degrees
-    m_wall_supporting_radius = layer_thickness * std::tan(lightning_infill_overhang_angle);
-    m_prune_length = layer_thickness * std::tan(lightning_infill_prune_angle);
-    m_straightening_max_distance = layer_thickness * std::tan(lightning_infill_straightening_angle);
+    m_wall_supporting_radius = scaled<coord_t>(layer_thickness * std::tan(lightning_infill_overhang_angle));
+    m_prune_length = scaled<coord_t>(layer_thickness * std::tan(lightning_infill_prune_angle));
+    m_straightening_max_distance = scaled<coord_t>(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
     generateInitialInternalOverhangs(print_object);
     generateTrees(print_object);
@@ -56,21 +61,26 @@ void Generator::generateInitialInternalOverhangs(const PrintObject &print_object
     m_overhang_per_layer.resize(print_object.layers().size());
     const float infill_wall_offset = - m_infill_extrusion_width;
 
-    Polygons infill_area_above;
-    //Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = print_object.layers().size() - 1; layer_nr >= 0; layer_nr--) {
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces.surfaces)
-                if (surface.surface_type == (stPosInternal | stDensSparse))
-                    append(infill_area_here, offset(surface.expolygon, infill_wall_offset));
-
-        //Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -m_wall_supporting_radius), infill_area_above);
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+    std::vector<Polygons> infill_area_per_layer(print_object.layers().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()),
+        [&print_object, &infill_area_per_layer, infill_wall_offset](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr)
+                for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
+                    for (const Surface& surface : layerm->fill_surfaces.surfaces)
+                        if (surface.surface_type == (stPosInternal | stDensSparse))
+                            append(infill_area_per_layer[layer_nr], offset(surface.expolygon, infill_wall_offset));
+        });
+
+    //Subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()),
+        [this, &infill_area_per_layer](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr) {
+                static const Polygons empty;
+                const Polygons &infill_area_above = layer_nr + 1 < infill_area_per_layer.size() ? infill_area_per_layer[layer_nr + 1] : empty;
+                //Remove the part of the infill area that is already supported by the walls.
+                m_overhang_per_layer[layer_nr] = diff(offset(infill_area_per_layer[layer_nr], -m_wall_supporting_radius), infill_area_above);
+            }
+        });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -86,41 +96,86 @@ void Generator::generateTrees(const PrintObject &print_object)
 
     std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
 
-    // For-each layer from top to bottom:
-    for (int layer_id = print_object.layers().size() - 1; layer_id >= 0; layer_id--)
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces.surfaces)
-                if (surface.surface_type == (stPosInternal | stDensSparse))
-                    append(infill_outlines[layer_id], offset(surface.expolygon, infill_wall_offset));
-
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
-    EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
-    outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()),
+        [&print_object, &infill_outlines, infill_wall_offset](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id)
+                for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
+                    for (const Surface &surface : layerm->fill_surfaces.surfaces)
+                        if (surface.surface_type == (stPosInternal | stDensSparse))
+                            append(infill_outlines[layer_id], offset(surface.expolygon, infill_wall_offset));
+        });
+
+    // Only the propagation of the trees from a layer to the layer below is inherently sequential.
+    // The distance fields and the outline locators of a layer do not depend on the trees, they are calculated in parallel
+    // for a band of layers, while the trees are being propagated through the band of layers above.
+    // Only the data of the two bands is kept in memory.
+    struct LayerData {
+        std::unique_ptr<DistanceField>  distance_field;
+        // For various operations its beneficial to quickly locate nearby features on the polygon:
+        std::unique_ptr<EdgeGrid::Grid> outlines_locator;
+    };
+    std::vector<LayerData> layer_data(print_object.layers().size());
+    auto prepare_layers = [this, &infill_outlines, &layer_data](size_t layer_begin, size_t layer_end) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(layer_begin, layer_end, 1),
+            [this, &infill_outlines, &layer_data](const tbb::blocked_range<size_t> &range) {
+                for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+                    const Polygons &outlines = infill_outlines[layer_id];
+                    LayerData      &data     = layer_data[layer_id];
+                    data.distance_field   = std::make_unique<DistanceField>(m_supporting_radius, outlines, m_overhang_per_layer[layer_id]);
+                    data.outlines_locator = std::make_unique<EdgeGrid::Grid>(get_extents(outlines).inflated(SCALED_EPSILON));
+                    data.outlines_locator->create(outlines, locator_cell_size);
+                }
+            });
+    };
+    const size_t band_size = std::max<size_t>(2, tbb::this_task_arena::max_concurrency());
+    // Layers starting with prepared_begin are ready, layers starting with preparing_begin are being prepared by band_task.
+    size_t          prepared_begin  = print_object.layers().size();
+    size_t          preparing_begin = prepared_begin;
+    tbb::task_group band_task;
+    auto wait_for_layer = [&](size_t layer_id) {
+        while (layer_id < prepared_begin) {
+            if (preparing_begin == prepared_begin) {
+                // Nothing is being prepared, prepare the next band synchronously.
+                preparing_begin = prepared_begin - std::min(prepared_begin, band_size);
+                prepare_layers(preparing_begin, prepared_begin);
+            } else
+                band_task.wait();
+            prepared_begin = preparing_begin;
+            if (prepared_begin > 0) {
+                // Start preparing the next band of layers below while propagating the trees through this band.
+                preparing_begin = prepared_begin - std::min(prepared_begin, band_size);
+                band_task.run([&prepare_layers, begin = preparing_begin, end = prepared_begin]() { prepare_layers(begin, end); });
+            }
+        }
+    };
 
     // For-each layer from top to bottom:
-    for (int layer_id = top_layer_id; layer_id >= 0; layer_id--)
+    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--)
     {
         Layer& current_lightning_layer = m_lightning_layers[layer_id];
-        Polygons& current_outlines = infill_outlines[layer_id];
+        wait_for_layer(layer_id);
+        const EdgeGrid::Grid &outlines_locator = *layer_data[layer_id].outlines_locator;
 
         // register all trees propagated from the previous layer as to-be-reconnected
         std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        current_lightning_layer.generateNewTrees(*layer_data[layer_id].distance_field, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
 
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
-            return;
+            break;
 
         const Polygons& below_outlines = infill_outlines[layer_id - 1];
-        outlines_locator.set_bbox(get_extents(below_outlines).inflated(SCALED_EPSILON));
-        outlines_locator.create(below_outlines, locator_cell_size);
+        wait_for_layer(layer_id - 1);
+        const EdgeGrid::Grid &below_outlines_locator = *layer_data[layer_id - 1].outlines_locator;
 
         std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
         for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+            tree->propagateToNextLayer(lower_trees, below_outlines, below_outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+
+        // Release the data of this layer early.
+        layer_data[layer_id] = LayerData();
     }
 }
 
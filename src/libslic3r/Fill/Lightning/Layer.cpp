@@ -3,6 +3,7 @@
 
 #include "Layer.hpp" //The class we're implementing.
 
+#include <algorithm>
 #include <iterator> // advance
 
 #include "DistanceField.hpp"
@@ -34,15 +35,12 @@ void Layer::fillLocator(SparseNodeGrid &tree_node_locator)
 
 void Layer::generateNewTrees
 (
-    const Polygons& current_overhang,
-    const Polygons& current_outlines,
+    DistanceField& distance_field,
     const EdgeGrid::Grid& outlines_locator,
     const coord_t supporting_radius,
     const coord_t wall_supporting_radius
 )
 {
-    DistanceField distance_field(supporting_radius, current_outlines, current_overhang);
-
     SparseNodeGrid tree_node_locator;
     fillLocator(tree_node_locator);
 
@@ -51,7 +49,7 @@ void Layer::generateNewTrees
     Point unsupported_location;
     while (distance_field.tryGetNextPoint(&unsupported_location)) {
         GroundingLocation grounding_loc = getBestGroundingLocation(
-            unsupported_location, current_outlines, outlines_locator, supporting_radius, wall_supporting_radius, tree_node_locator);
+            unsupported_location, outlines_locator, supporting_radius, wall_supporting_radius, tree_node_locator);
 
         NodeSPtr new_parent;
         NodeSPtr new_child;
@@ -67,7 +65,7 @@ void Layer::generateNewTrees
 static bool polygonCollidesWithLineSegment(const Point from, const Point to, const EdgeGrid::Grid &loc_to_line)
 {
     struct Visitor {
-        explicit Visitor(const EdgeGrid::Grid &grid) : grid(grid) {}
+        explicit Visitor(const EdgeGrid::Grid &grid, const Line &line) : grid(grid), line(line) {}
 
         bool operator()(coord_t iy, coord_t ix) {
             // Called with a row and colum of the grid cell, which is intersected by a line.
@@ -87,16 +85,68 @@ static bool polygonCollidesWithLineSegment(const Point from, const Point to, con
         const EdgeGrid::Grid& grid;
         Line                  line;
         bool                  intersect = false;
-    } visitor(loc_to_line);
+    } visitor(loc_to_line, { from, to });
 
     loc_to_line.visit_cells_intersecting_line(from, to, visitor);
     return visitor.intersect;
 }
 
+// Closest point on the closed contours of outline_locator with more than two points to pt.
+// The cells of outline_locator are searched in rings of increasing distance around pt, until no closer segment could be found.
+// The segments are ordered as if they were searched linearly starting with the closing segment of each contour,
+// so that the same point is returned as by a linear search in case of ties.
+static Point closestPointOnOutlines(const Point &pt, const EdgeGrid::Grid &outline_locator)
+{
+    Point  result;
+    double d2min = std::numeric_limits<double>::max();
+    if (outline_locator.rows() == 0 || outline_locator.cols() == 0)
+        return result;
+
+    const auto &contours   = outline_locator.contours();
+    const coord_t resolution = outline_locator.resolution();
+    const coord_t rows     = coord_t(outline_locator.rows());
+    const coord_t cols     = coord_t(outline_locator.cols());
+    const Point   cell     = (pt - outline_locator.bbox().min) / resolution;
+    const coord_t row0     = std::clamp<coord_t>(cell.y(), 0, rows - 1);
+    const coord_t col0     = std::clamp<coord_t>(cell.x(), 0, cols - 1);
+    std::pair<size_t, size_t> key_min { std::numeric_limits<size_t>::max(), 0 };
+    auto visit_cell = [&](coord_t row, coord_t col) {
+        auto cell_data_range = outline_locator.cell_data_range(row, col);
+        for (auto it_contour_and_segment = cell_data_range.first; it_contour_and_segment != cell_data_range.second; ++ it_contour_and_segment) {
+            const EdgeGrid::Contour &contour = contours[it_contour_and_segment->first];
+            if (contour.num_segments() <= 2)
+                continue;
+            auto segment = outline_locator.segment(*it_contour_and_segment);
+            // Order of the segment in a linear search over the contours.
+            std::pair<size_t, size_t> key { it_contour_and_segment->first, (it_contour_and_segment->second + 1) % contour.num_segments() };
+            if (double d2 = Line::distance_to_squared(pt, segment.first, segment.second); d2 < d2min || (d2 == d2min && key < key_min)) {
+                d2min   = d2;
+                key_min = key;
+                result  = Geometry::foot_pt({ segment.first, segment.second }, pt).cast<coord_t>();
+            }
+        }
+    };
+    for (coord_t ring = 0; ring <= std::max(rows, cols); ++ ring) {
+        // All cells of the following rings are further than ring * resolution from pt.
+        for (coord_t row = std::max<coord_t>(row0 - ring, 0); row <= std::min(row0 + ring, rows - 1); ++ row)
+            if (row == row0 - ring || row == row0 + ring) {
+                for (coord_t col = std::max<coord_t>(col0 - ring, 0); col <= std::min(col0 + ring, cols - 1); ++ col)
+                    visit_cell(row, col);
+            } else {
+                if (col0 - ring >= 0)
+                    visit_cell(row, col0 - ring);
+                if (col0 + ring < cols)
+                    visit_cell(row, col0 + ring);
+            }
+        if (double d = double(ring) * double(resolution); d * d > d2min)
+            break;
+    }
+    return result;
+}
+
 GroundingLocation Layer::getBestGroundingLocation
 (
     const Point& unsupported_location,
-    const Polygons& current_outlines,
     const EdgeGrid::Grid& outline_locator,
     const coord_t supporting_radius,
     const coord_t wall_supporting_radius,
@@ -104,22 +154,8 @@ GroundingLocation Layer::getBestGroundingLocation
     const NodeSPtr& exclude_tree
 )
 {
-    // Closest point on current_outlines to unsupported_location:
-    Point node_location;
-    {
-        double d2 = std::numeric_limits<double>::max();
-        for (const Polygon &contour : current_outlines)
-            if (contour.size() > 2) {
-                Point prev = contour.points.back();
-                for (const Point &p2 : contour.points) {
-                    if (double d = Line::distance_to_squared(unsupported_location, prev, p2); d < d2) {
-                        d2 = d;
-                        node_location = Geometry::foot_pt({ prev, p2 }, unsupported_location).cast<coord_t>();
-                    }
-                    prev = p2;
-                }
-            }
-    }
+    // Closest point on the outlines to unsupported_location:
+    Point node_location = closestPointOnOutlines(unsupported_location, outline_locator);
 
     const auto within_dist = coord_t((node_location - unsupported_location).cast<double>().norm());
 
@@ -175,7 +211,6 @@ bool Layer::attach(
 void Layer::reconnectRoots
 (
     std::vector<NodeSPtr>& to_be_reconnected_tree_roots,
-    const Polygons& current_outlines,
     const EdgeGrid::Grid& outline_locator,
     const coord_t supporting_radius,
     const coord_t wall_supporting_radius
@@ -186,10 +221,19 @@ void Layer::reconnectRoots
     SparseNodeGrid tree_node_locator;
     fillLocator(tree_node_locator);
 
+    // Index of the tree roots into tree_roots, to find the roots to be reconnected without a linear search.
+    std::unordered_map<const Node*, size_t> tree_root_idx;
+    tree_root_idx.reserve(tree_roots.size());
+    for (size_t i = 0; i < tree_roots.size(); ++ i)
+        tree_root_idx.emplace(tree_roots[i].get(), i);
+
     const coord_t within_max_dist = outline_locator.resolution() * 2;
     for (auto root_ptr : to_be_reconnected_tree_roots)
     {
-        auto old_root_it = std::find(tree_roots.begin(), tree_roots.end(), root_ptr);
+        assert(tree_root_idx.find(root_ptr.get()) != tree_root_idx.end());
+        const size_t old_root_idx = tree_root_idx[root_ptr.get()];
+        auto old_root_it = tree_roots.begin() + old_root_idx;
+        assert(*old_root_it == root_ptr);
 
         if (root_ptr->getLastGroundingLocation())
         {
@@ -216,7 +260,6 @@ void Layer::reconnectRoots
             getBestGroundingLocation
             (
                 root_ptr->getLocation(),
-                current_outlines,
                 outline_locator,
                 supporting_radius,
                 tree_connecting_ignore_width,
@@ -252,6 +295,8 @@ void Layer::reconnectRoots
             // remove old root
             *old_root_it = std::move(tree_roots.back());
             tree_roots.pop_back();
+            if (old_root_idx < tree_roots.size())
+                tree_root_idx[tree_roots[old_root_idx].get()] = old_root_idx;
         }
     }
 }
@@ -16,6 +16,7 @@
 namespace Slic3r::FillLightning
 {
 
+class DistanceField;
 class Node;
 using NodeSPtr = std::shared_ptr<Node>;
 using SparseNodeGrid = std::unordered_multimap<Point, std::weak_ptr<Node>, PointHash>;
@@ -37,10 +38,13 @@ class Layer
 public:
     std::vector<NodeSPtr> tree_roots;
 
+    /*!
+     * Support the unsupported locations of the distance field with new branches.
+     * \param distance_field The distance field of this layer, it is updated with the new branches.
+     */
     void generateNewTrees
     (
-        const Polygons& current_overhang,
-        const Polygons& current_outlines,
+        DistanceField& distance_field,
         const EdgeGrid::Grid& outline_locator,
         const coord_t supporting_radius,
         const coord_t wall_supporting_radius
@@ -52,7 +56,6 @@ public:
     GroundingLocation getBestGroundingLocation
     (
         const Point& unsupported_location,
-        const Polygons& current_outlines,
         const EdgeGrid::Grid& outline_locator,
         const coord_t supporting_radius,
         const coord_t wall_supporting_radius,
@@ -70,7 +73,6 @@ public:
     void reconnectRoots
     (
         std::vector<NodeSPtr>& to_be_reconnected_tree_roots,
-        const Polygons& current_outlines,
         const EdgeGrid::Grid& outline_locator,
         const coord_t supporting_radius,
         const coord_t wall_supporting_radius
@@ -927,13 +927,16 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
 
     BOOST_LOG_TRIVIAL(debug) << "Start processing gcode, " << log_memory_info();
     // Post-process the G-code to update time stamps.
-    m_processor.finalize(true);
+    const bool post_process = m_processor.needs_post_process();
+    m_processor.finalize(post_process);
 //    DoExport::update_print_estimated_times_stats(m_processor, print->m_print_statistics);
     DoExport::update_print_estimated_stats(m_processor, m_writer.extruders(), print->config() ,print->m_print_statistics);
     if (result != nullptr) {
         *result = std::move(m_processor.extract_result());
         // set the filename to the correct value
         result->filename = path;
+        if (! post_process)
+            result->lines_ends = std::move(file.lines_ends());
     }
     BOOST_LOG_TRIVIAL(debug) << "Finished processing gcode, " << log_memory_info();
 
@@ -1288,6 +1291,8 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
 
     // modifies m_silent_time_estimator_enabled
     DoExport::init_gcode_processor(print.config(), m_processor, m_silent_time_estimator_enabled);
+    // If no remaining times are exported, the G-code is finalized while being written and the post-processing pass is skipped.
+    file.collect_lines_ends(! m_processor.needs_post_process());
 
     //klipper can hide gcode into a macro, so add guessed init gcode to the processor.
     if (this->config().start_gcode_manual) {
@@ -1827,15 +1832,18 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
                 } else {
                     set_extra_lift(0, 0, print.config(), m_writer, initial_extruder_id);
                 }
-                //reinit the seam placer on the new object
-                m_seam_placer.init(print);
+                // Restart the seam placement on the new object, the custom seam data collected by init() stays valid.
+                m_seam_placer.clear_history();
                 // Reset the cooling buffer internal state (the current position, feed rate, accelerations).
                 m_cooling_buffer->reset(this->writer().get_position());
                 m_cooling_buffer->set_current_extruder(initial_extruder_id);
                 // Process all layers of a single object instance (sequential mode) with a parallel pipeline:
                 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
                 // and export G-code into file.
-                this->process_layers(print, print.m_print_statistics, tool_ordering, collect_layers_to_print(object), *print_object_instance_sequential_active - object.instances().data(), file);
+                // The extrusions of an object may only be released after its last instance was printed.
+                const bool release_extrusions = m_release_layer_extrusions && std::none_of(print_object_instance_sequential_active + 1, print_object_instances_ordering.cend(),
+                    [&object](const PrintInstance *instance) { return instance->print_object == &object; });
+                this->process_layers(print, print.m_print_statistics, tool_ordering, collect_layers_to_print(object), *print_object_instance_sequential_active - object.instances().data(), release_extrusions, file);
 #ifdef HAS_PRESSURE_EQUALIZER
                 if (m_pressure_equalizer)
                     file.write(m_pressure_equalizer->process("", true));
@@ -1972,7 +1980,11 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
     if (print.m_print_statistics.total_toolchanges > 0)
     	file.write_format("; total toolchanges = %i\n", print.m_print_statistics.total_toolchanges);
     file.write_format("; total layers count = %i\n", m_layer_count);
-    file.write_format(";%s\n", GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder).c_str());
+    if (m_processor.needs_post_process())
+        file.write_format(";%s\n", GCodeProcessor::reserved_tag(GCodeProcessor::ETags::Estimated_Printing_Time_Placeholder).c_str());
+    else
+        // All the moves were processed already, no need to wait for the post-processing.
+        file.write(m_processor.estimated_printing_time_lines());
 
     // Append full config, delimited by two 'phony' configuration keys slic3r_config = begin and slic3r_config = end.
     // The delimiters are structured as configuration key / value pairs to be parsable by older versions of PrusaSlicer G-code viewer.
@@ -2001,6 +2013,19 @@ void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGenerato
     print.throw_if_canceled();
 }
 
+// Free the extrusions of the layers printed at a single print_z once their G-code was generated, see Print::set_release_layers_on_export().
+// Only the layer itself reads its extrusions during the G-code generation. The layers above it read just its lslices,
+// which are kept, for the travels and the seam placement.
+static void release_layer_extrusions(const std::vector<GCode::LayerToPrint> &layers)
+{
+    for (const GCode::LayerToPrint &layer_to_print : layers) {
+        if (layer_to_print.object_layer != nullptr)
+            const_cast<Layer*>(layer_to_print.object_layer)->release_extrusions();
+        if (layer_to_print.support_layer != nullptr)
+            const_cast<SupportLayer*>(layer_to_print.support_layer)->support_fills.clear();
+    }
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -2014,20 +2039,38 @@ void GCode::process_layers(
 {
     // The pipeline is variable: The vase mode filter is optional.
     size_t layer_to_print_idx = 0;
-    const auto generator = tbb::make_filter<void, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &print_stat, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> GCode::LayerResult {
-            CNumericLocalesSetter locales_setter;
+    const auto layer_selector = tbb::make_filter<void, GCode::LayerToProcess>(slic3r_tbb_filtermode::serial_in_order,
+        [&layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> GCode::LayerToProcess {
             if (layer_to_print_idx == layers_to_print.size()) {
                 fc.stop();
-                return GCode::LayerResult{};
-            } else {
-                const std::pair<coordf_t, std::vector<LayerToPrint>>& layer = layers_to_print[layer_to_print_idx++];
-                const LayerTools& layer_tools = tool_ordering.tools_for_layer(layer.first);
-                if (m_wipe_tower && layer_tools.has_wipe_tower)
-                    m_wipe_tower->next_layer();
-                print.throw_if_canceled();
-                return this->process_layer(print, print_stat, layer.second, layer_tools, &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
+                return {};
             }
+            return { layer_to_print_idx ++, {} };
+        });
+    // Assigning extrusions to islands and the distance fields for the seam placement do not depend on the state of the G-code generator,
+    // thus they are calculated in parallel over the layers ahead of the serial G-code generator.
+    const auto island_lookup = tbb::make_filter<GCode::LayerToProcess, GCode::LayerToProcess>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print](GCode::LayerToProcess in) -> GCode::LayerToProcess {
+            print.throw_if_canceled();
+            in.island_ids = collect_layer_island_ids(layers_to_print[in.layer_to_print_idx].second);
+            if (print.config().avoid_crossing_perimeters)
+                in.travel_boundaries = build_travel_boundaries(print, layers_to_print[in.layer_to_print_idx].second);
+            in.lower_layer_edge_grids = std::make_shared<LayerEdgeGrids>(build_lower_layer_edge_grids(layers_to_print[in.layer_to_print_idx].second));
+            return in;
+        });
+    const auto generator = tbb::make_filter<GCode::LayerToProcess, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &print_stat, &tool_ordering, &print_object_instances_ordering, &layers_to_print](GCode::LayerToProcess in) -> GCode::LayerResult {
+            CNumericLocalesSetter locales_setter;
+            const std::pair<coordf_t, std::vector<LayerToPrint>>& layer = layers_to_print[in.layer_to_print_idx];
+            const LayerTools& layer_tools = tool_ordering.tools_for_layer(layer.first);
+            if (m_wipe_tower && layer_tools.has_wipe_tower)
+                m_wipe_tower->next_layer();
+            print.throw_if_canceled();
+            m_avoid_crossing_perimeters.set_layer_boundaries(std::move(in.travel_boundaries));
+            GCode::LayerResult result = this->process_layer(print, print_stat, layer.second, layer_tools, &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1), &in.island_ids, in.lower_layer_edge_grids.get());
+            if (m_release_layer_extrusions)
+                release_layer_extrusions(layer.second);
+            return result;
         });
     const auto spiral_vase = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [&spiral_vase = *this->m_spiral_vase.get()](GCode::LayerResult in) -> GCode::LayerResult {
@@ -2045,41 +2088,55 @@ void GCode::process_layers(
             CNumericLocalesSetter locales_setter;
             return self.process_layer(std::move(s));
         });
-    const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) {
+    // The G-code of a layer is tokenized by a parallel stage ahead of each serial stage consuming the tokens,
+    // thus the serial stages on the critical path of the pipeline do not parse the G-code text.
+    const auto output_tokenizer = tbb::make_filter<std::string, GCode::TokenizedGCode>(slic3r_tbb_filtermode::parallel,
+        [&output_stream](std::string s) -> GCode::TokenizedGCode {
             CNumericLocalesSetter locales_setter;
-            output_stream.write(s); 
+            GCode::TokenizedGCode out { std::move(s), {} };
+            output_stream.tokenize(out.gcode, out.lines);
+            return out;
+        });
+    const auto output = tbb::make_filter<GCode::TokenizedGCode, void>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](GCode::TokenizedGCode in) {
+            CNumericLocalesSetter locales_setter;
+            output_stream.write(std::move(in));
         }
     );
 
-    const auto fan_mover = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
-            [&fan_mover = this->m_fan_mover, &config = this->config(), &writer = this->m_writer](std::string in)->std::string {
-        CNumericLocalesSetter locales_setter;
-
-        if (config.fan_speedup_time.value != 0 || config.fan_kickstart.value > 0) {
-            if (fan_mover.get() == nullptr)
-                fan_mover.reset(new Slic3r::FanMover(
-                    writer,
-                    std::abs((float)config.fan_speedup_time.value),
-                    config.fan_speedup_time.value > 0,
-                    config.use_relative_e_distances.value,
-                    config.fan_speedup_overhangs.value,
-                    (float)config.fan_kickstart.value));
+    if (m_fan_mover.get() == nullptr && (this->config().fan_speedup_time.value != 0 || this->config().fan_kickstart.value > 0))
+        m_fan_mover.reset(new Slic3r::FanMover(
+            m_writer,
+            std::abs((float)this->config().fan_speedup_time.value),
+            this->config().fan_speedup_time.value > 0,
+            this->config().use_relative_e_distances.value,
+            this->config().fan_speedup_overhangs.value,
+            (float)this->config().fan_kickstart.value));
+    const auto fan_mover_tokenizer = tbb::make_filter<std::string, GCode::TokenizedGCode>(slic3r_tbb_filtermode::parallel,
+        [&fan_mover = this->m_fan_mover](std::string in) -> GCode::TokenizedGCode {
+            CNumericLocalesSetter locales_setter;
+            GCode::TokenizedGCode out { std::move(in), {} };
+            fan_mover->tokenize_gcode(out.gcode, out.lines);
+            return out;
+        });
+    const auto fan_mover = tbb::make_filter<GCode::TokenizedGCode, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [&fan_mover = this->m_fan_mover](GCode::TokenizedGCode in) -> std::string {
+            CNumericLocalesSetter locales_setter;
             //flush as it's a whole layer
-            return fan_mover->process_gcode(in, true);
-        }
-        return in;
-    });
+            return fan_mover->process_gcode(in.lines, true);
+        });
 
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::filter<void, GCode::LayerResult> pipeline_to_layerresult = generator;
+    tbb::filter<void, GCode::LayerResult> pipeline_to_layerresult = layer_selector & island_lookup & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
-    tbb::filter<void, std::string> pipeline_to_string = pipeline_to_layerresult & cooling & fan_mover;
+    tbb::filter<void, std::string> pipeline_to_string = pipeline_to_layerresult & cooling;
+    if (m_fan_mover)
+        pipeline_to_string = pipeline_to_string & fan_mover_tokenizer & fan_mover;
     if (m_find_replace)
         pipeline_to_string = pipeline_to_string & find_replace;
-    tbb::filter<void, void> full_pipeline = pipeline_to_string & output;
+    tbb::filter<void, void> full_pipeline = pipeline_to_string & output_tokenizer & output;
     tbb::parallel_pipeline(12, full_pipeline);
     output_stream.find_replace_enable();
 }
@@ -2093,20 +2150,39 @@ void GCode::process_layers(
     const ToolOrdering                      &tool_ordering,
     std::vector<LayerToPrint>                layers_to_print,
     const size_t                             single_object_idx,
+    const bool                               release_extrusions,
     GCodeOutputStream                       &output_stream)
 {
     // The pipeline is variable: The vase mode filter is optional.
     size_t layer_to_print_idx = 0;
-    const auto generator = tbb::make_filter<void, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &print_stat, &tool_ordering, &layers_to_print, &layer_to_print_idx, single_object_idx](tbb::flow_control& fc) -> GCode::LayerResult {
+    const auto layer_selector = tbb::make_filter<void, GCode::LayerToProcess>(slic3r_tbb_filtermode::serial_in_order,
+        [&layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> GCode::LayerToProcess {
             if (layer_to_print_idx == layers_to_print.size()) {
                 fc.stop();
                 return {};
-            } else {
-                LayerToPrint &layer = layers_to_print[layer_to_print_idx ++];
-                print.throw_if_canceled();
-                return this->process_layer(print, print_stat, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), &layer == &layers_to_print.back(), nullptr, single_object_idx);
             }
+            return { layer_to_print_idx ++, {} };
+        });
+    // Assigning extrusions to islands and the distance fields for the seam placement do not depend on the state of the G-code generator,
+    // thus they are calculated in parallel over the layers ahead of the serial G-code generator.
+    const auto island_lookup = tbb::make_filter<GCode::LayerToProcess, GCode::LayerToProcess>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print](GCode::LayerToProcess in) -> GCode::LayerToProcess {
+            print.throw_if_canceled();
+            in.island_ids = collect_layer_island_ids({ layers_to_print[in.layer_to_print_idx] });
+            if (print.config().avoid_crossing_perimeters)
+                in.travel_boundaries = build_travel_boundaries(print, { layers_to_print[in.layer_to_print_idx] });
+            in.lower_layer_edge_grids = std::make_shared<LayerEdgeGrids>(build_lower_layer_edge_grids({ layers_to_print[in.layer_to_print_idx] }));
+            return in;
+        });
+    const auto generator = tbb::make_filter<GCode::LayerToProcess, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &print_stat, &tool_ordering, &layers_to_print, single_object_idx, release_extrusions](GCode::LayerToProcess in) -> GCode::LayerResult {
+            const LayerToPrint &layer = layers_to_print[in.layer_to_print_idx];
+            print.throw_if_canceled();
+            m_avoid_crossing_perimeters.set_layer_boundaries(std::move(in.travel_boundaries));
+            GCode::LayerResult result = this->process_layer(print, print_stat, { layer }, tool_ordering.tools_for_layer(layer.print_z()), &layer == &layers_to_print.back(), nullptr, single_object_idx, &in.island_ids, in.lower_layer_edge_grids.get());
+            if (release_extrusions)
+                release_layer_extrusions({ layer });
+            return result;
         });
     const auto spiral_vase = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [&spiral_vase = *this->m_spiral_vase.get()](GCode::LayerResult in)->GCode::LayerResult {
@@ -2121,39 +2197,49 @@ void GCode::process_layers(
         [&self = *this->m_find_replace.get()](std::string s) -> std::string {
             return self.process_layer(std::move(s));
         });
-    const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) { 
-            output_stream.write(s); 
+    const auto output_tokenizer = tbb::make_filter<std::string, GCode::TokenizedGCode>(slic3r_tbb_filtermode::parallel,
+        [&output_stream](std::string s) -> GCode::TokenizedGCode {
+            GCode::TokenizedGCode out { std::move(s), {} };
+            output_stream.tokenize(out.gcode, out.lines);
+            return out;
+        });
+    const auto output = tbb::make_filter<GCode::TokenizedGCode, void>(slic3r_tbb_filtermode::serial_in_order,
+        [&output_stream](GCode::TokenizedGCode in) {
+            output_stream.write(std::move(in));
         }
     );
 
-    const auto fan_mover = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
-        [&fan_mover = this->m_fan_mover, &config = this->config(), &writer = this->m_writer](std::string in)->std::string {
-
-        if (config.fan_speedup_time.value != 0 || config.fan_kickstart.value > 0) {
-            if (fan_mover.get() == nullptr)
-                fan_mover.reset(new Slic3r::FanMover(
-                    writer,
-                    std::abs((float)config.fan_speedup_time.value),
-                    config.fan_speedup_time.value > 0,
-                    config.use_relative_e_distances.value,
-                    config.fan_speedup_overhangs.value,
-                    (float)config.fan_kickstart.value));
+    if (m_fan_mover.get() == nullptr && (this->config().fan_speedup_time.value != 0 || this->config().fan_kickstart.value > 0))
+        m_fan_mover.reset(new Slic3r::FanMover(
+            m_writer,
+            std::abs((float)this->config().fan_speedup_time.value),
+            this->config().fan_speedup_time.value > 0,
+            this->config().use_relative_e_distances.value,
+            this->config().fan_speedup_overhangs.value,
+            (float)this->config().fan_kickstart.value));
+    const auto fan_mover_tokenizer = tbb::make_filter<std::string, GCode::TokenizedGCode>(slic3r_tbb_filtermode::parallel,
+        [&fan_mover = this->m_fan_mover](std::string in) -> GCode::TokenizedGCode {
+            GCode::TokenizedGCode out { std::move(in), {} };
+            fan_mover->tokenize_gcode(out.gcode, out.lines);
+            return out;
+        });
+    const auto fan_mover = tbb::make_filter<GCode::TokenizedGCode, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [&fan_mover = this->m_fan_mover](GCode::TokenizedGCode in) -> std::string {
             //flush as it's a whole layer
-            return fan_mover->process_gcode(in, true);
-        }
-        return in;
-    });
+            return fan_mover->process_gcode(in.lines, true);
+        });
 
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::filter<void, GCode::LayerResult> pipeline_to_layerresult = generator;
+    tbb::filter<void, GCode::LayerResult> pipeline_to_layerresult = layer_selector & island_lookup & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
-    tbb::filter<void, std::string> pipeline_to_string = pipeline_to_layerresult & cooling & fan_mover;
+    tbb::filter<void, std::string> pipeline_to_string = pipeline_to_layerresult & cooling;
+    if (m_fan_mover)
+        pipeline_to_string = pipeline_to_string & fan_mover_tokenizer & fan_mover;
     if (m_find_replace)
         pipeline_to_string = pipeline_to_string & find_replace;
-    tbb::filter<void, void> full_pipeline = pipeline_to_string & output;
+    tbb::filter<void, void> full_pipeline = pipeline_to_string & output_tokenizer & output;
     tbb::parallel_pipeline(12, full_pipeline);
     output_stream.find_replace_enable();
 }
@@ -2650,6 +2736,81 @@ namespace Skirt {
 // Matches "G92 E0" with various forms of writing the zero and with an optional comment.
 boost::regex regex_g92e0_gcode{ "^[ \\t]*[gG]92[ \\t]*[eE](0(\\.0*)?|\\.0+)[ \\t]*(;.*)?$" };
 
+// The boundaries depend on the layers only, thus they are built by a parallel stage of process_layers()
+// and reused by all the object instances printed by process_layer().
+AvoidCrossingPerimeters::LayerBoundaries GCode::build_travel_boundaries(const Print &print, const std::vector<LayerToPrint> &layers)
+{
+    std::vector<const Layer*> travel_layers;
+    for (const LayerToPrint &layer : layers) {
+        if (layer.object_layer != nullptr)
+            travel_layers.emplace_back(layer.object_layer);
+        if (layer.support_layer != nullptr)
+            travel_layers.emplace_back(layer.support_layer);
+    }
+    // The travels around the objects are planned only when moving to another object or to another instance.
+    return AvoidCrossingPerimeters::build_layer_boundaries(travel_layers, print.num_object_instances() > 1);
+}
+
+// For each object layer, region and extrusion role, find the index of the island (layer.lslices) containing each extrusion collection.
+// Independent of the G-code generator state, thus it may run ahead of process_layer() in a parallel pipeline stage.
+GCode::LayerIslandIds GCode::collect_layer_island_ids(const std::vector<LayerToPrint> &layers)
+{
+    LayerIslandIds island_ids(layers.size());
+    for (size_t layer_to_print_idx = 0; layer_to_print_idx < layers.size(); ++ layer_to_print_idx) {
+        const Layer *object_layer = layers[layer_to_print_idx].object_layer;
+        if (object_layer == nullptr)
+            continue;
+        const Layer &layer = *object_layer;
+        size_t n_slices = layer.lslices.size();
+        const std::vector<BoundingBox> &layer_surface_bboxes = layer.lslices_bboxes;
+        // Traverse the slices in an increasing order of bounding box size, so that the islands inside another islands are tested first,
+        // so we can just test a point inside ExPolygon::contour and we may skip testing the holes.
+        std::vector<size_t> slices_test_order;
+        slices_test_order.reserve(n_slices);
+        for (size_t i = 0; i < n_slices; ++ i)
+            slices_test_order.emplace_back(i);
+        std::sort(slices_test_order.begin(), slices_test_order.end(), [&layer_surface_bboxes](size_t i, size_t j) {
+            const Vec2d s1 = layer_surface_bboxes[i].size().cast<double>();
+            const Vec2d s2 = layer_surface_bboxes[j].size().cast<double>();
+            return s1.x() * s1.y() < s2.x() * s2.y();
+        });
+        auto point_inside_surface = [&layer, &layer_surface_bboxes](const size_t i, const Point &point) {
+            const BoundingBox &bbox = layer_surface_bboxes[i];
+            return point(0) >= bbox.min(0) && point(0) < bbox.max(0) &&
+                   point(1) >= bbox.min(1) && point(1) < bbox.max(1) &&
+                   layer.lslices[i].contour.contains(point);
+        };
+        auto island_of = [&](const ExtrusionEntity *ee) -> uint32_t {
+            const auto *extrusions = static_cast<const ExtrusionEntityCollection*>(ee);
+            if (extrusions->entities().empty()) // Skipped by process_layer(), first_point() would fail.
+                return uint32_t(n_slices);
+            const Point first_point = extrusions->first_point();
+            for (size_t i = 0; i < n_slices; ++ i)
+                if (point_inside_surface(slices_test_order[i], first_point))
+                    return uint32_t(slices_test_order[i]);
+            // extrusions->first_point does not fit inside any slice
+            return uint32_t(n_slices);
+        };
+
+        std::vector<std::array<std::vector<uint32_t>, 3>> &region_island_ids = island_ids[layer_to_print_idx];
+        region_island_ids.assign(layer.regions().size(), {});
+        for (size_t region_id = 0; region_id < layer.regions().size(); ++ region_id) {
+            const LayerRegion *layerm = layer.regions()[region_id];
+            if (layerm == nullptr)
+                continue;
+            auto fill_ids = [&island_of](std::vector<uint32_t> &out, const ExtrusionEntitiesPtr &entities) {
+                out.reserve(entities.size());
+                for (const ExtrusionEntity *ee : entities)
+                    out.emplace_back(island_of(ee));
+            };
+            fill_ids(region_island_ids[region_id][ObjectByExtruder::Island::Region::INFILL],     layerm->fills.entities());
+            fill_ids(region_island_ids[region_id][ObjectByExtruder::Island::Region::PERIMETERS], layerm->perimeters.entities());
+            fill_ids(region_island_ids[region_id][ObjectByExtruder::Island::Region::IRONING],    layerm->ironings.entities());
+        }
+    }
+    return island_ids;
+}
+
 // In sequential mode, process_layer is called once per each object and its copy,
 // therefore layers will contain a single entry and single_object_instance_idx will point to the copy of the object.
 // In non-sequential mode, process_layer is called per each print_z height with all object and support layers accumulated.
@@ -2666,11 +2827,16 @@ GCode::LayerResult GCode::process_layer(
     const std::vector<const PrintInstance*> *ordering,
     // If set to size_t(-1), then print all copies of all objects.
     // Otherwise print a single copy of a single object.
-    const size_t                     		 single_object_instance_idx)
+    const size_t                     		 single_object_instance_idx,
+    // Island indices precomputed by collect_layer_island_ids(), calculated here if null.
+    const LayerIslandIds                    *island_ids,
+    // Distance fields precomputed by build_lower_layer_edge_grids(), taken over by process_layer(). Calculated on demand if null.
+    LayerEdgeGrids                          *lower_layer_edge_grids_precomputed)
 {
     assert(! layers.empty());
     // Either printing all copies of all objects, or just a single copy of a single object.
     assert(single_object_instance_idx == size_t(-1) || layers.size() == 1);
+    auto process_layer_start = std::chrono::steady_clock::now();
     if(single_object_instance_idx != size_t(-1))
         m_print_object_instance_id = static_cast<uint16_t>(single_object_instance_idx);
 
@@ -2831,6 +2997,13 @@ GCode::LayerResult GCode::process_layer(
         Skirt::make_skirt_loops_per_extruder_1st_layer(print, layer_tools, m_skirt_done) :
         Skirt::make_skirt_loops_per_extruder_other_layers(print, layer_tools, m_skirt_done);
 
+    // Island of each extrusion collection, if not precomputed by process_layers().
+    LayerIslandIds island_ids_local;
+    if (island_ids == nullptr) {
+        island_ids_local = collect_layer_island_ids(layers);
+        island_ids = &island_ids_local;
+    }
+
     // Group extrusions by an extruder, then by an object, an island and a region.
     std::map<uint16_t, std::vector<ObjectByExtruder>> by_extruder;
     bool is_anything_overridden = const_cast<LayerTools&>(layer_tools).wiping_extrusions().is_anything_overridden();
@@ -2894,24 +3067,7 @@ GCode::LayerResult GCode::process_layer(
             //   option
             // (Still, we have to keep track of regions because we need to apply their config)
             size_t n_slices = layer.lslices.size();
-            const std::vector<BoundingBox> &layer_surface_bboxes = layer.lslices_bboxes;
-            // Traverse the slices in an increasing order of bounding box size, so that the islands inside another islands are tested first,
-            // so we can just test a point inside ExPolygon::contour and we may skip testing the holes.
-            std::vector<size_t> slices_test_order;
-            slices_test_order.reserve(n_slices);
-            for (size_t i = 0; i < n_slices; ++ i)
-                slices_test_order.emplace_back(i);
-            std::sort(slices_test_order.begin(), slices_test_order.end(), [&layer_surface_bboxes](size_t i, size_t j) {
-                const Vec2d s1 = layer_surface_bboxes[i].size().cast<double>();
-                const Vec2d s2 = layer_surface_bboxes[j].size().cast<double>();
-                return s1.x() * s1.y() < s2.x() * s2.y();
-            });
-            auto point_inside_surface = [&layer, &layer_surface_bboxes](const size_t i, const Point &point) {
-                const BoundingBox &bbox = layer_surface_bboxes[i];
-                return point(0) >= bbox.min(0) && point(0) < bbox.max(0) &&
-                       point(1) >= bbox.min(1) && point(1) < bbox.max(1) &&
-                       layer.lslices[i].contour.contains(point);
-            };
+            const std::vector<std::array<std::vector<uint32_t>, 3>> &region_island_ids = (*island_ids)[&layer_to_print - layers.data()];
 
             for (size_t region_id = 0; region_id < layer.regions().size(); ++ region_id) {
                 const LayerRegion *layerm = layer.regions()[region_id];
@@ -2926,10 +3082,12 @@ GCode::LayerResult GCode::process_layer(
                 // The process is almost the same for perimeters and infills - we will do it in a cycle that repeats twice:
                 std::vector<uint16_t> printing_extruders;
                 auto process_entities = [&](ObjectByExtruder::Island::Region::Type entity_type, const ExtrusionEntitiesPtr& entities) {
-                    for (const ExtrusionEntity* ee : entities) {
+                    const std::vector<uint32_t> &entity_island_ids = region_island_ids[region_id][entity_type];
+                    assert(entity_island_ids.size() == entities.size());
+                    for (size_t entity_id = 0; entity_id < entities.size(); ++ entity_id) {
                         // extrusions represents infill or perimeter extrusions of a single island.
-                        assert(dynamic_cast<const ExtrusionEntityCollection*>(ee) != nullptr);
-                        const auto* extrusions = static_cast<const ExtrusionEntityCollection*>(ee);
+                        assert(dynamic_cast<const ExtrusionEntityCollection*>(entities[entity_id]) != nullptr);
+                        const auto* extrusions = static_cast<const ExtrusionEntityCollection*>(entities[entity_id]);
                         if (extrusions->entities().empty()) // This shouldn't happen but first_point() would fail.
                             continue;
 
@@ -2969,19 +3127,11 @@ GCode::LayerResult GCode::process_layer(
                                 extruder,
                                 &layer_to_print - layers.data(),
                                 layers.size(), n_slices + 1);
-                            for (size_t i = 0; i <= n_slices; ++i) {
-                                bool   last = i == n_slices;
-                                size_t island_idx = last ? n_slices : slices_test_order[i];
-                                if (// extrusions->first_point does not fit inside any slice
-                                    last ||
-                                    // extrusions->first_point fits inside ith slice
-                                    point_inside_surface(island_idx, extrusions->first_point())) {
-                                    if (islands[island_idx].by_region.empty())
-                                        islands[island_idx].by_region.assign(print.num_print_regions(), ObjectByExtruder::Island::Region());
-                                    islands[island_idx].by_region[region.print_region_id()].append(entity_type, extrusions, entity_overrides);
-                                    break;
-                                }
-                            }
+                            const size_t island_idx = entity_island_ids[entity_id];
+                            assert(island_idx <= n_slices);
+                            if (islands[island_idx].by_region.empty())
+                                islands[island_idx].by_region.assign(print.num_print_regions(), ObjectByExtruder::Island::Region());
+                            islands[island_idx].by_region[region.print_region_id()].append(entity_type, extrusions, entity_overrides);
                         }
                     }
                 };
@@ -2993,7 +3143,8 @@ GCode::LayerResult GCode::process_layer(
     } // for objects
 
     // Extrude the skirt, brim, support, perimeters, infill ordered by the extruders.
-    std::vector<std::unique_ptr<EdgeGrid::Grid>> lower_layer_edge_grids(layers.size());
+    LayerEdgeGrids lower_layer_edge_grids = lower_layer_edge_grids_precomputed ? std::move(*lower_layer_edge_grids_precomputed) : LayerEdgeGrids(layers.size());
+    assert(lower_layer_edge_grids.size() == layers.size());
     for (uint16_t extruder_id : layer_tools.extruders)
     {
         gcode += (layer_tools.has_wipe_tower && m_wipe_tower) ?
@@ -3295,6 +3446,8 @@ GCode::LayerResult GCode::process_layer(
 
     result.gcode = std::move(gcode);
     result.cooling_buffer_flush = object_layer || raft_layer || last_layer;
+    if (m_process_layer_times)
+        m_process_layer_times->emplace_back(print_z, std::chrono::duration<double>(std::chrono::steady_clock::now() - process_layer_start).count());
     return result;
 }
 
@@ -3420,6 +3573,16 @@ static std::unique_ptr<EdgeGrid::Grid> calculate_layer_edge_grid(const Layer& la
     return out;
 }
 
+GCode::LayerEdgeGrids GCode::build_lower_layer_edge_grids(const std::vector<LayerToPrint> &layers)
+{
+    LayerEdgeGrids out(layers.size());
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id)
+        if (const Layer *layer = layers[layer_id].object_layer; layer != nullptr && layer->lower_layer != nullptr &&
+            std::any_of(layer->regions().begin(), layer->regions().end(), [](const LayerRegion *layerm) { return ! layerm->perimeters.empty(); }))
+            out[layer_id] = calculate_layer_edge_grid(*layer->lower_layer);
+    return out;
+}
+
 
 //like extrude_loop but with varying z and two full round
 std::string GCode::extrude_loop_vase(const ExtrusionLoop &original_loop, const std::string &description, double speed, std::unique_ptr<EdgeGrid::Grid> *lower_layer_edge_grid)
@@ -3559,7 +3722,7 @@ std::string GCode::extrude_loop_vase(const ExtrusionLoop &original_loop, const s
             if (path == paths.begin() && step == Step::INCR){
                 if (paths.back().role() == erExternalPerimeter && m_layer != NULL && m_config.perimeters.value > 1 && paths.front().size() >= 2 && paths.back().polyline.points.size() >= 3) {
                     paths[0].polyline.points.erase(paths[0].polyline.points.begin());
-                    gcode += m_writer.extrude_to_xy(this->point_to_gcode(paths[0].polyline.points.front()), 0);
+                    m_writer.extrude_to_xy(gcode, this->point_to_gcode(paths[0].polyline.points.front()), 0);
                 }
             }
 
@@ -3584,11 +3747,11 @@ std::string GCode::extrude_loop_vase(const ExtrusionLoop &original_loop, const s
                     coordf_t current_height_internal = current_height + height_increment / 2;
                     //ensure you go to the good xyz
                     if( (last_point - previous).norm() > EPSILON)
-                        gcode += m_writer.extrude_to_xyz(last_point, 0, description);
+                        m_writer.extrude_to_xyz(gcode, last_point, 0, description);
                     //extrusions
                     for (int i = 0; i < nb_sections - 1; i++) {
                         Vec3d new_point = last_point + pos_increment;
-                        gcode += m_writer.extrude_to_xyz(new_point,
+                        m_writer.extrude_to_xyz(gcode, new_point,
                             e_per_mm_per_height * (line_length / nb_sections) * current_height_internal,
                             description);
                         current_height_internal += height_increment;
@@ -3598,7 +3761,7 @@ std::string GCode::extrude_loop_vase(const ExtrusionLoop &original_loop, const s
                     last_point.x() = this->point_to_gcode(line.b).x();
                     last_point.y() = this->point_to_gcode(line.b).y();
                     last_point.z() = current_z + z_per_length * line_length;
-                    gcode += m_writer.extrude_to_xyz(
+                    m_writer.extrude_to_xyz(gcode,
                         last_point,
                         e_per_mm_per_height * (line_length / nb_sections) * current_height_internal,
                         comment);
@@ -3674,7 +3837,7 @@ std::string GCode::extrude_loop_vase(const ExtrusionLoop &original_loop, const s
         inward_point.rotate(angle, paths.front().polyline.points.front());
         
         // generate the travel move
-        gcode += m_writer.travel_to_xy(this->point_to_gcode(inward_point), 0.0, "move inwards before travel");
+        m_writer.travel_to_xy(gcode, this->point_to_gcode(inward_point), 0.0, "move inwards before travel");
     }
 
     return gcode;
@@ -4031,7 +4194,7 @@ std::string GCode::extrude_loop(const ExtrusionLoop &original_loop, const std::s
                 for (Point& pt : path.polyline.points) {
                     prev_point = current_point;
                     current_point = pt;
-                    gcode += m_writer.travel_to_xy(this->point_to_gcode(pt), 0.0, config().gcode_comments ? "; extra wipe" : "");
+                    m_writer.travel_to_xy(gcode, this->point_to_gcode(pt), 0.0, config().gcode_comments ? "; extra wipe" : "");
                     this->set_last_pos(pt);
                 }
             }
@@ -4075,7 +4238,7 @@ std::string GCode::extrude_loop(const ExtrusionLoop &original_loop, const std::s
         pt_inside.rotate(angle, current_point);
         // generate the travel move
         if (EXTRUDER_CONFIG_WITH_DEFAULT(wipe_inside_end, true)) {
-            gcode += m_writer.travel_to_xy(this->point_to_gcode(pt_inside), 0.0, "move inwards before travel");
+            m_writer.travel_to_xy(gcode, this->point_to_gcode(pt_inside), 0.0, "move inwards before travel");
             this->set_last_pos(pt_inside);
         }
 
@@ -4178,7 +4341,7 @@ std::string GCode::extrude_multi_path3D(const ExtrusionMultiPath3D &multipath3D,
                 Line line(path.polyline.points[i], path.polyline.points[i + 1]);
                 const double line_length = line.length() * SCALING_FACTOR;
                 path_length += line_length;
-                gcode += m_writer.extrude_to_xyz(
+                m_writer.extrude_to_xyz(gcode,
                     this->point_to_gcode(line.b, path.z_offsets.size()>i+1 ? path.z_offsets[i+1] : 0),
                     e_per_mm * line_length,
                     comment);
@@ -4287,7 +4450,7 @@ std::string GCode::extrude_path_3D(const ExtrusionPath3D &path, const std::strin
             Line line(path.polyline.points[i], path.polyline.points[i + 1]);
             const double line_length = line.length() * SCALING_FACTOR;
             path_length += line_length;
-            gcode += m_writer.extrude_to_xyz(
+            m_writer.extrude_to_xyz(gcode,
                 this->point_to_gcode(line.b, path.z_offsets.size()>i ? path.z_offsets[i] : 0),
                 e_per_mm * line_length,
                 comment);
@@ -4454,12 +4617,55 @@ void GCode::GCodeOutputStream::write(const char *what)
     if (what != nullptr) {
         //FIXME don't allocate a string, maybe process a batch of lines?
         std::string gcode(m_find_replace ? m_find_replace->process_layer(what) : what);
-        // writes string to file
-        fwrite(gcode.c_str(), 1, gcode.size(), this->f);
+        this->write_text(gcode);
         m_processor.process_buffer(gcode);
     }
 }
 
+void GCode::GCodeOutputStream::write(TokenizedGCode &&what)
+{
+    if (m_find_replace) {
+        // The lines were tokenized before find / replace, process the modified G-code.
+        this->write(what.gcode);
+        return;
+    }
+    if (this->write_text(what.gcode) && ! what.lines.empty())
+        // The empty line tokenized from the dropped '\n'.
+        what.lines.erase(what.lines.begin());
+    m_processor.process_lines(what.lines);
+}
+
+bool GCode::GCodeOutputStream::write_text(std::string &gcode)
+{
+    bool dropped_lf = false;
+    if (m_collect_lines_ends) {
+        if (m_last_cr && ! gcode.empty() && gcode.front() == '\n') {
+            gcode.erase(gcode.begin());
+            dropped_lf = true;
+        }
+        m_last_cr = ! gcode.empty() && gcode.back() == '\r';
+        if (gcode.find('\r') != std::string::npos) {
+            // Replace "\r\n" and single '\r' with '\n'.
+            size_t j = 0;
+            for (size_t i = 0; i < gcode.size(); ++ i) {
+                if (gcode[i] == '\r') {
+                    gcode[j ++] = '\n';
+                    if (i + 1 < gcode.size() && gcode[i + 1] == '\n')
+                        ++ i;
+                } else
+                    gcode[j ++] = gcode[i];
+            }
+            gcode.resize(j);
+        }
+        for (size_t i = gcode.find('\n'); i != std::string::npos; i = gcode.find('\n', i + 1))
+            m_lines_ends.emplace_back(m_file_pos + i + 1);
+        m_file_pos += gcode.size();
+    }
+    // writes string to file
+    fwrite(gcode.c_str(), 1, gcode.size(), this->f);
+    return dropped_lf;
+}
+
 void GCode::GCodeOutputStream::writeln(const std::string &what)
 {
     if (! what.empty())
@@ -4532,7 +4738,7 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
                 // normal & legacy pathcode
                 for (const Line& line : path.polyline.lines()) {
                     if (line.a == line.b) continue; //todo: investigate if it happens (it happens in perimeters)
-                    gcode += m_writer.extrude_to_xy(
+                    m_writer.extrude_to_xy(gcode,
                         this->point_to_gcode(line.b),
                         e_per_mm * unscaled(line.length()),
                         comment);
@@ -4574,7 +4780,7 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
                             //Create a point
                             Point inter_point1 = line.point_at(scale_d(length1));
                             //extrude very reduced
-                            gcode += m_writer.extrude_to_xy(
+                            m_writer.extrude_to_xy(gcode,
                                 this->point_to_gcode(inter_point1),
                                 e_per_mm * (length1) * mult1,
                                 comment);
@@ -4583,21 +4789,21 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
                             if (line_length - length1 > length2) {
                                 Point inter_point2 = line.point_at(scale_d(length1 + length2));
                                 //extrude reduced
-                                gcode += m_writer.extrude_to_xy(
+                                m_writer.extrude_to_xy(gcode,
                                     this->point_to_gcode(inter_point2),
                                     e_per_mm * (length2) * mult2,
                                     comment);
                                 sum += e_per_mm * (length2) * mult2;
 
                                 //extrude normal
-                                gcode += m_writer.extrude_to_xy(
+                                m_writer.extrude_to_xy(gcode,
                                     this->point_to_gcode(line.b),
                                     e_per_mm * (line_length - (length1 + length2)),
                                     comment);
                                 sum += e_per_mm * (line_length - (length1 + length2));
                             } else {
                                 mult2 = 1 - coeff * (length2 / (line_length - length1));
-                                gcode += m_writer.extrude_to_xy(
+                                m_writer.extrude_to_xy(gcode,
                                     this->point_to_gcode(line.b),
                                     e_per_mm * (line_length - length1) * mult2,
                                     comment);
@@ -4605,14 +4811,14 @@ std::string GCode::_extrude(const ExtrusionPath &path, const std::string &descri
                             }
                         } else {
                             double mult = std::max(0.1, 1 - coeff * (scale_(path.width) / line_length));
-                            gcode += m_writer.extrude_to_xy(
+                            m_writer.extrude_to_xy(gcode,
                                 this->point_to_gcode(line.b),
                                 e_per_mm * line_length * mult,
                                 comment);
                         }
                     } else {
                         // nothing special, angle is too shallow to have any impact.
-                        gcode += m_writer.extrude_to_xy(
+                        m_writer.extrude_to_xy(gcode,
                             this->point_to_gcode(line.b),
                             e_per_mm * unscaled(line.length()),
                             comment);
@@ -5128,7 +5334,7 @@ std::string GCode::_before_extrude(const ExtrusionPath &path, const std::string
     }
     // F     is mm per minute.
     // speed is mm per second
-    gcode += m_writer.set_speed(speed, "", comment);
+    m_writer.set_speed(gcode, speed, "", comment);
 
     return gcode;
 }
@@ -5282,7 +5488,7 @@ void GCode::write_travel_to(std::string &gcode, const Polyline& travel, std::str
             } else if (current_speed < max_speed) {
                 current_speed = max_speed;
             }
-            gcode += m_writer.travel_to_xy(
+            m_writer.travel_to_xy(gcode,
                 this->point_to_gcode(travel.points[idx_print]),
                 current_speed>2 ? double(uint32_t(current_speed)) : current_speed,
                 comment);
@@ -5312,14 +5518,14 @@ void GCode::write_travel_to(std::string &gcode, const Polyline& travel, std::str
 
         //finish writing moves at current speed
         for (; idx_print < travel.size(); ++idx_print)
-            gcode += m_writer.travel_to_xy(this->point_to_gcode(travel.points[idx_print]),
+            m_writer.travel_to_xy(gcode, this->point_to_gcode(travel.points[idx_print]),
                 current_speed > 2 ? double(uint32_t(current_speed)) : current_speed,
                 comment);
         this->set_last_pos(travel.points.back());
     } else if (travel.size() >= 2) {
         for (size_t i = 1; i < travel.size(); ++i)
             // use G1 because we rely on paths being straight (G0 may make round paths)
-            gcode += m_writer.travel_to_xy(this->point_to_gcode(travel.points[i]), 0.0, comment);
+            m_writer.travel_to_xy(gcode, this->point_to_gcode(travel.points[i]), 0.0, comment);
         this->set_last_pos(travel.points.back());
     }
 }
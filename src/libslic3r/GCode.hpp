@@ -174,6 +174,10 @@ public:
     unsigned int    layer_count() const { return m_layer_count; }
     void            set_layer_count(unsigned int value) { m_layer_count = value; }
     void            apply_print_config(const PrintConfig &print_config);
+    // Collect the wall time spent by process_layer() for each layer as pairs of (print_z, seconds), for profiling. Null to disable.
+    void            set_process_layer_times(std::vector<std::pair<coordf_t, double>> *times) { m_process_layer_times = times; }
+    // Free the extrusions of each layer as soon as its G-code was generated, see Print::set_release_layers_on_export().
+    void            set_release_layer_extrusions(bool release) { m_release_layer_extrusions = release; }
 
     // append full config to the given string
     static void append_full_config(const Print& print, std::string& str);
@@ -191,6 +195,13 @@ public:
     };
 
 private:
+    // Layer G-code passed between the stages of process_layers() together with its lines tokenized by a parallel stage,
+    // so that the serial stages consuming the tokens (FanMover, GCodeProcessor) do not parse the G-code text again.
+    struct TokenizedGCode {
+        std::string                          gcode;
+        std::vector<GCodeReader::GCodeLine>  lines;
+    };
+
     class GCodeOutputStream {
     public:
         GCodeOutputStream(FILE* f, GCodeProcessor& processor, GCode& gcodegen) : f(f), m_processor(processor), m_gcodegen(gcodegen) {}
@@ -203,6 +214,11 @@ private:
         void find_replace_enable() { m_find_replace = m_find_replace_backup; }
         void find_replace_supress() { m_find_replace = nullptr; }
 
+        // Normalize the line ends to '\n' and collect their positions the way TimeProcessor::post_process() does,
+        // to be enabled if the G-code is not going to be post-processed.
+        void collect_lines_ends(bool enable) { m_collect_lines_ends = enable; }
+        std::vector<size_t>& lines_ends() { return m_lines_ends; }
+
         bool is_open() const { return f; }
         bool is_error() const;
         
@@ -212,6 +228,10 @@ private:
         // Write a string into a file.
         void write(const std::string& what) { this->write(what.c_str()); }
         void write(const char* what);
+        // Write a layer G-code tokenized by tokenize() into a file.
+        void write(TokenizedGCode &&what);
+        // Tokenize the G-code for write(TokenizedGCode&&). Thread safe, thus it may run in parallel with writing the preceding layers.
+        void tokenize(const std::string &gcode, std::vector<GCodeReader::GCodeLine> &lines) const { m_processor.tokenize_buffer(gcode, lines); }
 
         // Write a string into a file. 
         // Add a newline, if the string does not end with a newline already.
@@ -222,6 +242,10 @@ private:
         void write_format(const char* format, ...);
 
     private:
+        // Collect the line ends if enabled and write the G-code into the file.
+        // Returns true if a '\n' at the start of gcode was dropped as a part of the line end started by the preceding string.
+        bool write_text(std::string &gcode);
+
         FILE             *f { nullptr };
         // Find-replace post-processor to be called before GCodePostProcessor.
         GCodeFindReplace *m_find_replace { nullptr };
@@ -229,6 +253,12 @@ private:
         GCodeFindReplace *m_find_replace_backup { nullptr };
         GCodeProcessor   &m_processor;
         GCode            &m_gcodegen;
+        bool              m_collect_lines_ends { false };
+        // Positions of ends of lines in the file, if m_collect_lines_ends.
+        std::vector<size_t> m_lines_ends;
+        size_t            m_file_pos { 0 };
+        // The last string written ended with '\r', thus a '\n' starting the next one is a part of the same line end.
+        bool              m_last_cr { false };
     };
     void            _do_export(Print &print, GCodeOutputStream &file, ThumbnailsGeneratorCallback thumbnail_cb);
 
@@ -237,6 +267,28 @@ private:
     static std::vector<LayerToPrint>        		                   collect_layers_to_print(const PrintObject &object);
     static std::vector<std::pair<coordf_t, std::vector<LayerToPrint>>> collect_layers_to_print(const Print &print);
 
+    // Island index of each infill / perimeter / ironing collection of the object layers printed at a single print_z,
+    // indexed by [LayerToPrint][LayerRegion][ObjectByExtruder::Island::Region::Type][entity].
+    // Index == number of lslices if the collection does not fit inside any island.
+    // It only depends on the layer geometry, thus it is computed by a parallel stage of process_layers()
+    // ahead of the serial process_layer(), which carries the G-code generator state.
+    using LayerIslandIds = std::vector<std::vector<std::array<std::vector<uint32_t>, 3>>>;
+    static LayerIslandIds collect_layer_island_ids(const std::vector<LayerToPrint> &layers);
+    // Boundaries for the travels avoiding crossing perimeters of the layers printed at the same height.
+    static AvoidCrossingPerimeters::LayerBoundaries build_travel_boundaries(const Print &print, const std::vector<LayerToPrint> &layers);
+    // Distance fields of the layers below the object layers printed at a single print_z, indexed by LayerToPrint.
+    // The seam placer uses them to penalize seams over overhangs.
+    using LayerEdgeGrids = std::vector<std::unique_ptr<EdgeGrid::Grid>>;
+    static LayerEdgeGrids build_lower_layer_edge_grids(const std::vector<LayerToPrint> &layers);
+    // Layer passed from the parallel island lookup stage of process_layers() to the serial G-code generator stage.
+    struct LayerToProcess {
+        size_t                                      layer_to_print_idx { 0 };
+        LayerIslandIds                              island_ids;
+        AvoidCrossingPerimeters::LayerBoundaries    travel_boundaries;
+        // Held by a shared pointer for the pipeline tokens to stay copyable.
+        std::shared_ptr<LayerEdgeGrids>             lower_layer_edge_grids;
+    };
+
     struct LayerResult {
         std::string gcode;
         size_t      layer_id;
@@ -256,7 +308,11 @@ private:
 		const std::vector<const PrintInstance*> *ordering,
         // If set to size_t(-1), then print all copies of all objects.
         // Otherwise print a single copy of a single object.
-        size_t                     single_object_idx = size_t(-1)
+        size_t                     single_object_idx = size_t(-1),
+        // Island indices precomputed by collect_layer_island_ids(), calculated here if null.
+        const LayerIslandIds            *island_ids = nullptr,
+        // Distance fields precomputed by build_lower_layer_edge_grids(), taken over by process_layer(). Calculated on demand if null.
+        LayerEdgeGrids                  *lower_layer_edge_grids = nullptr
         );
     // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
     // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
@@ -277,6 +333,8 @@ private:
         const ToolOrdering                      &tool_ordering,
         std::vector<LayerToPrint>                layers_to_print,
         const size_t                             single_object_idx,
+        // Free the extrusions of the layers once processed, only for the last instance of the object to be printed.
+        const bool                               release_extrusions,
         GCodeOutputStream                       &output_stream);
 
     void            set_last_pos(const Point &pos) { m_last_pos = pos; m_last_pos_defined = true; }
@@ -485,6 +543,8 @@ private:
     void _add_object_change_labels(std::string &gcode);
 
     bool m_silent_time_estimator_enabled;
+    std::vector<std::pair<coordf_t, double>> *m_process_layer_times { nullptr };
+    bool m_release_layer_extrusions { false };
 
     // Processor
     GCodeProcessor m_processor;
@@ -11,6 +11,8 @@
 
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <numeric>
 #include <unordered_set>
 #include <boost/range/adaptor/reversed.hpp>
@@ -1159,9 +1161,9 @@ static ExPolygons get_boundary(const Layer &layer)
 }
 
 // called by AvoidCrossingPerimeters::travel_to()
-static Polygons get_boundary_external(const Layer &layer)
+// perimeter_spacing is the value of get_perimeter_spacing_external(layer).
+static Polygons get_boundary_external(const Layer &layer, const float perimeter_spacing)
 {
-    const float perimeter_spacing = get_perimeter_spacing_external(layer);
     const float perimeter_offset  = perimeter_spacing / 2.f;
     auto const *support_layer     = dynamic_cast<const SupportLayer *>(&layer);
     Polygons    boundary;
@@ -1237,6 +1239,82 @@ static void init_boundary(AvoidCrossingPerimeters::Boundary *boundary, Polygons
     init_boundary_distances(boundary);
 }
 
+static void init_boundary_internal(AvoidCrossingPerimeters::Boundary *boundary, const Layer &layer)
+{
+    const float perimeter_spacing = get_perimeter_spacing(layer);
+    std::vector<std::pair<ExPolygon, ExPolygons>> boundary_growth;
+    //create better slice (on second perimeter instead of the first)
+    ExPolygons expoly_boundary;
+    //as we are going to reduce, do it expoli per expoli
+    for (const ExPolygon& origin : layer.lslices) {
+        ExPolygons second_peri = offset_ex(origin, -perimeter_spacing * 1.5f);
+        //there is a collapse! try to add missing parts
+        if (second_peri.size() > 1) {
+            // get the bits that are collapsed
+            ExPolygons missing_parts = diff_ex(ExPolygons{ origin }, offset_ex(second_peri, perimeter_spacing * 1.51f), ApplySafetyOffset::Yes);
+            //have to grow a bit to be able to fit inside the reduced thing
+            // then intersect to be sure it don't stick out of the initial poly
+            missing_parts = intersection_ex(ExPolygons{ origin }, offset_ex(missing_parts, perimeter_spacing * 1.1f));
+            // offset to second peri (-first) where possible, then union and reduce to the first.
+            second_peri = offset_ex(union_ex(missing_parts, offset_ex(origin, -perimeter_spacing * 0.9f)), -perimeter_spacing * .6f);
+        } else if (second_peri.size() == 0) {
+            // try again with the first perimeter (should be 0.5, but even with overlapping peri, it's almost never a 50% overlap, so it's better that way)
+            second_peri = offset_ex(origin, -perimeter_spacing * .6f);
+        }
+        append(expoly_boundary, second_peri);
+        boundary_growth.push_back({ origin, second_peri });
+    }
+    init_boundary(boundary, to_polygons(expoly_boundary));
+    boundary->boundary_growth = std::move(boundary_growth);
+}
+
+// Boundary for travels inside of the layer, built if not cached yet.
+static const AvoidCrossingPerimeters::Boundary& layer_boundary_internal(AvoidCrossingPerimeters::LayerBoundaries &boundaries, const Layer &layer)
+{
+    for (const std::pair<const Layer*, std::shared_ptr<const AvoidCrossingPerimeters::Boundary>> &internal : boundaries.internal)
+        if (internal.first == &layer)
+            return *internal.second;
+    auto boundary = std::make_shared<AvoidCrossingPerimeters::Boundary>();
+    init_boundary_internal(boundary.get(), layer);
+    boundaries.internal.emplace_back(&layer, boundary);
+    return *boundary;
+}
+
+// Boundary for travels around the objects printed at the height of the layer, built if not cached yet.
+// get_boundary_external() depends just on the height, on the type of the layer and on the perimeter spacing.
+static const AvoidCrossingPerimeters::Boundary& layer_boundary_external(AvoidCrossingPerimeters::LayerBoundaries &boundaries, const Layer &layer)
+{
+    const bool  support_layer     = dynamic_cast<const SupportLayer*>(&layer) != nullptr;
+    const float perimeter_spacing = get_perimeter_spacing_external(layer);
+    for (const AvoidCrossingPerimeters::LayerBoundaries::External &external : boundaries.external)
+        if (external.print_z == layer.print_z && external.support_layer == support_layer && external.perimeter_spacing == perimeter_spacing)
+            return *external.boundary;
+    auto boundary = std::make_shared<AvoidCrossingPerimeters::Boundary>();
+    init_boundary(boundary.get(), get_boundary_external(layer, perimeter_spacing));
+    boundaries.external.push_back({ layer.print_z, support_layer, perimeter_spacing, boundary });
+    return *boundary;
+}
+
+AvoidCrossingPerimeters::LayerBoundaries AvoidCrossingPerimeters::build_layer_boundaries(const std::vector<const Layer*> &layers, bool with_external)
+{
+    LayerBoundaries out;
+    out.internal.reserve(layers.size());
+    for (const Layer *layer : layers)
+        out.internal.emplace_back(layer, nullptr);
+    // Large plates print many objects at the same height, build their boundaries in parallel.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.internal.size()), [&out](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            auto boundary = std::make_shared<Boundary>();
+            init_boundary_internal(boundary.get(), *out.internal[i].first);
+            out.internal[i].second = std::move(boundary);
+        }
+    });
+    if (with_external)
+        for (const Layer *layer : layers)
+            layer_boundary_external(out, *layer);
+    return out;
+}
+
 // Plan travel, which avoids perimeter crossings by following the boundaries of the layer.
 Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &point, bool *could_be_wipe_disabled)
 {
@@ -1261,47 +1339,23 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &
         /*|| (!lslices.empty() && !any_expolygon_contains(lslices, lslices_bboxes, m_grid_lslice, travel)) already done by the caller */
         )) {
         // Initialize m_internal only when it is necessary.
-        if (m_internal.boundaries.empty()) {
-            std::vector<std::pair<ExPolygon, ExPolygons>> boundary_growth;
-            //create better slice (on second perimeter instead of the first)
-            ExPolygons expoly_boundary;
-            //as we are going to reduce, do it expoli per expoli
-            for (const ExPolygon& origin : lslices) {
-                ExPolygons second_peri = offset_ex(origin, -perimeter_spacing * 1.5f);
-                //there is a collapse! try to add missing parts
-                if (second_peri.size() > 1) {
-                    // get the bits that are collapsed
-                    ExPolygons missing_parts = diff_ex(ExPolygons{ origin }, offset_ex(second_peri, perimeter_spacing * 1.51f), ApplySafetyOffset::Yes);
-                    //have to grow a bit to be able to fit inside the reduced thing
-                    // then intersect to be sure it don't stick out of the initial poly
-                    missing_parts = intersection_ex(ExPolygons{ origin }, offset_ex(missing_parts, perimeter_spacing * 1.1f));
-                    // offset to second peri (-first) where possible, then union and reduce to the first.
-                    second_peri = offset_ex(union_ex(missing_parts, offset_ex(origin, -perimeter_spacing * 0.9f)), -perimeter_spacing * .6f);
-                } else if (second_peri.size() == 0) {
-                    // try again with the first perimeter (should be 0.5, but even with overlapping peri, it's almost never a 50% overlap, so it's better that way)
-                    second_peri = offset_ex(origin, -perimeter_spacing * .6f);
-                }
-                append(expoly_boundary, second_peri);
-                boundary_growth.push_back({ origin, second_peri });
-            }
-            init_boundary(&m_internal, to_polygons(expoly_boundary));
-            m_internal.boundary_growth = boundary_growth;
-        }
+        if (m_internal == nullptr)
+            m_internal = &layer_boundary_internal(m_boundaries, *gcodegen.layer());
 
         // Trim the travel line by the bounding box.
-        if (!m_internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), perimeter_spacing, *gcodegen.layer(), result_pl);
+        if (!m_internal->boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal->bbox)) {
+            travel_intersection_count = avoid_perimeters(*m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), perimeter_spacing, *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
     } else if(use_external) {
         // Initialize m_external only when exist any external travel for the current layer.
-        if (m_external.boundaries.empty())
-            init_boundary(&m_external, get_boundary_external(*gcodegen.layer()));
+        if (m_external == nullptr)
+            m_external = &layer_boundary_external(m_boundaries, *gcodegen.layer());
 
         // Trim the travel line by the bounding box.
-        if (!m_external.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_external.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_external, startf.cast<coord_t>(), endf.cast<coord_t>(), 0, *gcodegen.layer(), result_pl);
+        if (!m_external->boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_external->bbox)) {
+            travel_intersection_count = avoid_perimeters(*m_external, startf.cast<coord_t>(), endf.cast<coord_t>(), 0, *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
@@ -1344,15 +1398,10 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &
 
 void AvoidCrossingPerimeters::init_layer(const Layer &layer)
 {
-    m_internal.clear();
-    m_external.clear();
-
-    BoundingBox bbox_slice(get_extents(layer.lslices));
-    bbox_slice.offset(SCALED_EPSILON);
-
-    m_grid_lslice.set_bbox(bbox_slice);
-    //FIXME 1mm grid?
-    m_grid_lslice.create(layer.lslices, coord_t(scale_(1.)));
+    // The boundaries are picked by the first travel of this layer. The ones already built are kept in m_boundaries,
+    // thus printing many instances of the same object, or many objects at the same height, doesn't rebuild them.
+    m_internal = nullptr;
+    m_external = nullptr;
     m_init = true;
 }
 
@@ -5,6 +5,8 @@
 #include "../ExPolygon.hpp"
 #include "../EdgeGrid.hpp"
 
+#include <memory>
+
 namespace Slic3r {
 
 // Forward declarations.
@@ -23,6 +25,8 @@ public:
     bool        disabled_once() const   { return m_disabled_once; }
     void        reset_once_modifiers()  { m_use_external_mp_once = false; m_disabled_once = false; }
 
+    // Start printing a layer of an object instance. The boundaries are built on demand by the first travel
+    // inside the layer and around the objects, or taken from the boundaries passed to set_layer_boundaries().
     void        init_layer(const Layer &layer);
     bool        is_init() { return m_init; }
 
@@ -54,6 +58,26 @@ public:
         }
     };
 
+    // Boundaries of the layers printed at the same height. They depend on the layers only, not on the state of the G-code generator,
+    // thus they are shared by all the instances of an object and they may be built in parallel ahead of the G-code generator.
+    struct LayerBoundaries {
+        struct External {
+            coordf_t                        print_z;
+            bool                            support_layer;
+            float                           perimeter_spacing;
+            std::shared_ptr<const Boundary> boundary;
+        };
+        // Boundaries for travels inside of a layer.
+        std::vector<std::pair<const Layer*, std::shared_ptr<const Boundary>>> internal;
+        // Boundaries for travels around the objects, shared by the layers of the same height.
+        std::vector<External>                                                 external;
+    };
+    // Build the boundaries of layers printed at the same height, the external ones only if with_external.
+    // Thread safe, the layers are processed in parallel.
+    static LayerBoundaries build_layer_boundaries(const std::vector<const Layer*> &layers, bool with_external);
+    // Replace the boundaries cached for the previous layers, for example with the ones built by build_layer_boundaries() for the next layers.
+    void        set_layer_boundaries(LayerBoundaries &&boundaries) { m_boundaries = std::move(boundaries); m_internal = nullptr; m_external = nullptr; }
+
 private:
     bool           m_use_external_mp { false };
     // just for the next travel move
@@ -64,12 +88,12 @@ private:
 
     bool m_init{ false };
 
-    // Used for detection of line or polyline is inside of any polygon.
-    EdgeGrid::Grid m_grid_lslice;
-    // Store all needed data for travels inside object
-    Boundary m_internal;
-    // Store all needed data for travels outside object
-    Boundary m_external;
+    // Boundaries of the layers printed at the current height.
+    LayerBoundaries m_boundaries;
+    // Store all needed data for travels inside object, picked from m_boundaries by the first travel after init_layer().
+    const Boundary *m_internal { nullptr };
+    // Store all needed data for travels outside object, picked from m_boundaries by the first travel after init_layer().
+    const Boundary *m_external { nullptr };
 };
 
 } // namespace Slic3r
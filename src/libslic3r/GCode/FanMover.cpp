@@ -20,6 +20,13 @@
 namespace Slic3r {
 
 const std::string& FanMover::process_gcode(const std::string& gcode, bool flush)
+{
+    std::vector<GCodeReader::GCodeLine> lines;
+    this->tokenize_gcode(gcode, lines);
+    return this->process_gcode(lines, flush);
+}
+
+const std::string& FanMover::process_gcode(const std::vector<GCodeReader::GCodeLine>& lines, bool flush)
 {
     m_process_output = "";
 
@@ -27,8 +34,8 @@ const std::string& FanMover::process_gcode(const std::string& gcode, bool flush)
     m_buffer_time_size = 0;
     for (auto& data : m_buffer) m_buffer_time_size += data.time;
 
-    if(!gcode.empty())
-        m_parser.parse_buffer(gcode,
+    if(!lines.empty())
+        m_parser.parse_tokenized(lines,
             [this](GCodeReader& reader, const GCodeReader::GCodeLine& line) { /*m_process_output += line.raw() + "\n";*/ this->_process_gcode_line(reader, line); });
 
     if (flush) {
@@ -69,6 +69,10 @@ public:
 
     // Adds the gcode contained in the given string to the analysis and returns it after removing the workcodes
     const std::string& process_gcode(const std::string& gcode, bool flush);
+    // Same as above for the gcode already tokenized by tokenize_gcode().
+    const std::string& process_gcode(const std::vector<GCodeReader::GCodeLine>& lines, bool flush);
+    // Tokenize the gcode for process_gcode(). Thread safe, thus it may run in parallel with process_gcode() of the preceding layers.
+    void tokenize_gcode(const std::string& gcode, std::vector<GCodeReader::GCodeLine>& lines) const { m_parser.tokenize_buffer(gcode, lines); }
 
 private:
     BufferData& put_in_buffer(BufferData&& data) {
@@ -12,6 +12,7 @@
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <float.h>
 #include <assert.h>
@@ -345,7 +346,24 @@ void GCodeProcessor::TimeProcessor::reset()
     machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].enabled = true;
 }
 
-void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, std::vector<GCodeProcessorResult::MoveVertex>& moves, std::vector<size_t>& lines_ends)
+std::string GCodeProcessor::TimeProcessor::estimated_printing_time_lines() const
+{
+    std::string ret;
+    for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+        const TimeMachine& machine = machines[i];
+        PrintEstimatedStatistics::ETimeMode mode = static_cast<PrintEstimatedStatistics::ETimeMode>(i);
+        if (mode == PrintEstimatedStatistics::ETimeMode::Normal || machine.enabled) {
+            char buf[128];
+            sprintf(buf, "; estimated printing time (%s mode) = %s\n",
+                (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
+                get_time_dhms(machine.time).c_str());
+            ret += buf;
+        }
+    }
+    return ret;
+}
+
+void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, GCodeProcessorResult::MoveVertices& moves, std::vector<size_t>& lines_ends)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
     if (in.f == nullptr)
@@ -478,19 +496,8 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
                     }
                 }
             }
-            else if (line == reserved_tag(ETags::Estimated_Printing_Time_Placeholder)) {
-                for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
-                    const TimeMachine& machine = machines[i];
-                    PrintEstimatedStatistics::ETimeMode mode = static_cast<PrintEstimatedStatistics::ETimeMode>(i);
-                    if (mode == PrintEstimatedStatistics::ETimeMode::Normal || machine.enabled) {
-                        char buf[128];
-                        sprintf(buf, "; estimated printing time (%s mode) = %s\n",
-                            (mode == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
-                            get_time_dhms(machine.time).c_str());
-                        ret += buf;
-                    }
-                }
-            }
+            else if (line == reserved_tag(ETags::Estimated_Printing_Time_Placeholder))
+                ret = this->estimated_printing_time_lines();
         }
 
         if (! ret.empty())
@@ -663,12 +670,12 @@ void GCodeProcessor::TimeProcessor::post_process(const std::string& filename, st
     // updates moves' gcode ids which have been modified by the insertion of the M73 lines
     unsigned int curr_offset_id = 0;
     unsigned int total_offset = 0;
-    for (GCodeProcessorResult::MoveVertex& move : moves) {
-        while (curr_offset_id < static_cast<unsigned int>(offsets.size()) && offsets[curr_offset_id].first <= move.gcode_id) {
+    for (size_t i = 0; i < moves.size(); ++ i) {
+        while (curr_offset_id < static_cast<unsigned int>(offsets.size()) && offsets[curr_offset_id].first <= moves.gcode_id(i)) {
             total_offset += offsets[curr_offset_id].second;
             ++curr_offset_id;
         }
-        move.gcode_id += total_offset;
+        moves.set_gcode_id(i, moves.gcode_id(i) + total_offset);
     }
 
     std::error_code err_code;
@@ -747,9 +754,136 @@ void GCodeProcessor::UsedFilaments::process_caches(GCodeProcessor* processor)
     process_role_cache(processor);
 }
 
+static inline uint32_t float_bits(float f)
+{
+    uint32_t out;
+    memcpy(&out, &f, sizeof(out));
+    return out;
+}
+
+bool GCodeProcessorResult::MoveVertices::Attributes::operator==(const Attributes &rhs) const
+{
+    return type == rhs.type && extrusion_role == rhs.extrusion_role && extruder_id == rhs.extruder_id && cp_color_id == rhs.cp_color_id &&
+           layer_id == rhs.layer_id && float_bits(feedrate) == float_bits(rhs.feedrate) && float_bits(width) == float_bits(rhs.width) &&
+           float_bits(height) == float_bits(rhs.height) && float_bits(mm3_per_mm) == float_bits(rhs.mm3_per_mm) &&
+           float_bits(fan_speed) == float_bits(rhs.fan_speed) && float_bits(temperature) == float_bits(rhs.temperature);
+}
+
+size_t GCodeProcessorResult::MoveVertices::hash(const Attributes &attributes)
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, uint32_t(attributes.type) | (uint32_t(attributes.extrusion_role) << 8) |
+        (uint32_t(attributes.extruder_id) << 16) | (uint32_t(attributes.cp_color_id) << 24));
+    boost::hash_combine(seed, attributes.layer_id);
+    boost::hash_combine(seed, float_bits(attributes.feedrate));
+    boost::hash_combine(seed, float_bits(attributes.width));
+    boost::hash_combine(seed, float_bits(attributes.height));
+    boost::hash_combine(seed, float_bits(attributes.mm3_per_mm));
+    boost::hash_combine(seed, float_bits(attributes.fan_speed));
+    boost::hash_combine(seed, float_bits(attributes.temperature));
+    return seed;
+}
+
+void GCodeProcessorResult::MoveVertices::clear()
+{
+    m_gcode_ids.clear();
+    m_positions.clear();
+    m_delta_extruders.clear();
+    m_times.clear();
+    m_attributes.clear();
+    m_palette.clear();
+    this->clear_palette_cache();
+    m_layers_times.clear();
+    m_layers_times_valid = false;
+}
+
+uint32_t GCodeProcessorResult::MoveVertices::attributes_id(const Attributes &attributes)
+{
+    // Most of the time the move shares its attributes with the previous one.
+    if (! m_attributes.empty() && m_palette[m_attributes.back()] == attributes)
+        return m_attributes.back();
+    uint32_t &cached = m_palette_cache[hash(attributes) % m_palette_cache.size()];
+    if (cached == std::numeric_limits<uint32_t>::max() || ! (m_palette[cached] == attributes)) {
+        cached = uint32_t(m_palette.size());
+        m_palette.emplace_back(attributes);
+    }
+    return cached;
+}
+
+void GCodeProcessorResult::MoveVertices::push_back(const MoveVertex &move)
+{
+    Attributes attributes;
+    attributes.type           = move.type;
+    attributes.extrusion_role = move.extrusion_role;
+    attributes.extruder_id    = move.extruder_id;
+    attributes.cp_color_id    = move.cp_color_id;
+    // layer_duration holds the layer id until the G-code is finalized.
+    attributes.layer_id       = uint32_t(move.layer_duration);
+    attributes.feedrate       = move.feedrate;
+    attributes.width          = move.width;
+    attributes.height         = move.height;
+    attributes.mm3_per_mm     = move.mm3_per_mm;
+    attributes.fan_speed      = move.fan_speed;
+    attributes.temperature    = move.temperature;
+    m_attributes.emplace_back(this->attributes_id(attributes));
+    m_gcode_ids.emplace_back(move.gcode_id);
+    m_positions.emplace_back(move.position);
+    m_delta_extruders.emplace_back(move.delta_extruder);
+    m_times.emplace_back(move.time);
+}
+
+GCodeProcessorResult::MoveVertex GCodeProcessorResult::MoveVertices::operator[](size_t idx) const
+{
+    const Attributes &attributes = m_palette[m_attributes[idx]];
+    float layer_duration = float(attributes.layer_id);
+    if (m_layers_times_valid) {
+        size_t layer_id = attributes.layer_id;
+        layer_duration = m_layers_times.size() > layer_id - 1 && layer_id > 0 ? m_layers_times[layer_id - 1] : 0.f;
+    }
+    return MoveVertex(m_gcode_ids[idx], attributes.type, attributes.extrusion_role, attributes.extruder_id, attributes.cp_color_id,
+        m_positions[idx], m_delta_extruders[idx], attributes.feedrate, attributes.width, attributes.height, attributes.mm3_per_mm,
+        attributes.fan_speed, attributes.temperature, m_times[idx], layer_duration);
+}
+
+void GCodeProcessorResult::MoveVertices::move_to_back(size_t idx, const Vec3f &position, float height)
+{
+    assert(idx < this->size());
+    Attributes attributes = m_palette[m_attributes[idx]];
+    attributes.height = height;
+    std::rotate(m_gcode_ids.begin() + idx, m_gcode_ids.begin() + idx + 1, m_gcode_ids.end());
+    std::rotate(m_positions.begin() + idx, m_positions.begin() + idx + 1, m_positions.end());
+    std::rotate(m_delta_extruders.begin() + idx, m_delta_extruders.begin() + idx + 1, m_delta_extruders.end());
+    std::rotate(m_times.begin() + idx, m_times.begin() + idx + 1, m_times.end());
+    m_attributes.erase(m_attributes.begin() + idx);
+    m_attributes.emplace_back(this->attributes_id(attributes));
+    m_positions.back() = position;
+}
+
+void GCodeProcessorResult::MoveVertices::set_width_height(EMoveType type, float width, float height)
+{
+    bool modified = false;
+    for (Attributes &attributes : m_palette)
+        if (attributes.type == type) {
+            attributes.width  = width;
+            attributes.height = height;
+            modified = true;
+        }
+    if (modified)
+        // The hashes of the modified entries changed.
+        this->clear_palette_cache();
+}
+
+size_t GCodeProcessorResult::MoveVertices::memsize() const
+{
+    return SLIC3R_STDVEC_MEMSIZE(m_gcode_ids, uint32_t) + SLIC3R_STDVEC_MEMSIZE(m_positions, Vec3f) +
+           SLIC3R_STDVEC_MEMSIZE(m_delta_extruders, float) + SLIC3R_STDVEC_MEMSIZE(m_times, float) +
+           SLIC3R_STDVEC_MEMSIZE(m_attributes, uint32_t) + SLIC3R_STDVEC_MEMSIZE(m_palette, Attributes) +
+           sizeof(m_palette_cache) + SLIC3R_STDVEC_MEMSIZE(m_layers_times, float);
+}
+
 #if ENABLE_GCODE_VIEWER_STATISTICS
 void GCodeProcessorResult::reset() {
-    moves = std::vector<GCodeProcessorResult::MoveVertex>();
+    moves = MoveVertices();
     bed_shape = Pointfs();
     max_print_height = 0.0f;
     settings_ids.reset();
@@ -1447,15 +1581,25 @@ void GCodeProcessor::process_buffer(const std::string &buffer)
     });
 }
 
+void GCodeProcessor::process_lines(const std::vector<GCodeReader::GCodeLine>& lines)
+{
+    m_parser.parse_tokenized(lines, [this](GCodeReader&, const GCodeReader::GCodeLine& line) {
+        this->process_gcode_line(line, false);
+    });
+}
+
+std::string GCodeProcessor::estimated_printing_time_lines()
+{
+    // Process the time blocks still waiting in the planner queues, the rest of finalize() does not modify the machines' time.
+    for (TimeMachine& machine : m_time_processor.machines)
+        machine.calculate_time();
+    return m_time_processor.estimated_printing_time_lines();
+}
+
 void GCodeProcessor::finalize(bool post_process)
 {
     // update width/height of wipe moves
-    for (GCodeProcessorResult::MoveVertex& move : m_result.moves) {
-        if (move.type == EMoveType::Wipe) {
-            move.width = Wipe_Width;
-            move.height = Wipe_Height;
-        }
-    }
+    m_result.moves.set_width_height(EMoveType::Wipe, Wipe_Width, Wipe_Height);
 
     // process the time blocks
     for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
@@ -1470,16 +1614,8 @@ void GCodeProcessor::finalize(bool post_process)
 
     update_estimated_times_stats();
 
-    //update times for results
-    for (size_t i = 0; i < m_result.moves.size(); i++) {
-        //field layer_duration contains the layer id for the move in which the layer_duration has to be set.
-        size_t layer_id = size_t(m_result.moves[i].layer_duration);
-        std::vector<float>& layer_times = m_result.print_statistics.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].layers_times;
-        if (layer_times.size() > layer_id - 1 && layer_id > 0)
-            m_result.moves[i].layer_duration = layer_times[layer_id - 1];
-        else
-            m_result.moves[i].layer_duration = 0;
-    }
+    //update times for results: field layer_duration contains the layer id for the move in which the layer_duration has to be set.
+    m_result.moves.set_layers_times(m_result.print_statistics.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].layers_times);
 #if ENABLE_GCODE_VIEWER_DATA_CHECKING
     m_mm3_per_mm_compare.output();
     m_height_compare.output();
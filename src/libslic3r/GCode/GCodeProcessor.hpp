@@ -14,6 +14,7 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <limits>
 
 namespace Slic3r {
 
@@ -123,9 +124,105 @@ namespace Slic3r {
             float volumetric_rate() const { return feedrate * mm3_per_mm; }
         };
 
+        // Storage of MoveVertex by columns, to reduce the memory footprint of G-codes with tens of millions of moves.
+        // The attributes mostly shared by consecutive moves (type, role, extruder, color, feedrate, width, height, mm3_per_mm,
+        // fan speed, temperature and layer) are stored once into a palette and referenced by an index.
+        // MoveVertex::layer_duration is resolved from the layer id when accessed, once the layers times are known.
+        // The moves are accessed by value, MoveVertex is assembled on the fly.
+        class MoveVertices
+        {
+        public:
+            class const_iterator
+            {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type        = MoveVertex;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = void;
+                using reference         = MoveVertex;
+
+                const_iterator(const MoveVertices &moves, size_t idx) : m_moves(&moves), m_idx(idx) {}
+                MoveVertex      operator*() const { return (*m_moves)[m_idx]; }
+                const_iterator& operator++() { ++ m_idx; return *this; }
+                const_iterator  operator++(int) { const_iterator out = *this; ++ m_idx; return out; }
+                bool            operator==(const const_iterator &rhs) const { return m_idx == rhs.m_idx; }
+                bool            operator!=(const const_iterator &rhs) const { return m_idx != rhs.m_idx; }
+
+            private:
+                const MoveVertices *m_moves;
+                size_t              m_idx;
+            };
+
+            MoveVertices() { this->clear_palette_cache(); }
+
+            size_t          size()  const { return m_gcode_ids.size(); }
+            bool            empty() const { return m_gcode_ids.empty(); }
+            void            clear();
+            void            push_back(const MoveVertex &move);
+            template<typename... Args>
+            void            emplace_back(Args&&... args) { this->push_back(MoveVertex(std::forward<Args>(args)...)); }
+
+            MoveVertex      operator[](size_t idx) const;
+            MoveVertex      front() const { return (*this)[0]; }
+            MoveVertex      back()  const { return (*this)[this->size() - 1]; }
+            const_iterator  begin() const { return const_iterator(*this, 0); }
+            const_iterator  end()   const { return const_iterator(*this, this->size()); }
+
+            // Access to single fields, not assembling the whole MoveVertex.
+            uint32_t        gcode_id(size_t idx) const { return m_gcode_ids[idx]; }
+            void            set_gcode_id(size_t idx, uint32_t gcode_id) { m_gcode_ids[idx] = gcode_id; }
+            const Vec3f&    position(size_t idx) const { return m_positions[idx]; }
+            EMoveType       type(size_t idx) const { return m_palette[m_attributes[idx]].type; }
+            ExtrusionRole   extrusion_role(size_t idx) const { return m_palette[m_attributes[idx]].extrusion_role; }
+
+            // Remove the move at idx and append it to the end with a new position and height.
+            void            move_to_back(size_t idx, const Vec3f &position, float height);
+            // Assign width and height to all moves of the given type.
+            void            set_width_height(EMoveType type, float width, float height);
+            // From now on, MoveVertex::layer_duration will be looked up in layers_times instead of returning the layer id.
+            void            set_layers_times(std::vector<float> layers_times) { m_layers_times = std::move(layers_times); m_layers_times_valid = true; }
+
+            size_t          memsize() const;
+
+        private:
+            struct Attributes
+            {
+                EMoveType       type            { EMoveType::Noop };
+                ExtrusionRole   extrusion_role  { erNone };
+                uint8_t         extruder_id     { 0 };
+                uint8_t         cp_color_id     { 0 };
+                uint32_t        layer_id        { 0 };
+                float           feedrate        { 0.f };
+                float           width           { 0.f };
+                float           height          { 0.f };
+                float           mm3_per_mm      { 0.f };
+                float           fan_speed       { 0.f };
+                float           temperature     { 0.f };
+
+                // Bitwise comparison of the floats, so that each value is stored exactly.
+                bool operator==(const Attributes &rhs) const;
+            };
+            static size_t   hash(const Attributes &attributes);
+            uint32_t        attributes_id(const Attributes &attributes);
+            void            clear_palette_cache() { m_palette_cache.fill(std::numeric_limits<uint32_t>::max()); }
+
+            std::vector<uint32_t>   m_gcode_ids;
+            std::vector<Vec3f>      m_positions;
+            std::vector<float>      m_delta_extruders;
+            std::vector<float>      m_times;
+            // Indices into m_palette.
+            std::vector<uint32_t>   m_attributes;
+            std::vector<Attributes> m_palette;
+            // Direct mapped cache of recently used palette entries indexed by a hash of the attributes, to find the duplicates
+            // without the memory overhead of a hash map. Missing a duplicate only grows the palette.
+            std::array<uint32_t, 4096> m_palette_cache;
+            std::vector<float>      m_layers_times;
+            bool                    m_layers_times_valid { false };
+        };
+
         std::string filename;
         unsigned int id;
-        std::vector<MoveVertex> moves;
+        MoveVertices moves;
         // Positions of ends of lines of the final G-code this->filename after TimeProcessor::post_process() finalizes the G-code.
         std::vector<size_t> lines_ends;
         Pointfs bed_shape;
@@ -367,9 +464,12 @@ namespace Slic3r {
 
             void reset();
 
+            // lines replacing the placeholder of the estimated printing time, one for each enabled mode
+            std::string estimated_printing_time_lines() const;
+
             // post process the file with the given filename to add remaining time lines M73
             // and updates moves' gcode ids accordingly
-            void post_process(const std::string& filename, std::vector<GCodeProcessorResult::MoveVertex>& moves, std::vector<size_t>& lines_ends);
+            void post_process(const std::string& filename, GCodeProcessorResult::MoveVertices& moves, std::vector<size_t>& lines_ends);
         };
 
         struct UsedFilaments  // filaments per ColorChange
@@ -440,10 +540,7 @@ namespace Slic3r {
 
                 const Vec3f position = m_result.moves.back().position;
 
-                GCodeProcessorResult::MoveVertex& move = m_result.moves.emplace_back(m_result.moves[*m_move_id]);
-                move.position = position;
-                move.height = height;
-                m_result.moves.erase(m_result.moves.begin() + *m_move_id);
+                m_result.moves.move_to_back(*m_move_id, position, height);
                 m_result.custom_gcode_per_print_z[*m_custom_gcode_per_print_z_id].print_z = position.z();
                 reset();
             }
@@ -626,7 +723,17 @@ namespace Slic3r {
         // Streaming interface, for processing G-codes just generated by PrusaSlicer in a pipelined fashion.
         void initialize(const std::string& filename);
         void process_buffer(const std::string& buffer);
+        // Tokenize a buffer for process_lines(). Thread safe, thus it may run in parallel with process_lines() of the preceding buffers.
+        void tokenize_buffer(const std::string& buffer, std::vector<GCodeReader::GCodeLine>& lines) const { m_parser.tokenize_buffer(buffer, lines); }
+        void process_lines(const std::vector<GCodeReader::GCodeLine>& lines);
         void finalize(bool post_process);
+        // Whether the exported G-code has to be post-processed by finalize(true).
+        // The remaining time lines M73 / M117 need the total print time, which is known only after the whole G-code was processed,
+        // thus they cannot be emitted while the G-code is being exported.
+        bool needs_post_process() const { return m_time_processor.export_remaining_time_enabled; }
+        // Lines to be exported instead of the Estimated_Printing_Time_Placeholder if the G-code is not post-processed.
+        // To be called after the last move was processed.
+        std::string estimated_printing_time_lines();
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
         std::string get_time_dhm(PrintEstimatedStatistics::ETimeMode mode) const;
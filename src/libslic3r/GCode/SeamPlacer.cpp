@@ -9,6 +9,8 @@
 #include "libslic3r/SVG.hpp"
 #include "libslic3r/Layer.hpp"
 
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 // This penalty is added to all points inside custom blockers (subtracted from pts inside enforcers).
@@ -208,11 +210,18 @@ void SeamPlacer::init(const Print& print)
    float max_nozzle_dmr = *std::max_element(nozzle_dmrs.begin(), nozzle_dmrs.end());
 
 
-    std::vector<ExPolygons> temp_enf;
-    std::vector<ExPolygons> temp_blk;
-    std::vector<Polygons>   temp_polygons;
+    // Remember the PrintObjects and initialize a store of enforcers and blockers for each of them.
+    // Projecting and offsetting the custom seam facets is independent for each object, thus it is done in parallel.
+    m_po_list.assign(print.objects().begin(), print.objects().end());
+    m_enforcers.assign(m_po_list.size(), std::vector<CustomTrianglesPerLayer>());
+    m_blockers.assign(m_po_list.size(), std::vector<CustomTrianglesPerLayer>());
 
-    for (const PrintObject* po : print.objects()) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_po_list.size(), 1), [this, max_nozzle_dmr](const tbb::blocked_range<size_t> &range) {
+      for (size_t po_idx = range.begin(); po_idx < range.end(); ++ po_idx) {
+        const PrintObject *po = m_po_list[po_idx];
+        std::vector<ExPolygons> temp_enf;
+        std::vector<ExPolygons> temp_blk;
+        std::vector<Polygons>   temp_polygons;
 
         auto merge_and_offset = [po, &temp_polygons, max_nozzle_dmr](EnforcerBlockerType type, std::vector<ExPolygons>& out) {
             // Offset the triangles out slightly.
@@ -244,11 +253,8 @@ void SeamPlacer::init(const Print& print)
         merge_and_offset(EnforcerBlockerType::BLOCKER, temp_blk);
         merge_and_offset(EnforcerBlockerType::ENFORCER, temp_enf);
 
-        // Remember this PrintObject and initialize a store of enforcers and blockers for it.
-        m_po_list.push_back(po);
-        size_t po_idx = m_po_list.size() - 1;
-        m_enforcers.emplace_back(std::vector<CustomTrianglesPerLayer>(temp_enf.size()));
-        m_blockers.emplace_back(std::vector<CustomTrianglesPerLayer>(temp_blk.size()));
+        m_enforcers[po_idx].assign(temp_enf.size(), CustomTrianglesPerLayer());
+        m_blockers[po_idx].assign(temp_blk.size(), CustomTrianglesPerLayer());
 
         // A helper class to store data to build the AABB tree from.
         class CustomTriangleRef {
@@ -296,7 +302,8 @@ void SeamPlacer::init(const Print& print)
 
         add_custom(temp_enf, m_enforcers.at(po_idx));
         add_custom(temp_blk, m_blockers.at(po_idx));
-    }
+      }
+    });
 
     this->external_perimeters_first = print.default_region_config().external_perimeters_first;
 }
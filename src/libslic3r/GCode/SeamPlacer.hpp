@@ -41,6 +41,9 @@ private:
 class SeamPlacer {
 public:
     void init(const Print& print);
+    // Forget the seams placed so far, keeping the custom seam data collected by init().
+    // Used when a next object is printed in sequential mode.
+    void clear_history() { m_seam_history.clear(); }
 
     // When perimeters are printed, first call this function with the respective
     // external perimeter. SeamPlacer will find a location for its seam and remember it.
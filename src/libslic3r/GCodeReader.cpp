@@ -10,6 +10,21 @@
 
 #include "LocalesUtils.hpp"
 
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+// Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
+
 #include <Shiny/Shiny.h>
 #include <fast_float/fast_float.h>
 
@@ -35,16 +50,13 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
     m_extrusion_axis = get_extrusion_axis_char(m_config);
 }
 
-const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+const char* GCodeReader::parse_line_axes(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const
 {
-    PROFILE_FUNC();
-
     assert(is_decimal_separator_point());
     
     // command and args
     const char *c = ptr;
     {
-        PROFILE_BLOCK(command_and_args);
         // Skip the whitespaces.
         command.first = skip_whitespaces(c);
         // Skip the command.
@@ -91,17 +103,12 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
         }
     }
     
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
-
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
     // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr) {
-        PROFILE_BLOCK(copy_raw_string);
+    if (c > ptr)
         gline.m_raw.assign(ptr, c);
-    }
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -109,13 +116,18 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
+    return c;
+}
 
+const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    PROFILE_FUNC();
+    const char *c = this->parse_line_axes(ptr, end, gline, command);
+    this->begin_tokenized_line(gline);
     return c;
 }
 
-void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command)
+void GCodeReader::update_coordinates(const GCodeLine &gline, const std::pair<const char*, const char*> &command)
 {
     PROFILE_FUNC();
     if (*command.first == 'G') {
@@ -129,10 +141,109 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
     }
 }
 
+void GCodeReader::begin_tokenized_line(const GCodeLine &gline)
+{
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+    if (m_verbose)
+        std::cout << gline.m_raw << std::endl;
+}
+
+void GCodeReader::end_tokenized_line(const GCodeLine &gline)
+{
+    std::pair<const char*, const char*> cmd;
+    cmd.first  = skip_whitespaces(gline.m_raw.c_str());
+    cmd.second = skip_word(cmd.first);
+    this->update_coordinates(gline, cmd);
+}
+
+void GCodeReader::tokenize_buffer(const std::string &buffer, std::vector<GCodeLine> &lines) const
+{
+    const char *ptr = buffer.c_str();
+    const char *end = ptr + buffer.size();
+    std::pair<const char*, const char*> cmd;
+    lines.clear();
+    while (*ptr != 0)
+        ptr = this->parse_line_axes(ptr, end, lines.emplace_back(), cmd);
+}
+
+// Read-only memory mapping of a G-code file.
+// The mapped block is trimmed after the last '\n', so that the G-code parser, which relies on each line being terminated
+// by '\r', '\n' or zero, never reads past the mapped memory. The last line not terminated by '\n' is copied to tail().
+class MappedGCodeFile
+{
+public:
+    // Returns false if the file could not be mapped, then the caller shall fall back to reading the file by fread().
+    bool open(const std::string &filename)
+    {
+        try {
+            m_file.open(boost::filesystem::path(filename));
+        } catch (const std::exception &) {
+            return false;
+        }
+        if (! m_file.is_open())
+            return false;
+        m_begin = m_file.data();
+        m_end   = m_begin + m_file.size();
+        const char *file_end = m_end;
+        while (m_end != m_begin && m_end[-1] != '\n')
+            -- m_end;
+        m_tail.assign(m_end, file_end);
+        return true;
+    }
+
+    const char*         begin() const { return m_begin; }
+    const char*         end()   const { return m_end; }
+    size_t              size()  const { return m_end - m_begin; }
+    const std::string&  tail()  const { return m_tail; }
+
+private:
+    boost::iostreams::mapped_file_source    m_file;
+    const char                             *m_begin { nullptr };
+    const char                             *m_end   { nullptr };
+    std::string                             m_tail;
+};
+
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_lines(const char *begin, const char *end, size_t file_pos, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    for (const char *it = begin; it != end;) {
+        // Find end of line.
+        const char *it_end = it;
+        for (; it_end != end && *it_end != '\r' && *it_end != '\n'; ++ it_end)
+            ;
+        parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return false;
+        // Skip EOL.
+        it = it_end;
+        if (it != end && *it == '\r')
+            ++ it;
+        if (it != end && *it == '\n')
+            line_end_callback(file_pos + (++ it - begin));
+    }
+    return true;
+}
+
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    MappedGCodeFile file;
+    if (! file.open(filename))
+        return this->parse_file_raw_internal_fread(filename, parse_line_callback, line_end_callback);
+    m_parsing = true;
+    if (this->parse_lines(file.begin(), file.end(), 0, parse_line_callback, line_end_callback))
+        this->parse_lines(file.tail().c_str(), file.tail().c_str() + file.tail().size(), file.size(), parse_line_callback, line_end_callback);
+    return true;
+}
+
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_file_raw_internal_fread(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
+    if (in.f == nullptr)
+        return false;
 
     // Read the input stream 64kB at a time, extract lines and process them.
     std::vector<char> buffer(65536 * 10, 0);
@@ -188,13 +299,100 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
-    GCodeLine gline;    
-    return this->parse_file_raw_internal(filename, 
-        [this, &gline, parse_line_callback](const char *begin, const char *end) {
-            gline.reset();
-            this->parse_line(begin, end, gline, parse_line_callback);
-        }, 
-        line_end_callback);
+    MappedGCodeFile file;
+    if (! file.open(filename)) {
+        GCodeLine gline;
+        return this->parse_file_raw_internal_fread(filename,
+            [this, &gline, parse_line_callback](const char *begin, const char *end) {
+                gline.reset();
+                this->parse_line(begin, end, gline, parse_line_callback);
+            },
+            line_end_callback);
+    }
+
+    // Two phase parsing of the memory mapped file:
+    // The file is split into chunks at line boundaries, the lines of the chunks are tokenized in parallel,
+    // then the tokenized lines are passed to the callback in order by a serial stage, which also updates
+    // the position of the reader. Thus the callback sees the very same sequence of lines and reader states
+    // as if the file was parsed serially.
+    struct Line {
+        GCodeLine   gline;
+        // File position after the terminating '\n', or zero if the line is not terminated by '\n'.
+        size_t      line_end { 0 };
+    };
+    struct Chunk {
+        const char         *begin    { nullptr };
+        const char         *end      { nullptr };
+        size_t              file_pos { 0 };
+        std::vector<Line>   lines;
+    };
+
+    // Chunk size in bytes, split at the next line end.
+    static constexpr const size_t chunk_size = 512 * 1024;
+    const char *chunk_begin = file.begin();
+    bool        tail_done   = file.tail().empty();
+    m_parsing = true;
+
+    const auto splitter = tbb::make_filter<void, Chunk>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &file, &chunk_begin, &tail_done](tbb::flow_control &fc) -> Chunk {
+            Chunk chunk;
+            if (! m_parsing) {
+                // Parsing was interrupted by the callback.
+                fc.stop();
+            } else if (chunk_begin != file.end()) {
+                chunk.begin    = chunk_begin;
+                chunk.end      = chunk_begin + std::min(chunk_size, size_t(file.end() - chunk_begin));
+                chunk.file_pos = chunk_begin - file.begin();
+                if (chunk.end != file.end())
+                    // The mapped block is trimmed after the last '\n', thus there is always a line end to be found.
+                    chunk.end = static_cast<const char*>(memchr(chunk.end, '\n', file.end() - chunk.end)) + 1;
+                chunk_begin = chunk.end;
+            } else if (! tail_done) {
+                // The last line not terminated by '\n'.
+                chunk.begin    = file.tail().c_str();
+                chunk.end      = chunk.begin + file.tail().size();
+                chunk.file_pos = file.size();
+                tail_done      = true;
+            } else
+                fc.stop();
+            return chunk;
+        });
+    const auto tokenizer = tbb::make_filter<Chunk, Chunk>(slic3r_tbb_filtermode::parallel,
+        [this](Chunk chunk) -> Chunk {
+            // The caller's numeric locale is not active on the TBB worker threads.
+            CNumericLocalesSetter locales_setter;
+            // The lines are split the same way parse_lines() does.
+            for (const char *it = chunk.begin; it != chunk.end;) {
+                const char *it_end = it;
+                for (; it_end != chunk.end && *it_end != '\r' && *it_end != '\n'; ++ it_end)
+                    ;
+                Line &line = chunk.lines.emplace_back();
+                std::pair<const char*, const char*> cmd;
+                this->parse_line_axes(it, it_end, line.gline, cmd);
+                it = it_end;
+                if (it != chunk.end && *it == '\r')
+                    ++ it;
+                if (it != chunk.end && *it == '\n')
+                    line.line_end = chunk.file_pos + (++ it - chunk.begin);
+            }
+            return chunk;
+        });
+    const auto consumer = tbb::make_filter<Chunk, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &parse_line_callback, &line_end_callback](Chunk chunk) {
+            for (Line &line : chunk.lines) {
+                if (! m_parsing)
+                    // The callback wishes to exit.
+                    return;
+                GCodeLine &gline = line.gline;
+                this->begin_tokenized_line(gline);
+                parse_line_callback(*this, gline);
+                this->end_tokenized_line(gline);
+                if (line.line_end > 0)
+                    line_end_callback(line.line_end);
+            }
+        });
+    tbb::parallel_pipeline(12, splitter & tokenizer & consumer);
+    return true;
 }
 
 bool GCodeReader::parse_file(const std::string &file, callback_t callback)
@@ -2,11 +2,13 @@
 #define slic3r_GCodeReader_hpp_
 
 #include "libslic3r.h"
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <functional>
 #include <string>
 #include <string_view>
+#include <vector>
 #include "PrintConfig.hpp"
 
 namespace Slic3r {
@@ -107,6 +109,24 @@ public:
     void parse_buffer(const std::string &buffer)
         { this->parse_buffer(buffer, [](GCodeReader&, const GCodeReader::GCodeLine&){}); }
 
+    // Tokenize the lines of a buffer the way parse_buffer() does, but don't touch the state of the reader,
+    // thus it may be called by multiple threads in parallel, for example by a parallel stage of a pipeline.
+    void tokenize_buffer(const std::string &buffer, std::vector<GCodeLine> &lines) const;
+    // Pass the lines tokenized by tokenize_buffer() to the callback and update the state of the reader
+    // the same way parse_buffer() would do for the buffer the lines were tokenized from.
+    template<typename Callback>
+    void parse_tokenized(const std::vector<GCodeLine> &lines, Callback callback)
+    {
+        m_parsing = true;
+        for (const GCodeLine &gline : lines) {
+            if (! m_parsing)
+                break;
+            this->begin_tokenized_line(gline);
+            callback(*this, gline);
+            this->end_tokenized_line(gline);
+        }
+    }
+
     template<typename Callback>
     const char* parse_line(const char *ptr, const char *end, GCodeLine &gline, Callback &callback)
     {
@@ -150,11 +170,23 @@ public:
 private:
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
+    // Fallback of parse_file_raw_internal() if the file could not be memory mapped.
+    template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_file_raw_internal_fread(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
+    // Split a block of memory into lines, call parse_line_callback(begin, end) for each line and line_end_callback(file_pos) after each '\n'.
+    // file_pos is the offset of begin in the file. Returns false if parsing was stopped by quit_parsing().
+    template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_lines(const char *begin, const char *end, size_t file_pos, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
-    void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Fill in the axes of gline, but don't touch the state of the reader, thus it may be called by multiple threads in parallel.
+    const char* parse_line_axes(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const;
+    void        update_coordinates(const GCodeLine &gline, const std::pair<const char*, const char*> &command);
+    // Update the state of the reader before and after a line tokenized by parse_line_axes() is passed to a callback.
+    void        begin_tokenized_line(const GCodeLine &gline);
+    void        end_tokenized_line(const GCodeLine &gline);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
     static bool         is_end_of_line(char c)          { return c == '\r' || c == '\n' || c == 0; }
@@ -176,7 +208,19 @@ private:
     float       m_position[NUM_AXES];
     bool        m_verbose;
     // To be set by the callback to stop parsing.
-    bool        m_parsing{ false };
+    // Atomic, as parse_file() polls it from a pipeline stage running on another thread than the callback.
+    // Wrapped to keep GCodeReader copyable, see SpiralVase.
+    class ParsingFlag {
+    public:
+        ParsingFlag() = default;
+        ParsingFlag(const ParsingFlag &rhs) : m_value(rhs.m_value.load()) {}
+        ParsingFlag& operator=(const ParsingFlag &rhs) { m_value = rhs.m_value.load(); return *this; }
+        ParsingFlag& operator=(bool value) { m_value = value; return *this; }
+        operator bool() const { return m_value.load(); }
+    private:
+        std::atomic<bool> m_value { false };
+    };
+    ParsingFlag m_parsing;
 };
 
 } /* namespace Slic3r */
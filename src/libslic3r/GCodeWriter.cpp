@@ -10,17 +10,13 @@
 #include <iostream>
 #include <map>
 
-#ifdef __APPLE__
-    #include <boost/spirit/include/karma.hpp>
-#endif
-
 #define FLAVOR_IS(val) this->config.gcode_flavor.value == val
 #define FLAVOR_IS_NOT(val) this->config.gcode_flavor.value != val
-// TODO: switch to gcodeformatter classes
-#define COMMENT(comment) if (this->config.gcode_comments.value && !comment.empty()) gcode << " ; " << comment;
-#define PRECISION(val, precision) to_string_nozero(val, precision)
+// The G-code is appended into a std::string with the LocalesUtils formatters, instead of going through a std::ostringstream.
+#define COMMENT(comment) if (this->config.gcode_comments.value && !comment.empty()) { gcode += " ; "; gcode += comment; }
+#define PRECISION(val, precision) append_nozero(gcode, val, precision)
 #define XYZ_NUM(val) PRECISION(val, this->config.gcode_precision_xyz.value)
-#define FLOAT_PRECISION(val, precision) std::defaultfloat << std::setprecision(precision) << (val)
+#define FLOAT_PRECISION(val, precision) append_defaultfloat(gcode, val, precision)
 #define F_NUM(val) FLOAT_PRECISION(val, 8)
 #define E_NUM(val) PRECISION(val, this->config.gcode_precision_e.value)
 namespace Slic3r {
@@ -108,11 +104,11 @@ void GCodeWriter::set_mills(std::vector<uint16_t> mill_ids)
 
 std::string GCodeWriter::preamble()
 {
-    std::ostringstream gcode;
+    std::string gcode;
     
     if (FLAVOR_IS_NOT(gcfMakerWare)) {
-        gcode << "G21 ; set units to millimeters\n";
-        gcode << "G90 ; use absolute coordinates\n";
+        gcode += "G21 ; set units to millimeters\n";
+        gcode += "G90 ; use absolute coordinates\n";
     }
     if (FLAVOR_IS(gcfSprinter) ||
         FLAVOR_IS(gcfRepRap) ||
@@ -125,22 +121,22 @@ std::string GCodeWriter::preamble()
         FLAVOR_IS(gcfKlipper))
     {
         if (this->config.use_relative_e_distances) {
-            gcode << "M83 ; use relative distances for extrusion\n";
+            gcode += "M83 ; use relative distances for extrusion\n";
         } else {
-            gcode << "M82 ; use absolute distances for extrusion\n";
+            gcode += "M82 ; use absolute distances for extrusion\n";
         }
-        gcode << this->reset_e(true);
+        gcode += this->reset_e(true);
     }
     
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::postamble() const
 {
-    std::ostringstream gcode;
+    std::string gcode;
     if (FLAVOR_IS(gcfMachinekit))
-          gcode << "M2 ; end of program\n";
-    return gcode.str();
+          gcode += "M2 ; end of program\n";
+    return gcode;
 }
 
 std::string GCodeWriter::set_temperature(const int16_t temperature, bool wait, int tool)
@@ -173,31 +169,30 @@ std::string GCodeWriter::set_temperature(const int16_t temperature, bool wait, i
         comment = "set temperature";
     }
     
-    std::ostringstream gcode;
-    gcode << code << " ";
+    std::string gcode = code + " ";
     if (FLAVOR_IS(gcfMach3) || FLAVOR_IS(gcfMachinekit)) {
-        gcode << "P";
+        gcode += "P";
     } else if (FLAVOR_IS(gcfRepRap)) {
-        gcode << "P" << tool << " S";
+        gcode += "P" + std::to_string(tool) + " S";
     } else if (wait && (FLAVOR_IS(gcfMarlinFirmware) || FLAVOR_IS(gcfMarlinLegacy)) && temp_w_offset < m_last_temperature_with_offset) {
-        gcode << "R"; //marlin doesn't wait with S if it's a cooling change, it needs a R
+        gcode += "R"; //marlin doesn't wait with S if it's a cooling change, it needs a R
     } else {
-        gcode << "S";
+        gcode += "S";
     }
-    gcode << temp_w_offset;
+    gcode += std::to_string(temp_w_offset);
     bool multiple_tools = this->multiple_extruders && ! m_single_extruder_multi_material;
     if (tool != -1 && (multiple_tools || FLAVOR_IS(gcfMakerWare) || FLAVOR_IS(gcfSailfish)) && FLAVOR_IS_NOT(gcfRepRap)) {
-        gcode << " T" << tool;
+        gcode += " T" + std::to_string(tool);
     }
-    gcode << " ; " << comment << "\n";
+    gcode += " ; " + comment + "\n";
     
     if ((FLAVOR_IS(gcfTeacup) || FLAVOR_IS(gcfRepRap)) && wait)
-        gcode << "M116 ; wait for temperature to be reached\n";
+        gcode += "M116 ; wait for temperature to be reached\n";
     
     m_last_temperature = temperature;
     m_last_temperature_with_offset = temp_w_offset;
 
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::set_bed_temperature(uint32_t temperature, bool wait)
@@ -221,19 +216,18 @@ std::string GCodeWriter::set_bed_temperature(uint32_t temperature, bool wait)
         comment = "set bed temperature";
     }
     
-    std::ostringstream gcode;
-    gcode << code << " ";
+    std::string gcode = code + " ";
     if (FLAVOR_IS(gcfMach3) || FLAVOR_IS(gcfMachinekit)) {
-        gcode << "P";
+        gcode += "P";
     } else {
-        gcode << "S";
+        gcode += "S";
     }
-    gcode << temperature << " ; " << comment << "\n";
+    gcode += std::to_string(temperature) + " ; " + comment + "\n";
     
     if (FLAVOR_IS(gcfTeacup) && wait)
-        gcode << "M116 ; wait for bed temperature to be reached\n";
+        gcode += "M116 ; wait for bed temperature to be reached\n";
     
-    return gcode.str();
+    return gcode;
 }
 
 
@@ -265,32 +259,35 @@ uint32_t GCodeWriter::get_acceleration() const
 }
 
 std::string GCodeWriter::write_acceleration(){
+    std::string gcode;
+    this->write_acceleration(gcode);
+    return gcode;
+}
+
+void GCodeWriter::write_acceleration(std::string &gcode){
     if (m_current_acceleration == m_last_acceleration || m_current_acceleration == 0)
-        return "";
+        return;
 
     m_last_acceleration = m_current_acceleration;
 
-    std::ostringstream gcode;
 	//try to set only printing acceleration, travel should be untouched if possible
     if (FLAVOR_IS(gcfRepetier)) {
         // M201: Set max printing acceleration
-        gcode << "M201 X" << m_current_acceleration << " Y" << m_current_acceleration;
+        gcode += "M201 X" + std::to_string(m_current_acceleration) + " Y" + std::to_string(m_current_acceleration);
     } else if(FLAVOR_IS(gcfLerdge) || FLAVOR_IS(gcfSprinter)){
         // M204: Set printing acceleration
         // This is new MarlinFirmware with separated print/retraction/travel acceleration.
         // Use M204 P, we don't want to override travel acc by M204 S (which is deprecated anyway).
-        gcode << "M204 P" << m_current_acceleration;
+        gcode += "M204 P" + std::to_string(m_current_acceleration);
     } else if (FLAVOR_IS(gcfMarlinFirmware) || FLAVOR_IS(gcfRepRap)) {
         // M204: Set printing & travel acceleration
-        gcode << "M204 P" << m_current_acceleration << " T" << (m_current_travel_acceleration > 0 ? m_current_travel_acceleration : m_current_acceleration);
+        gcode += "M204 P" + std::to_string(m_current_acceleration) + " T" + std::to_string(m_current_travel_acceleration > 0 ? m_current_travel_acceleration : m_current_acceleration);
     } else { // gcfMarlinLegacy
         // M204: Set default acceleration
-        gcode << "M204 S" << m_current_acceleration;
+        gcode += "M204 S" + std::to_string(m_current_acceleration);
     }
-    if (this->config.gcode_comments) gcode << " ; adjust acceleration";
-    gcode << "\n";
-    
-    return gcode.str();
+    if (this->config.gcode_comments) gcode += " ; adjust acceleration";
+    gcode += "\n";
 }
 
 std::string GCodeWriter::reset_e(bool force)
@@ -307,11 +304,10 @@ std::string GCodeWriter::reset_e(bool force)
     }
 
     if (! m_extrusion_axis.empty() && ! this->config.use_relative_e_distances) {
-        std::ostringstream gcode;
-        gcode << "G92 " << m_extrusion_axis << "0";
-        if (this->config.gcode_comments) gcode << " ; reset extrusion distance";
-        gcode << "\n";
-        return gcode.str();
+        std::string gcode = "G92 " + m_extrusion_axis + "0";
+        if (this->config.gcode_comments) gcode += " ; reset extrusion distance";
+        gcode += "\n";
+        return gcode;
     } else {
         return "";
     }
@@ -325,11 +321,10 @@ std::string GCodeWriter::update_progress(uint32_t num, uint32_t tot, bool allow_
     uint8_t percent = (uint32_t)floor(100.0 * num / tot + 0.5);
     if (!allow_100) percent = std::min(percent, (uint8_t)99);
     
-    std::ostringstream gcode;
-    gcode << "M73 P" << int(percent);
-    if (this->config.gcode_comments) gcode << " ; update progress";
-    gcode << "\n";
-    return gcode.str();
+    std::string gcode = "M73 P" + std::to_string(int(percent));
+    if (this->config.gcode_comments) gcode += " ; update progress";
+    gcode += "\n";
+    return gcode;
 }
 
 std::string GCodeWriter::toolchange_prefix() const
@@ -366,7 +361,7 @@ std::string GCodeWriter::toolchange(uint16_t tool_id)
 
     // return the toolchange command
     // if we are running a single-extruder setup, just set the extruder and return nothing
-    std::ostringstream gcode;
+    std::string gcode;
     if (this->multiple_extruders) {
         if (FLAVOR_IS(gcfKlipper)) {
             //check if we can use the tool_name field or not
@@ -374,40 +369,41 @@ std::string GCodeWriter::toolchange(uint16_t tool_id)
                 // NOTE: this will probably break if there's more than 10 tools, as it's relying on the
                 // ASCII character table.
                 && this->config.tool_name.values[tool_id][0] != static_cast<char>(('0' + tool_id))) {
-                gcode << this->toolchange_prefix() << this->config.tool_name.values[tool_id];
+                gcode += this->toolchange_prefix() + this->config.tool_name.values[tool_id];
             } else {
-                gcode << this->toolchange_prefix() << "extruder";
+                gcode += this->toolchange_prefix() + "extruder";
                 if (tool_id > 0)
-                    gcode << tool_id;
+                    gcode += std::to_string(tool_id);
             }
         } else {
-            gcode << this->toolchange_prefix() << tool_id;
+            gcode += this->toolchange_prefix() + std::to_string(tool_id);
         }
         if (this->config.gcode_comments)
-            gcode << " ; change extruder";
-        gcode << "\n";
-        gcode << this->reset_e(true);
+            gcode += " ; change extruder";
+        gcode += "\n";
+        gcode += this->reset_e(true);
     }
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::set_speed(const double speed, const std::string &comment, const std::string &cooling_marker)
+{
+    std::string gcode;
+    this->set_speed(gcode, speed, comment, cooling_marker);
+    return gcode;
+}
+
+void GCodeWriter::set_speed(std::string &gcode, const double speed, const std::string &comment, const std::string &cooling_marker)
 {
     const double F = speed * 60;
     m_current_speed = speed;
     assert(F > 0.);
     assert(F < 100000.);
-//    GCodeG1Formatter w;
-//    w.emit_f(F);
-//    w.emit_comment(this->config.gcode_comments, comment);
-//    w.emit_string(cooling_marker);
-//    return w.string();
-    std::ostringstream gcode;
-    gcode << "G1 F" << F_NUM(F);
+    gcode += "G1 F";
+    F_NUM(F);
     COMMENT(comment);
-    gcode << cooling_marker;
-    gcode << "\n";
-    return gcode.str();
+    gcode += cooling_marker;
+    gcode += "\n";
 }
 
 double GCodeWriter::get_speed() const
@@ -417,8 +413,14 @@ double GCodeWriter::get_speed() const
 
 std::string GCodeWriter::travel_to_xy(const Vec2d &point, const double speed, const std::string &comment)
 {
-    std::ostringstream gcode;
-    gcode << write_acceleration();
+    std::string gcode;
+    this->travel_to_xy(gcode, point, speed, comment);
+    return gcode;
+}
+
+void GCodeWriter::travel_to_xy(std::string &gcode, const Vec2d &point, const double speed, const std::string &comment)
+{
+    write_acceleration(gcode);
 
     double travel_speed = this->config.travel_speed.value;
     if ((speed > 0) & (speed < travel_speed))
@@ -427,17 +429,14 @@ std::string GCodeWriter::travel_to_xy(const Vec2d &point, const double speed, co
     m_pos.x() = point.x();
     m_pos.y() = point.y();
     
-//    GCodeG1Formatter w;
-//    w.emit_xy(point);
-//    w.emit_f(this->config.travel_speed.value * 60.0);
-//    w.emit_comment(this->config.gcode_comments, comment);
-//    return w.string();
-    gcode << "G1 X" << XYZ_NUM(point.x())
-          <<   " Y" << XYZ_NUM(point.y())
-          <<   " F" << F_NUM(travel_speed * 60);
+    gcode += "G1 X";
+    XYZ_NUM(point.x());
+    gcode += " Y";
+    XYZ_NUM(point.y());
+    gcode += " F";
+    F_NUM(travel_speed * 60);
     COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    gcode += "\n";
 }
 
 std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const double speed, const std::string &comment)
@@ -470,19 +469,22 @@ std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const double speed, c
     if ((speed > 0) & (speed < travel_speed))
         travel_speed = speed;
 
-    std::ostringstream gcode;
-    gcode << write_acceleration();
-    gcode << "G1 X" << XYZ_NUM(point.x())
-          << " Y" << XYZ_NUM(point.y());
+    std::string gcode = write_acceleration();
+    gcode += "G1 X";
+    XYZ_NUM(point.x());
+    gcode += " Y";
+    XYZ_NUM(point.y());
+    gcode += " Z";
     if (config.z_step > SCALING_FACTOR)
-        gcode << " Z" << PRECISION(point.z(), 6);
+        PRECISION(point.z(), 6);
     else
-        gcode << " Z" << XYZ_NUM(point.z());
-    gcode <<   " F" << F_NUM(travel_speed * 60);
+        XYZ_NUM(point.z());
+    gcode += " F";
+    F_NUM(travel_speed * 60);
 
     COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    gcode += "\n";
+    return gcode;
 }
 
 std::string GCodeWriter::travel_to_z(double z, const std::string &comment)
@@ -508,18 +510,19 @@ std::string GCodeWriter::_travel_to_z(double z, const std::string &comment)
 {
     m_pos.z() = z;
 
-    std::ostringstream gcode;
-
-    gcode << write_acceleration();    if (config.z_step > SCALING_FACTOR)
-        gcode << "G1 Z" << PRECISION(z, 6);
+    std::string gcode = write_acceleration();
+    gcode += "G1 Z";
+    if (config.z_step > SCALING_FACTOR)
+        PRECISION(z, 6);
     else
-        gcode << "G1 Z" << XYZ_NUM(z);
+        XYZ_NUM(z);
 
     const double speed = this->config.travel_speed_z.value == 0.0 ? this->config.travel_speed.value : this->config.travel_speed_z.value;
-    gcode <<   " F" << F_NUM(speed * 60.0);
+    gcode += " F";
+    F_NUM(speed * 60.0);
     COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    gcode += "\n";
+    return gcode;
 }
 
 bool GCodeWriter::will_move_z(double z) const
@@ -535,24 +538,41 @@ bool GCodeWriter::will_move_z(double z) const
 }
 
 std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std::string &comment)
+{
+    std::string gcode;
+    this->extrude_to_xy(gcode, point, dE, comment);
+    return gcode;
+}
+
+void GCodeWriter::extrude_to_xy(std::string &gcode, const Vec2d &point, double dE, const std::string &comment)
 {
     assert(dE == dE);
     m_pos.x() = point.x();
     m_pos.y() = point.y();
     bool is_extrude = m_tool->extrude(dE) != 0;
 
-    std::ostringstream gcode;
-    gcode << write_acceleration();
-    gcode << "G1 X" << XYZ_NUM(point.x())
-        << " Y" << XYZ_NUM(point.y());
-    if(is_extrude)
-        gcode <<    " " << m_extrusion_axis << E_NUM(m_tool->E());
+    write_acceleration(gcode);
+    gcode += "G1 X";
+    XYZ_NUM(point.x());
+    gcode += " Y";
+    XYZ_NUM(point.y());
+    if (is_extrude) {
+        gcode += " ";
+        gcode += m_extrusion_axis;
+        E_NUM(m_tool->E());
+    }
     COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    gcode += "\n";
 }
 
 std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment)
+{
+    std::string gcode;
+    this->extrude_to_xyz(gcode, point, dE, comment);
+    return gcode;
+}
+
+void GCodeWriter::extrude_to_xyz(std::string &gcode, const Vec3d &point, double dE, const std::string &comment)
 {
     assert(dE == dE);
     m_pos.x() = point.x();
@@ -560,21 +580,20 @@ std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std
     m_lifted = 0;
     bool is_extrude = m_tool->extrude(dE) != 0;
 
-//    GCodeG1Formatter w;
-//    w.emit_xyz(point);
-//    w.emit_e(m_extrusion_axis, m_extruder->E());
-//    w.emit_comment(this->config.gcode_comments, comment);
-//    return w.string();
-    std::ostringstream gcode;
-    gcode << write_acceleration();
-    gcode << "G1 X" << XYZ_NUM(point.x())
-        << " Y" << XYZ_NUM(point.y())
-        << " Z" << XYZ_NUM(point.z() + m_pos.z());
-    if (is_extrude)
-            gcode <<    " " << m_extrusion_axis << E_NUM(m_tool->E());
+    write_acceleration(gcode);
+    gcode += "G1 X";
+    XYZ_NUM(point.x());
+    gcode += " Y";
+    XYZ_NUM(point.y());
+    gcode += " Z";
+    XYZ_NUM(point.z() + m_pos.z());
+    if (is_extrude) {
+        gcode += " ";
+        gcode += m_extrusion_axis;
+        E_NUM(m_tool->E());
+    }
     COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    gcode += "\n";
 }
 
 std::string GCodeWriter::retract(bool before_wipe)
@@ -612,7 +631,7 @@ std::string GCodeWriter::retract_for_toolchange(bool before_wipe)
 
 std::string GCodeWriter::_retract(double length, double restart_extra, double restart_extra_toolchange, const std::string &comment)
 {
-    std::ostringstream gcode;
+    std::string gcode;
     
     /*  If firmware retraction is enabled, we use a fake value of 1
         since we ignore the actual configured retract_length which 
@@ -635,58 +654,51 @@ std::string GCodeWriter::_retract(double length, double restart_extra, double re
     if (dE != 0) {
         if (this->config.use_firmware_retraction) {
             if (FLAVOR_IS(gcfMachinekit))
-                gcode << "G22 ; retract\n";
+                gcode += "G22 ; retract\n";
             else
-                gcode << "G10 ; retract\n";
+                gcode += "G10 ; retract\n";
         } else if (! m_extrusion_axis.empty()) {
-//            GCodeG1Formatter w;
-//            w.emit_e(m_extrusion_axis, m_extruder->E());
-//            w.emit_f(m_extruder->retract_speed() * 60.);
-//            w.emit_comment(this->config.gcode_comments, comment);
-//            gcode = w.string();
-            gcode << "G1 " << m_extrusion_axis << E_NUM(m_tool->E())
-                           << " F" << F_NUM(m_tool->retract_speed() * 60.);
+            gcode += "G1 " + m_extrusion_axis;
+            E_NUM(m_tool->E());
+            gcode += " F";
+            F_NUM(m_tool->retract_speed() * 60.);
             COMMENT(comment);
-            gcode << "\n";
+            gcode += "\n";
         }
     }
     
     if (FLAVOR_IS(gcfMakerWare))
-        gcode << "M103 ; extruder off\n";
+        gcode += "M103 ; extruder off\n";
     
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::unretract()
 {
-    std::ostringstream gcode;
-//    std::string gcode;
+    std::string gcode;
     
     if (FLAVOR_IS(gcfMakerWare))
-        gcode << "M101 ; extruder on\n";
+        gcode += "M101 ; extruder on\n";
     
     double dE = m_tool->unretract();
     assert(dE >= 0);
     assert(dE < 10000000);
     if (dE != 0) {
         if (this->config.use_firmware_retraction) {
-            gcode << (FLAVOR_IS(gcfMachinekit) ? "G23 ; unretract\n" : "G11 ; unretract\n");
-            gcode << this->reset_e();
+            gcode += (FLAVOR_IS(gcfMachinekit) ? "G23 ; unretract\n" : "G11 ; unretract\n");
+            gcode += this->reset_e();
         } else if (! m_extrusion_axis.empty()) {
             // use G1 instead of G0 because G0 will blend the restart with the previous travel move
-//            GCodeG1Formatter w;
-//            w.emit_e(m_extrusion_axis, m_tool->E());
-//            w.emit_f(m_tool->deretract_speed() * 60.);
-//            w.emit_comment(this->config.gcode_comments, " ; unretract");
-//            gcode += w.string();
-            gcode << "G1 " << m_extrusion_axis << E_NUM(m_tool->E())
-                           << " F" << F_NUM(m_tool->deretract_speed() * 60.);
-            if (this->config.gcode_comments) gcode << " ; unretract";
-            gcode << "\n";
+            gcode += "G1 " + m_extrusion_axis;
+            E_NUM(m_tool->E());
+            gcode += " F";
+            F_NUM(m_tool->deretract_speed() * 60.);
+            if (this->config.gcode_comments) gcode += " ; unretract";
+            gcode += "\n";
         }
     }
     
-    return gcode.str();
+    return gcode;
 }
 
 /*  If this method is called more than once before calling unlift(),
@@ -776,7 +788,7 @@ std::string GCodeWriter::set_fan(const GCodeFlavor gcode_flavor, bool gcode_comm
     }
     return gcode.str();*/
 
-    std::ostringstream gcode;
+    std::string gcode;
 
     //add fan_offset
     int8_t fan_speed = int8_t(std::min(uint8_t(100), speed));
@@ -787,30 +799,31 @@ std::string GCodeWriter::set_fan(const GCodeFlavor gcode_flavor, bool gcode_comm
     // write it
     if (fan_speed == 0) {
         if ((gcfTeacup == gcode_flavor)) {
-            gcode << "M106 S0";
+            gcode += "M106 S0";
         } else if ((gcfMakerWare == gcode_flavor) || (gcfSailfish == gcode_flavor)) {
-            gcode << "M127";
+            gcode += "M127";
         } else {
-            gcode << "M107";
+            gcode += "M107";
         }
-        if (gcode_comments) gcode << " ; disable fan";
-        gcode << "\n";
+        if (gcode_comments) gcode += " ; disable fan";
+        gcode += "\n";
     } else {
         if ((gcfMakerWare == gcode_flavor) || (gcfSailfish == gcode_flavor)) {
-            gcode << "M126 T";
+            gcode += "M126 T";
         } else {
-            gcode << "M106 ";
+            gcode += "M106 ";
             if ((gcfMach3 == gcode_flavor) || (gcfMachinekit == gcode_flavor)) {
-                gcode << "P";
+                gcode += "P";
             } else {
-                gcode << "S";
+                gcode += "S";
             }
-            gcode << (fan_baseline * (fan_speed / 100.0));
+            // default std::ostream precision
+            FLOAT_PRECISION(fan_baseline * (fan_speed / 100.0), 6);
         }
-        if (gcode_comments) gcode << " ; enable fan";
-        gcode << "\n";
+        if (gcode_comments) gcode += " ; enable fan";
+        gcode += "\n";
     }
-    return gcode.str();
+    return gcode;
 }
 
 std::string GCodeWriter::set_fan(const uint8_t speed, uint16_t default_tool)
@@ -820,65 +833,4 @@ std::string GCodeWriter::set_fan(const uint8_t speed, uint16_t default_tool)
     return GCodeWriter::set_fan(this->config.gcode_flavor.value, this->config.gcode_comments.value, speed, tool ? tool->fan_offset() : 0, this->config.fan_percentage.value);
 }
 
-#ifdef USE_GCODEFORMATTER
-void GCodeFormatter::emit_axis(const char axis, const double v, size_t digits) {
-    assert(digits <= 9);
-    static constexpr const std::array<int, 10> pow_10{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
-    *ptr_err.ptr++ = ' '; *ptr_err.ptr++ = axis;
-
-    char *base_ptr = this->ptr_err.ptr;
-    auto  v_int    = int64_t(std::round(v * pow_10[digits]));
-    // Older stdlib on macOS doesn't support std::from_chars at all, so it is used boost::spirit::karma::generate instead of it.
-    // That is a little bit slower than std::to_chars but not much.
-#ifdef __APPLE__
-    boost::spirit::karma::generate(this->ptr_err.ptr, boost::spirit::karma::int_generator<int64_t>(), v_int);
-#else
-    // this->buf_end minus 1 because we need space for adding the extra decimal point.
-    this->ptr_err = std::to_chars(this->ptr_err.ptr, this->buf_end - 1, v_int);
-#endif
-    size_t writen_digits = (this->ptr_err.ptr - base_ptr) - (v_int < 0 ? 1 : 0);
-    if (writen_digits < digits) {
-        // Number is smaller than 10^digits, so that we will pad it with zeros.
-        size_t remaining_digits = digits - writen_digits;
-        // Move all newly inserted chars by remaining_digits to allocate space for padding with zeros.
-        for (char *from_ptr = this->ptr_err.ptr - 1, *to_ptr = from_ptr + remaining_digits; from_ptr >= this->ptr_err.ptr - writen_digits; --to_ptr, --from_ptr)
-            *to_ptr = *from_ptr;
-
-        memset(this->ptr_err.ptr - writen_digits, '0', remaining_digits);
-        this->ptr_err.ptr += remaining_digits;
-    }
-
-    // Move all newly inserted chars by one to allocate space for a decimal point.
-    for (char *to_ptr = this->ptr_err.ptr, *from_ptr = to_ptr - 1; from_ptr >= this->ptr_err.ptr - digits; --to_ptr, --from_ptr)
-        *to_ptr = *from_ptr;
-
-    *(this->ptr_err.ptr - digits) = '.';
-    for (size_t i = 0; i < digits; ++i) {
-        if (*this->ptr_err.ptr != '0')
-            break;
-        this->ptr_err.ptr--;
-    }
-    if (*this->ptr_err.ptr == '.')
-        this->ptr_err.ptr--;
-    if ((this->ptr_err.ptr + 1) == base_ptr || *this->ptr_err.ptr == '-')
-        *(++this->ptr_err.ptr) = '0';
-    this->ptr_err.ptr++;
-
-#if 0 // #ifndef NDEBUG
-    {
-        // Verify that the optimized formatter produces the same result as the standard sprintf().
-        double v1 = atof(std::string(base_ptr, this->ptr_err.ptr).c_str());
-        char buf[2048];
-        sprintf(buf, "%.*lf", int(digits), v);
-        double v2 = atof(buf);
-        // Numbers may differ when rounding at exactly or very close to 0.5 due to numerical issues when scaling the double to an integer.
-        // Thus the complex assert.
-//        assert(v1 == v2);
-        assert(std::abs(v1 - v) * pow_10[digits] < 0.50001);
-        assert(std::abs(v2 - v) * pow_10[digits] < 0.50001);
-    }
-#endif // NDEBUG
-}
-#endif
-
 } // namespace Slic3r
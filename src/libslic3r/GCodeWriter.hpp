@@ -22,6 +22,7 @@ public:
         multiple_extruders(false), m_extrusion_axis("E"), m_tool(nullptr),
         m_single_extruder_multi_material(false),
         m_last_acceleration(0), m_current_acceleration(0), m_current_speed(0),
+        m_last_temperature(0), m_last_temperature_with_offset(0),
         m_last_bed_temperature(0), m_last_bed_temperature_reached(true), 
         m_lifted(0)
         {}
@@ -51,6 +52,7 @@ public:
     void        set_travel_acceleration(uint32_t acceleration);
     uint32_t    get_acceleration() const;
     std::string write_acceleration();
+    void        write_acceleration(std::string &gcode);
     std::string reset_e(bool force = false);
     std::string update_progress(uint32_t num, uint32_t tot, bool allow_100 = false) const;
     // return false if this extruder was already selected
@@ -64,14 +66,19 @@ public:
     std::string toolchange(uint16_t tool_id);
     // in mm/s
     std::string set_speed(const double speed, const std::string &comment = std::string(), const std::string &cooling_marker = std::string());
+    // The overloads taking a gcode buffer append the G-code to the caller's buffer instead of returning a new string.
+    void        set_speed(std::string &gcode, const double speed, const std::string &comment = std::string(), const std::string &cooling_marker = std::string());
     // in mm/s
     double      get_speed() const;
     std::string travel_to_xy(const Vec2d &point, const double speed = 0.0, const std::string &comment = std::string());
+    void        travel_to_xy(std::string &gcode, const Vec2d &point, const double speed = 0.0, const std::string &comment = std::string());
     std::string travel_to_xyz(const Vec3d &point, const double speed = 0.0, const std::string &comment = std::string());
     std::string travel_to_z(double z, const std::string &comment = std::string());
     bool        will_move_z(double z) const;
     std::string extrude_to_xy(const Vec2d &point, double dE, const std::string &comment = std::string());
+    void        extrude_to_xy(std::string &gcode, const Vec2d &point, double dE, const std::string &comment = std::string());
     std::string extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment = std::string());
+    void        extrude_to_xyz(std::string &gcode, const Vec3d &point, double dE, const std::string &comment = std::string());
     std::string retract(bool before_wipe = false);
     std::string retract_for_toolchange(bool before_wipe = false);
     std::string unretract();
@@ -115,102 +122,6 @@ private:
     std::string _retract(double length, double restart_extra, double restart_extra_toolchange, const std::string &comment);
 
 };
-#if 0
-// removed as charconv isn't here in older system like ubuntu 16.04 (cpp 17)
-#include <charconv>
-#define USE_GCODEFORMATTER
-class GCodeFormatter {
-public:
-    GCodeFormatter() {
-        this->buf_end = buf + buflen;
-        this->ptr_err.ptr = this->buf;
-    }
-
-    GCodeFormatter(const GCodeFormatter&) = delete;
-    GCodeFormatter& operator=(const GCodeFormatter&) = delete;
-
-    // At layer height 0.15mm, extrusion width 0.2mm and filament diameter 1.75mm,
-    // the crossection of extrusion is 0.4 * 0.15 = 0.06mm2
-    // and the filament crossection is 1.75^2 = 3.063mm2
-    // thus the filament moves 3.063 / 0.6 = 51x slower than the XY axes
-    // and we need roughly two decimal digits more on extruder than on XY.
-#if 1
-    static constexpr const int XYZF_EXPORT_DIGITS = 3;
-    static constexpr const int E_EXPORT_DIGITS    = 5;
-#else
-    // order of magnitude smaller extrusion rate erros
-    static constexpr const int XYZF_EXPORT_DIGITS = 4;
-    static constexpr const int E_EXPORT_DIGITS    = 6;
-    // excessive accuracy
-//    static constexpr const int XYZF_EXPORT_DIGITS = 6;
-//    static constexpr const int E_EXPORT_DIGITS    = 9;
-#endif
-
-    void emit_axis(const char axis, const double v, size_t digits);
-
-    void emit_xy(const Vec2d &point) {
-        this->emit_axis('X', point.x(), XYZF_EXPORT_DIGITS);
-        this->emit_axis('Y', point.y(), XYZF_EXPORT_DIGITS);
-    }
-
-    void emit_xyz(const Vec3d &point) {
-        this->emit_axis('X', point.x(), XYZF_EXPORT_DIGITS);
-        this->emit_axis('Y', point.y(), XYZF_EXPORT_DIGITS);
-        this->emit_z(point.z());
-    }
-
-    void emit_z(const double z) {
-        this->emit_axis('Z', z, XYZF_EXPORT_DIGITS);
-    }
-
-    void emit_e(const std::string &axis, double v) {
-        if (! axis.empty()) {
-            // not gcfNoExtrusion
-            this->emit_axis(axis[0], v, E_EXPORT_DIGITS);
-        }
-    }
-
-    void emit_f(double speed) {
-        this->emit_axis('F', speed, XYZF_EXPORT_DIGITS);
-    }
-
-    void emit_string(const std::string &s) {
-        strncpy(ptr_err.ptr, s.c_str(), s.size());
-        ptr_err.ptr += s.size();
-    }
-
-    void emit_comment(bool allow_comments, const std::string &comment) {
-        if (allow_comments && ! comment.empty()) {
-            *ptr_err.ptr ++ = ' '; *ptr_err.ptr ++ = ';'; *ptr_err.ptr ++ = ' ';
-            this->emit_string(comment);
-        }
-    }
-
-    std::string string() {
-        *ptr_err.ptr ++ = '\n';
-        return std::string(this->buf, ptr_err.ptr - buf);
-    }
-
-protected:
-    static constexpr const size_t   buflen = 256;
-    char                            buf[buflen];
-    char* buf_end;
-    std::to_chars_result            ptr_err;
-};
-
-class GCodeG1Formatter : public GCodeFormatter {
-public:
-    GCodeG1Formatter() {
-        this->buf[0] = 'G';
-        this->buf[1] = '1';
-        this->buf_end = buf + buflen;
-        this->ptr_err.ptr = this->buf + 2;
-    }
-
-    GCodeG1Formatter(const GCodeG1Formatter&) = delete;
-    GCodeG1Formatter& operator=(const GCodeG1Formatter&) = delete;
-};
-#endif
 
 } /* namespace Slic3r */
 
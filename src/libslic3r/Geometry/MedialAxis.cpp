@@ -5,6 +5,9 @@
 #include "clipper.hpp"
 #include "../ClipperUtils.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 //#ifdef SLIC3R_DEBUG
 //namespace boost { namespace polygon {
 //
@@ -737,31 +740,73 @@ MedialAxis::build(Polylines& polylines)
     polylines.insert(polylines.end(), tp.begin(), tp.end());
 }
 
+void
+MedialAxis::build_all(const ExPolygons& expolygons, const coord_t max_width, const coord_t min_width, const coord_t height, ThickPolylines& polylines_out)
+{
+    if (expolygons.size() < 2) {
+        for (const ExPolygon& expolygon : expolygons)
+            MedialAxis{ expolygon, max_width, min_width, height }.build(polylines_out);
+        return;
+    }
+    // one slot per expolygon, so that the result doesn't depend on the scheduling.
+    std::vector<ThickPolylines> polylines(expolygons.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, expolygons.size()), [&expolygons, &polylines, max_width, min_width, height](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i)
+            MedialAxis{ expolygons[i], max_width, min_width, height }.build(polylines[i]);
+    });
+    size_t count = polylines_out.size();
+    for (const ThickPolylines& pp : polylines)
+        count += pp.size();
+    polylines_out.reserve(count);
+    for (ThickPolylines& pp : polylines)
+        append(polylines_out, std::move(pp));
+}
+
+struct MedialAxis::VoronoiCache {
+    // voronoi_diagram is not assignable, it's held by a pointer to be able to free its memory.
+    std::unique_ptr<VD>                     vd { std::make_unique<VD>() };
+    boost::polygon::default_voronoi_builder builder;
+};
+
+MedialAxis::VoronoiCache&
+MedialAxis::voronoi_cache()
+{
+    // polyline_from_voronoi() doesn't spawn any parallel task, thus the cache of a thread is never used by two calls at once.
+    static thread_local VoronoiCache cache;
+    return cache;
+}
+
 void
 MedialAxis::polyline_from_voronoi(const ExPolygon& voronoi_polygon, ThickPolylines* polylines)
 {
     std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> > thickness;
     Lines lines = voronoi_polygon.lines();
-    VD vd;
+    // reuse the diagram and the builder of the previous calls on this thread instead of allocating new ones for each polygon.
+    VoronoiCache& cache = voronoi_cache();
+    VD& vd = *cache.vd;
+    auto construct = [&cache](const Lines& lines) {
+        cache.vd->clear();
+        cache.builder.clear();
+        boost::polygon::insert(lines.begin(), lines.end(), &cache.builder);
+        cache.builder.construct(cache.vd.get());
+    };
     ExPolygons poly_temp;
     const ExPolygon* poly_to_use = &voronoi_polygon;
-    construct_voronoi(lines.begin(), lines.end(), &vd);
+    construct(lines);
     //use a degraded mode, so it won't slow down too much #2664
      // first simplify from resolution, to see where we are
     if (vd.edges().size() > 20000) {
         poly_temp = poly_to_use->simplify(this->resolution / 2);
         if (poly_temp.size() == 1) poly_to_use = &poly_temp.front();
         lines = poly_to_use->lines();
-        vd.clear();
-        construct_voronoi(lines.begin(), lines.end(), &vd);
+        construct(lines);
     }
     // maybe a second one, and this time, use an adapted resolution
     if (vd.edges().size() > 20000) {
         poly_temp = poly_to_use->simplify(this->resolution * (vd.edges().size() / 40000.));
         if (poly_temp.size() == 1) poly_to_use = &poly_temp.front();
         lines = poly_to_use->lines();
-        vd.clear();
-        construct_voronoi(lines.begin(), lines.end(), &vd);
+        construct(lines);
     }
 
     typedef const VD::edge_type   edge_t;
@@ -876,6 +921,10 @@ MedialAxis::polyline_from_voronoi(const ExPolygon& voronoi_polygon, ThickPolylin
         printf("\n");
     }
 #endif /* SLIC3R_DEBUG */
+
+    // don't keep the memory of a huge diagram for the lifetime of the thread.
+    if (vd.edges().capacity() > 200000)
+        cache.vd = std::make_unique<VD>();
 }
 
 void
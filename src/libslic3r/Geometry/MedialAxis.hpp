@@ -62,6 +62,9 @@ public:
     void build(ThickPolylines& polylines_out);
     /// You shouldn't use this method as it doesn't give you the variable width. Can be useful for debugging.
     void build(Polylines& polylines);
+    /// create the variable-width polylines of each expolygon with the same settings (no bounds, no tapers), for example the gap fill of a whole layer.
+    /// The expolygons are processed in parallel, the polylines are appended to polylines_out in the order of the expolygons.
+    static void build_all(const ExPolygons& expolygons, const coord_t max_width, const coord_t min_width, const coord_t height, ThickPolylines& polylines_out);
 
     /// optional parameter: anchor area in which the extrusion should extends into. Default : expolygon (no bound)
     MedialAxis& use_bounds(const ExPolygon& _bounds) { this->bounds = &_bounds; return *this; }
@@ -105,6 +108,9 @@ private:
         typedef boost::polygon::segment_data<coordinate_type>   segment_type;
         typedef boost::polygon::rectangle_data<coordinate_type> rect_type;
     };
+    /// Voronoi diagram and builder of the calling thread, reused by polyline_from_voronoi() to keep their allocated memory.
+    struct VoronoiCache;
+    static VoronoiCache& voronoi_cache();
     void process_edge_neighbors(const VD::edge_type* edge, ThickPolyline* polyline, std::set<const VD::edge_type*>& edges, std::set<const VD::edge_type*>& valid_edges, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> >& thickness);
     bool validate_edge(const VD::edge_type* edge, Lines& lines, const ExPolygon& expolygon_touse, std::map<const VD::edge_type*, std::pair<coordf_t, coordf_t> >& thickness);
     const Line& retrieve_segment(const VD::cell_type* cell, Lines& lines) const;
@@ -6,6 +6,7 @@
 #include "SVG.hpp"
 #include "BoundingBox.hpp"
 
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 
 namespace Slic3r {
@@ -274,6 +275,155 @@ void Layer::make_perimeters()
     BOOST_LOG_TRIVIAL(trace) << "Generating perimeters for layer " << this->id() << " - Done";
 }
 
+static inline void hash_combine_expolygon(size_t &seed, const ExPolygon &expoly)
+{
+    auto hash_polygon = [&seed](const Polygon &poly) {
+        boost::hash_combine(seed, poly.points.size());
+        for (const Point &pt : poly.points) {
+            boost::hash_combine(seed, pt.x());
+            boost::hash_combine(seed, pt.y());
+        }
+    };
+    hash_polygon(expoly.contour);
+    boost::hash_combine(seed, expoly.holes.size());
+    for (const Polygon &hole : expoly.holes)
+        hash_polygon(hole);
+}
+
+size_t Layer::perimeters_inputs_hash(size_t configs_hash) const
+{
+    size_t seed = configs_hash;
+    boost::hash_combine(seed, m_id);
+    boost::hash_combine(seed, this->height);
+    boost::hash_combine(seed, this->print_z);
+    boost::hash_combine(seed, this->slice_z);
+    boost::hash_combine(seed, m_regions.size());
+    for (const LayerRegion *layerm : m_regions) {
+        // The config of a region without slices does not matter.
+        if (! layerm->slices().empty())
+            boost::hash_combine(seed, layerm->region().config_hash());
+        boost::hash_combine(seed, layerm->slices().surfaces.size());
+        for (const Surface &surface : layerm->slices().surfaces) {
+            boost::hash_combine(seed, int(surface.surface_type));
+            boost::hash_combine(seed, surface.thickness);
+            boost::hash_combine(seed, surface.thickness_layers);
+            boost::hash_combine(seed, surface.bridge_angle);
+            boost::hash_combine(seed, surface.extra_perimeters);
+            boost::hash_combine(seed, surface.maxNbSolidLayersOnTop);
+            // Surface::priority is only used by the infill, it differs between the slices produced by slicing and by restore_untyped_slices().
+            hash_combine_expolygon(seed, surface.expolygon);
+        }
+    }
+    // The perimeter generator detects overhangs and top surfaces from the islands of the neighbor layers.
+    for (const Layer *layer : { this->lower_layer, this->upper_layer }) {
+        boost::hash_combine(seed, layer != nullptr);
+        if (layer != nullptr) {
+            boost::hash_combine(seed, layer->lslices.size());
+            for (const ExPolygon &expoly : layer->lslices)
+                hash_combine_expolygon(seed, expoly);
+        }
+    }
+    // Zero is reserved for "perimeters not generated".
+    return seed == 0 ? 1 : seed;
+}
+
+std::shared_ptr<LayerPerimetersInputs> Layer::perimeters_inputs_snapshot(size_t hash, std::shared_ptr<const PerimetersConfigs> configs) const
+{
+    auto inputs = std::make_shared<LayerPerimetersInputs>();
+    inputs->hash    = hash;
+    inputs->configs = std::move(configs);
+    inputs->id      = m_id;
+    inputs->height  = this->height;
+    inputs->print_z = this->print_z;
+    inputs->slice_z = this->slice_z;
+    inputs->slices.reserve(m_regions.size());
+    for (const LayerRegion *layerm : m_regions)
+        inputs->slices.emplace_back(layerm->slices().surfaces);
+    inputs->has_lower_layer = this->lower_layer != nullptr;
+    inputs->has_upper_layer = this->upper_layer != nullptr;
+    if (this->lower_layer != nullptr)
+        inputs->lower_lslices = this->lower_layer->lslices;
+    if (this->upper_layer != nullptr)
+        inputs->upper_lslices = this->upper_layer->lslices;
+    return inputs;
+}
+
+static inline bool surfaces_equal(const Surfaces &lhs, const Surfaces &rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const Surface &l, const Surface &r) {
+        return l.surface_type == r.surface_type && l.thickness == r.thickness && l.thickness_layers == r.thickness_layers &&
+               l.bridge_angle == r.bridge_angle && l.extra_perimeters == r.extra_perimeters &&
+               l.maxNbSolidLayersOnTop == r.maxNbSolidLayersOnTop && l.expolygon == r.expolygon;
+    });
+}
+
+bool Layer::perimeters_inputs_equal(const LayerPerimetersInputs &inputs) const
+{
+    if (inputs.id != m_id || inputs.height != this->height || inputs.print_z != this->print_z || inputs.slice_z != this->slice_z ||
+        inputs.slices.size() != m_regions.size() ||
+        inputs.has_lower_layer != (this->lower_layer != nullptr) || inputs.has_upper_layer != (this->upper_layer != nullptr))
+        return false;
+    for (size_t region_id = 0; region_id < m_regions.size(); ++ region_id) {
+        const Surfaces &slices = m_regions[region_id]->slices().surfaces;
+        if (! surfaces_equal(inputs.slices[region_id], slices) ||
+            (! slices.empty() && (region_id >= inputs.configs->regions.size() || ! (inputs.configs->regions[region_id] == m_regions[region_id]->region().config()))))
+            return false;
+    }
+    return (this->lower_layer == nullptr || inputs.lower_lslices == this->lower_layer->lslices) &&
+           (this->upper_layer == nullptr || inputs.upper_lslices == this->upper_layer->lslices);
+}
+
+void Layer::store_perimeters_inputs(std::shared_ptr<const LayerPerimetersInputs> inputs)
+{
+    for (LayerRegion *layerm : m_regions)
+        layerm->perimeters_fill_surfaces = layerm->fill_surfaces;
+    this->perimeters_inputs = std::move(inputs);
+}
+
+void Layer::restore_perimeters()
+{
+    for (LayerRegion *layerm : m_regions) {
+        if (layerm->slices().empty()) {
+            // Same as make_perimeters() does.
+            layerm->perimeters.clear();
+            layerm->fills.clear();
+            layerm->ironings.clear();
+            layerm->thin_fills.clear();
+        }
+        layerm->fill_surfaces = layerm->perimeters_fill_surfaces;
+    }
+}
+
+void Layer::reuse_perimeters(Layer &other)
+{
+    assert(m_regions.size() == other.m_regions.size());
+    for (size_t region_id = 0; region_id < m_regions.size(); ++ region_id) {
+        LayerRegion &layerm = *m_regions[region_id];
+        LayerRegion &other_layerm = *other.m_regions[region_id];
+        layerm.perimeters                 = std::move(other_layerm.perimeters);
+        layerm.thin_fills                 = std::move(other_layerm.thin_fills);
+        layerm.fill_expolygons            = std::move(other_layerm.fill_expolygons);
+        layerm.fill_no_overlap_expolygons = std::move(other_layerm.fill_no_overlap_expolygons);
+        layerm.perimeters_fill_surfaces   = std::move(other_layerm.perimeters_fill_surfaces);
+    }
+    this->restore_perimeters();
+    // The inputs are equal. The other layer's inputs are not modified, as they may be compared by other threads.
+    this->perimeters_inputs = other.perimeters_inputs;
+}
+
+void Layer::release_extrusions()
+{
+    for (LayerRegion *layerm : m_regions) {
+        layerm->perimeters.clear();
+        layerm->thin_fills.clear();
+        layerm->milling.clear();
+        layerm->fills.clear();
+        layerm->ironings.clear();
+    }
+    // The perimeters are gone, they cannot be restored.
+    this->perimeters_inputs.reset();
+}
+
 void Layer::make_milling_post_process() {
     if (this->object()->print()->config().milling_diameter.empty()) return;
 
@@ -6,6 +6,9 @@
 #include "SurfaceCollection.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "ExPolygonCollection.hpp"
+#include "PrintConfig.hpp"
+
+#include <memory>
 
 namespace Slic3r {
 
@@ -20,6 +23,38 @@ namespace FillAdaptive {
     struct Octree;
 };
 
+// Configs the perimeters of the layers of a PrintObject were generated with, see LayerPerimetersInputs.
+struct PerimetersConfigs
+{
+    PrintConfig                     print;
+    PrintObjectConfig               object;
+    // Indexed by the region ID. Only compared for the regions with slices, see Layer::perimeters_inputs_equal().
+    std::vector<PrintRegionConfig>  regions;
+
+    bool operator==(const PerimetersConfigs &rhs) const { return this->print == rhs.print && this->object == rhs.object && this->regions == rhs.regions; }
+};
+
+// Inputs of Layer::make_perimeters() at the time the perimeters of a layer were generated.
+// Only kept if the perimeters may be reused, see Print::set_reuse_perimeters().
+struct LayerPerimetersInputs
+{
+    // Layer::perimeters_inputs_hash(), to quickly find the candidates for reuse.
+    size_t                                      hash { 0 };
+    // Shared by the layers generated with the same configs.
+    std::shared_ptr<const PerimetersConfigs>    configs;
+    size_t                                      id { 0 };
+    coordf_t                                    height { 0 };
+    coordf_t                                    print_z { 0 };
+    coordf_t                                    slice_z { 0 };
+    // Slices of the layer regions, indexed by the region ID.
+    std::vector<Surfaces>                       slices;
+    // Islands of the neighbor layers, used by the perimeter generator to detect overhangs and top surfaces.
+    bool                                        has_lower_layer { false };
+    bool                                        has_upper_layer { false };
+    ExPolygons                                  lower_lslices;
+    ExPolygons                                  upper_lslices;
+};
+
 class LayerRegion
 {
 public:
@@ -49,6 +84,9 @@ public:
     ExPolygons                  fill_no_overlap_expolygons;
     // collection of surfaces for infill generation
     SurfaceCollection           fill_surfaces;
+    // fill_surfaces as generated by the perimeter generator, before being modified by PrintObject::prepare_infill().
+    // Used to restore fill_surfaces if the perimeters of this layer are reused, see Layer::perimeters_inputs.
+    SurfaceCollection           perimeters_fill_surfaces;
 
     // collection of expolygons representing the bridged areas (thus not
     // needing support material)
@@ -134,6 +172,9 @@ public:
     ExPolygons 				 lslices;
     std::vector<BoundingBox> lslices_bboxes;
 
+    // Inputs of the perimeters of this layer, null if they were not generated or if they shall not be reused.
+    std::shared_ptr<const LayerPerimetersInputs> perimeters_inputs;
+
     size_t                  region_count() const { return m_regions.size(); }
     const LayerRegion*      get_region(size_t idx) const { return m_regions[idx]; }
     LayerRegion*            get_region(size_t idx) { return m_regions[idx]; }
@@ -151,6 +192,22 @@ public:
     // Slices merged into islands, to be used by the elephant foot compensation to trim the individual surfaces with the shrunk merged slices.
     ExPolygons              merged(float offset) const;
     void                    make_perimeters();
+    // Hash of all the inputs of make_perimeters(): the region slices, the lslices of the neighbor layers, the layer Z
+    // and the region configs. configs_hash shall cover the print and object configs.
+    size_t                  perimeters_inputs_hash(size_t configs_hash) const;
+    // Copy of the current inputs of make_perimeters() except for the configs.
+    std::shared_ptr<LayerPerimetersInputs> perimeters_inputs_snapshot(size_t hash, std::shared_ptr<const PerimetersConfigs> configs) const;
+    // Compare the current inputs of make_perimeters() with a snapshot, including the configs of the regions with slices,
+    // except for the print and object configs.
+    bool                    perimeters_inputs_equal(const LayerPerimetersInputs &inputs) const;
+    // To be called after make_perimeters() to allow the perimeters to be reused.
+    void                    store_perimeters_inputs(std::shared_ptr<const LayerPerimetersInputs> inputs);
+    // Restore the state produced by the last make_perimeters() call, for a layer with unchanged perimeters_inputs.
+    void                    restore_perimeters();
+    // Take over the perimeters generated for another layer with equal perimeters_inputs.
+    void                    reuse_perimeters(Layer &other);
+    // Free the extrusions once the G-code of the layer was generated, see Print::set_release_layers_on_export().
+    void                    release_extrusions();
     void                    make_milling_post_process();
     // Phony version of make_fills() without parameters for Perl integration only.
     void                    make_fills() { this->make_fills(nullptr, nullptr); }
@@ -1,8 +1,10 @@
 #include "LocalesUtils.hpp"
 
-#ifdef _WIN32
+#if __has_include(<charconv>)
     #include <charconv>
+    #include <utility>
 #endif
+#include <cmath>
 #include <stdexcept>
 #include <sstream>
 
@@ -61,41 +63,75 @@ double string_to_double_decimal_point(const std::string_view str, size_t* pos /*
     return out;
 }
 
-std::string to_string_nozero(double value, int32_t max_precision) {
+#if __has_include(<charconv>)
+    template <typename T, typename = void>
+    struct is_to_chars_convertible : std::false_type {};
+    template <typename T>
+    struct is_to_chars_convertible<T, std::void_t<decltype(std::to_chars(std::declval<char*>(), std::declval<char*>(), std::declval<T>(), std::chars_format::fixed, 0))>> : std::true_type {};
+#endif
+
+// Append the value printed as printf("%.*f") if fixed, as printf("%.*g") otherwise.
+template<typename T>
+static inline void append_float(std::string &out, T value, bool fixed, int precision)
+{
+#if __has_include(<charconv>)
+    // Visual Studio and GCC 11+ support to_chars for floating point numbers, OSX compiler that we use only implements it for ints.
+    if constexpr (is_to_chars_convertible<T>::value) {
+        char buf[128];
+        auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value, fixed ? std::chars_format::fixed : std::chars_format::general, precision);
+        if (ec == std::errc()) {
+            out.append(buf, ptr - buf);
+            return;
+        }
+    }
+#endif
+    // Legacy conversion through a stream, which is costly.
+    std::ostringstream ss;
+    if (fixed)
+        ss << std::fixed;
+    ss << std::setprecision(precision) << value;
+    out += ss.str();
+}
+
+void append_nozero(std::string &out, double value, int32_t max_precision)
+{
     double intpart;
     if (modf(value, &intpart) == 0.0) {
-        //shortcut for int
-        return boost::lexical_cast<std::string>(intpart);
+        //shortcut for int, printed as boost::lexical_cast<std::string> would (max_digits10)
+        append_float(out, intpart, false, 17);
     } else {
-        std::stringstream ss;
         //first, get the int part, to see how many digit it takes
         int long10 = 0;
         if (intpart > 9)
             long10 = (int)std::floor(std::log10(std::abs(intpart)));
         //set the usable precision: there is only 15-16 decimal digit in a double
-        ss << std::fixed << std::setprecision(int(std::min(15 - long10, int(max_precision)))) << value;
-        std::string ret = ss.str();
-        uint8_t nb_del = 0;
-        if (ret.find('.') != std::string::npos) {
-            uint8_t idx_char;
-            for (idx_char = uint8_t(ss.tellp()) - 1; idx_char > 0; idx_char--) {
-                if (ret[idx_char] == '0')
-                    nb_del++;
-                else
-                    break;
-            }
+        const size_t start = out.size();
+        append_float(out, value, true, int(std::min(15 - long10, int(max_precision))));
+        if (out.find('.', start) != std::string::npos) {
+            // remove the trailing zeros
+            size_t end = out.size();
+            while (end > start + 1 && out[end - 1] == '0')
+                --end;
             // remove the '.' at the end of the int
-            if (idx_char > 0 && ret[idx_char] == '.')
-                nb_del++;
+            if (end > start + 1 && out[end - 1] == '.')
+                --end;
+            out.resize(end);
         }
-
-        if (nb_del > 0)
-            return ret.substr(0, ret.size() - nb_del);
-        else
-            return ret;
     }
 }
 
+void append_defaultfloat(std::string &out, double value, int precision)
+{
+    append_float(out, value, false, precision);
+}
+
+std::string to_string_nozero(double value, int32_t max_precision)
+{
+    std::string out;
+    append_nozero(out, value, max_precision);
+    return out;
+}
+
 std::string float_to_string_decimal_point(double value, int precision/* = -1*/)
 {
     // merill: this fail on 'float_to_string_decimal_point(0.2)' because the 0.2 is a 0.200000001 (from a float->double conversion probably)
@@ -35,7 +35,14 @@ private:
 bool is_decimal_separator_point();
 
 
+// Print the value with at most max_precision decimals (and no more than the ~15 significant digits a double holds),
+// without the trailing zeros.
 std::string to_string_nozero(double value, int32_t max_precision);
+// Same as to_string_nozero(), but appending to the output buffer. If std::to_chars() supports floating point numbers,
+// no temporary string nor locale dependent stream is involved.
+void append_nozero(std::string &out, double value, int32_t max_precision);
+// Append the value as printed by a std::ostream in the std::defaultfloat mode with the given precision (printf "%.*g").
+void append_defaultfloat(std::string &out, double value, int precision);
 
 // A substitute for std::to_string that works according to
 // C++ locales, not C locale. Meant to be used when we need
@@ -547,36 +547,41 @@ void PerimeterGenerator::process()
                     // compute next onion
                         // the minimum thickness of a single loop is:
                         // ext_width/2 + ext_spacing/2 + spacing/2 + width/2
+                    // The shrink / grow / mask chain runs on a single Clipper engine, without converting the intermediate results to ExPolygons.
+                    ClipperBatch next_onion_batch(last);
                     if (thin_perimeter > 0.98) {
-                        next_onion = offset_ex(
-                            last,
+                        next_onion_batch.offset(
                             -(float)(ext_perimeter_width / 2),
                             ClipperLib::JoinType::jtMiter,
                             3);
                     } else if (thin_perimeter > 0.01) {
-                        next_onion = offset2_ex(
-                            last,
+                        next_onion_batch.offset(
                             -(float)(ext_perimeter_width / 2 + (1 - thin_perimeter) * ext_perimeter_spacing / 2 - 1),
+                            ClipperLib::JoinType::jtMiter,
+                            3)
+                        .offset(
                             +(float)((1 - thin_perimeter) * ext_perimeter_spacing / 2 - 1),
                             ClipperLib::JoinType::jtMiter,
                             3);
                     } else {
-                        next_onion = offset2_ex(
-                            last,
+                        next_onion_batch.offset(
                             -(float)(ext_perimeter_width / 2 + ext_perimeter_spacing / 2 - 1),
+                            ClipperLib::JoinType::jtMiter,
+                            3)
+                        .offset(
                             +(float)(ext_perimeter_spacing / 2 + 1),
                             ClipperLib::JoinType::jtMiter,
                             3);
                     }
                     if (thin_perimeter < 0.7) {
                         //offset2_ex can create artifacts, if too big. see superslicer#2428
-                        next_onion = intersection_ex(next_onion,
-                            offset_ex(
-                                last,
+                        next_onion_batch.intersection(
+                            ClipperBatch(last).offset(
                                 -(float)(ext_perimeter_width / 2),
                                 ClipperLib::JoinType::jtMiter,
                                 3));
                     }
+                    next_onion = next_onion_batch.expolygons();
 
 
                     // look for thin walls
@@ -652,23 +657,32 @@ void PerimeterGenerator::process()
                         // it's a bit like re-add thin area into perimeter area.
                         // it can over-extrude a bit, but it's for a better good.
                         {
+                            ClipperBatch thick_batch(last);
+                            thick_batch.diff(thins, ApplySafetyOffset::Yes);
                             if (thin_perimeter > 0.98)
-                                next_onion = union_ex(next_onion, offset_ex(diff_ex(last, thins, ApplySafetyOffset::Yes),
+                                thick_batch.offset(
                                     -(float)(ext_perimeter_width / 2),
                                     ClipperLib::JoinType::jtMiter,
-                                    3));
+                                    3);
                             else if (thin_perimeter > 0.01)
-                                next_onion = union_ex(next_onion, offset2_ex(diff_ex(last, thins, ApplySafetyOffset::Yes),
+                                thick_batch.offset(
                                     -(float)((ext_perimeter_width / 2) + ((1 - thin_perimeter) * ext_perimeter_spacing / 4)),
+                                    ClipperLib::JoinType::jtMiter,
+                                    3)
+                                .offset(
                                     (float)((1 - thin_perimeter) * ext_perimeter_spacing / 4),
                                     ClipperLib::JoinType::jtMiter,
-                                    3));
+                                    3);
                             else
-                                next_onion = union_ex(next_onion, offset2_ex(diff_ex(last, thins, ApplySafetyOffset::Yes),
+                                thick_batch.offset(
                                     -(float)((ext_perimeter_width / 2) + (ext_perimeter_spacing / 4)),
+                                    ClipperLib::JoinType::jtMiter,
+                                    3)
+                                .offset(
                                     (float)(ext_perimeter_spacing / 4),
                                     ClipperLib::JoinType::jtMiter,
-                                    3));
+                                    3);
+                            next_onion = thick_batch.union_(next_onion).expolygons();
                             //simplify the loop to avoid almost-0 segments
                             resolution = get_resolution(1, false, &surface);
                             ExPolygons next_onion_temp;
@@ -693,11 +707,14 @@ void PerimeterGenerator::process()
                         // reliable gap fill algorithm.
                         // Also the offset2(perimeter, -x, x) may sometimes lead to a perimeter, which is larger than
                         // the original.
-                        next_onion = offset2_ex(last,
-                            -(float)(good_spacing + (1 - thin_perimeter) * perimeter_spacing / 2 - 1),
-                            +(float)((1 - thin_perimeter) * perimeter_spacing / 2 - 1),
-                            (round_peri ? ClipperLib::JoinType::jtRound : ClipperLib::JoinType::jtMiter),
-                            (round_peri ? min_round_spacing : 3));
+                        next_onion = ClipperBatch(last)
+                            .offset(-(float)(good_spacing + (1 - thin_perimeter) * perimeter_spacing / 2 - 1),
+                                (round_peri ? ClipperLib::JoinType::jtRound : ClipperLib::JoinType::jtMiter),
+                                (round_peri ? min_round_spacing : 3))
+                            .offset(+(float)((1 - thin_perimeter) * perimeter_spacing / 2 - 1),
+                                (round_peri ? ClipperLib::JoinType::jtRound : ClipperLib::JoinType::jtMiter),
+                                (round_peri ? min_round_spacing : 3))
+                            .expolygons();
                         if (allow_perimeter_anti_hysteresis) {
                             // now try with different min spacing if we fear some hysteresis
                             //TODO, do that for each polygon from last, instead to do for all of them in one go.
@@ -756,15 +773,10 @@ void PerimeterGenerator::process()
                         no_last_gapfill = offset_ex(next_onion, 0.5f * good_spacing + 10,
                             (round_peri ? ClipperLib::JoinType::jtRound : ClipperLib::JoinType::jtMiter),
                             (round_peri ? min_round_spacing : 3));
-                        if (perimeter_idx == 1) {
-                            append(gaps, diff_ex(
-                                offset_ex(last, -0.5f * gap_fill_spacing_external),
-                                no_last_gapfill));  // safety offset
-                        } else {
-                            append(gaps, diff_ex(
-                                offset_ex(last, -0.5f * gap_fill_spacing),
-                                no_last_gapfill));  // safety offset
-                        }
+                        append(gaps, ClipperBatch(last)
+                            .offset(-0.5f * (perimeter_idx == 1 ? gap_fill_spacing_external : gap_fill_spacing))
+                            .diff(no_last_gapfill)  // safety offset
+                            .expolygons());
                     }
                 }
                 //{
@@ -1219,9 +1231,7 @@ void PerimeterGenerator::process()
             }
             // create lines from the area
             ThickPolylines polylines;
-            for (const ExPolygon& ex : gaps_ex) {
-                Geometry::MedialAxis{ ex, coord_t(max * 1.1), coord_t(min), coord_t(this->layer->height) }.build(polylines);
-            }
+            Geometry::MedialAxis::build_all(gaps_ex, coord_t(max * 1.1), coord_t(min), coord_t(this->layer->height), polylines);
             // create extrusion from lines
             if (!polylines.empty()) {
                 this->gap_fill->append(Geometry::thin_variable_width(
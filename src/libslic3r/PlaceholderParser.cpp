@@ -7,6 +7,8 @@
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef _MSC_VER
     #include <stdlib.h>  // provides **_environ
@@ -1623,6 +1625,179 @@ static std::string process_macro(const std::string &templ, client::MyContext &co
     return output;
 }
 
+class PlaceholderParser::CompiledTemplate
+{
+public:
+    enum class SegmentType {
+        // Verbatim text with the escape sequences resolved.
+        Text,
+        // [variable] or the legacy vector indexing [variable_index]
+        LegacyVariable,
+        // [variable[index_variable]]
+        LegacyVectorVariable,
+        // {variable}
+        Variable,
+    };
+    struct Segment {
+        SegmentType type;
+        // Text or the variable name.
+        std::string text;
+        // Name of the index variable of LegacyVectorVariable.
+        std::string index;
+    };
+    std::vector<Segment> segments;
+
+    // Template without any variable, it expands to its text.
+    bool                 constant() const { return segments.empty() || (segments.size() == 1 && segments.front().type == SegmentType::Text); }
+
+    // Expand the template using the same MyContext methods the macro processor calls for these constructs.
+    // Throws if a variable could not be expanded, the caller shall then run the macro processor to format the error message.
+    std::string          evaluate(const client::MyContext &context) const
+    {
+        using Iterator = std::string::const_iterator;
+        std::string out;
+        std::string value;
+        for (const Segment &segment : segments) {
+            boost::iterator_range<Iterator> name(segment.text.begin(), segment.text.end());
+            switch (segment.type) {
+            case SegmentType::Text:
+                out += segment.text;
+                break;
+            case SegmentType::LegacyVariable:
+                client::MyContext::legacy_variable_expansion<Iterator>(&context, name, value);
+                out += value;
+                break;
+            case SegmentType::LegacyVectorVariable:
+            {
+                boost::iterator_range<Iterator> index(segment.index.begin(), segment.index.end());
+                client::MyContext::legacy_variable_expansion2<Iterator>(&context, name, index, value);
+                out += value;
+                break;
+            }
+            case SegmentType::Variable:
+            {
+                client::OptWithPos<Iterator> opt;
+                client::expr<Iterator>       expr;
+                client::MyContext::resolve_variable<Iterator>(&context, name, opt);
+                client::MyContext::scalar_variable_reference<Iterator>(&context, opt, expr);
+                out += expr.to_string();
+                break;
+            }
+            }
+        }
+        return out;
+    }
+};
+
+// Split the template into text and variable references following the macro_processor grammar.
+// Returns null on anything else: expressions, conditions, white spaces inside the brackets or syntax errors.
+static std::unique_ptr<PlaceholderParser::CompiledTemplate> compile_template(const std::string &templ)
+{
+    using CompiledTemplate = PlaceholderParser::CompiledTemplate;
+    static const char *keywords[] = { "and", "digits", "zdigits", "if", "int", "else", "elsif", "endif", "false", "min", "max", "random", "round",
+                                      "not", "or", "true", "exists", "default_double", "default_int", "default_bool", "default_string", "ignore_legacy" };
+    const size_t npos = std::string::npos;
+    // Returns the end of an identifier starting at pos, npos if there is no identifier or it is a keyword.
+    auto identifier = [&templ, npos](size_t pos) {
+        if (pos >= templ.size() || ! (isalpha((unsigned char)templ[pos]) || templ[pos] == '_'))
+            return npos;
+        size_t end = pos + 1;
+        while (end < templ.size() && (isalnum((unsigned char)templ[end]) || templ[end] == '_'))
+            ++ end;
+        for (const char *keyword : keywords)
+            if (templ.compare(pos, end - pos, keyword) == 0)
+                return npos;
+        return end;
+    };
+    auto skip_spaces = [&templ](size_t pos) {
+        while (pos < templ.size() && isspace((unsigned char)templ[pos]))
+            ++ pos;
+        return pos;
+    };
+
+    auto out = std::make_unique<CompiledTemplate>();
+    std::string text;
+    auto add_segment = [&out, &text](CompiledTemplate::SegmentType type, std::string name, std::string index) {
+        if (! text.empty())
+            out->segments.push_back({ CompiledTemplate::SegmentType::Text, std::move(text), {} });
+        text.clear();
+        out->segments.push_back({ type, std::move(name), std::move(index) });
+    };
+    // The macro processor skips white spaces at the start of the template.
+    for (size_t i = skip_spaces(0); i < templ.size();) {
+        unsigned char c = templ[i];
+        if (c == '\\') {
+            // Escape character: escapes '[' and '{', otherwise printed as-is.
+            if (i + 1 < templ.size() && (templ[i + 1] == '[' || templ[i + 1] == '{'))
+                ++ i;
+            text += templ[i ++];
+        } else if (c == '[') {
+            size_t end = identifier(i + 1);
+            if (end == npos || end == templ.size())
+                return nullptr;
+            if (templ[end] == ']') {
+                add_segment(CompiledTemplate::SegmentType::LegacyVariable, templ.substr(i + 1, end - i - 1), {});
+                i = end + 1;
+            } else if (templ[end] == '[') {
+                size_t end_index = identifier(end + 1);
+                if (end_index == npos || end_index + 1 >= templ.size() || templ[end_index] != ']' || templ[end_index + 1] != ']')
+                    return nullptr;
+                add_segment(CompiledTemplate::SegmentType::LegacyVectorVariable, templ.substr(i + 1, end - i - 1), templ.substr(end + 1, end_index - end - 1));
+                i = end_index + 2;
+            } else
+                return nullptr;
+        } else if (c == '{') {
+            size_t begin = skip_spaces(i + 1);
+            size_t end   = identifier(begin);
+            if (end == npos)
+                return nullptr;
+            size_t close = skip_spaces(end);
+            if (close == templ.size() || templ[close] != '}')
+                return nullptr;
+            add_segment(CompiledTemplate::SegmentType::Variable, templ.substr(begin, end - begin), {});
+            i = close + 1;
+        } else {
+            // Copy a single UTF-8 character, validated the same way as by utf8_char_skipper_parser.
+            if ((c & 0xC0) == 0x80)
+                return nullptr;
+            size_t cnt = 0;
+            for (unsigned char mask = 0x80u; c & mask; mask >>= 1)
+                ++ cnt;
+            cnt = (cnt == 0) ? 1 : std::min<size_t>(cnt, 4);
+            if (i + cnt > templ.size())
+                return nullptr;
+            for (size_t j = 2; j < cnt; ++ j)
+                if ((templ[i + j - 1] & 0xC0) != 0x80)
+                    return nullptr;
+            text.append(templ, i, cnt);
+            i += cnt;
+        }
+    }
+    if (! text.empty())
+        out->segments.push_back({ CompiledTemplate::SegmentType::Text, std::move(text), {} });
+    return out;
+}
+
+std::shared_ptr<const PlaceholderParser::CompiledTemplate> PlaceholderParser::compile(const std::string &templ)
+{
+    // Cache of the compiled templates including the ones, which could not be compiled (null).
+    // Custom G-code templates are few, however the cache is flushed if the templates keep changing, for example if they are generated.
+    static std::mutex                                                                  mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>>    cache;
+    static constexpr const size_t                                                      max_cached = 1024;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = cache.find(templ); it != cache.end())
+            return it->second;
+    }
+    std::shared_ptr<const CompiledTemplate> compiled = compile_template(templ);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cache.size() >= max_cached)
+        cache.clear();
+    cache.emplace(templ, compiled);
+    return compiled;
+}
+
 std::string PlaceholderParser::process(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override, ContextData *context_data) const
 {
     client::MyContext context;
@@ -1631,6 +1806,15 @@ std::string PlaceholderParser::process(const std::string &templ, unsigned int cu
     context.config_override     = config_override;
     context.current_extruder_id = current_extruder_id;
     context.context_data        = context_data;
+    if (std::shared_ptr<const CompiledTemplate> compiled = compile(templ); compiled) {
+        if (compiled->constant())
+            return compiled->segments.empty() ? std::string() : compiled->segments.front().text;
+        try {
+            return compiled->evaluate(context);
+        } catch (const std::exception &) {
+            // Let the macro processor report the error.
+        }
+    }
     return process_macro(templ, context);
 }
 
@@ -3,6 +3,7 @@
 
 #include "libslic3r.h"
 #include <map>
+#include <memory>
 #include <random>
 #include <string>
 #include <vector>
@@ -51,8 +52,15 @@ public:
 	const DynamicConfig*	external_config() const  			{ return m_external_config; }
 
     // Fill in the template using a macro processing language.
+    // Templates consisting of just text and variable references are evaluated from their compiled form, see compile().
     // Throws Slic3r::PlaceholderParserError on syntax or runtime error.
     std::string process(const std::string &templ, unsigned int current_extruder_id = 0, const DynamicConfig *config_override = nullptr, ContextData *context = nullptr) const;
+
+    // Template split into verbatim text and variable references, so that it could be expanded without the macro processor.
+    class CompiledTemplate;
+    // Compile a template once, the compiled templates are cached by the template text and shared by all threads.
+    // Returns null if the template contains expressions or conditions, which have to be evaluated by the macro processor.
+    static std::shared_ptr<const CompiledTemplate> compile(const std::string &templ);
     
     // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
     // Throws Slic3r::PlaceholderParserError on syntax or runtime error.
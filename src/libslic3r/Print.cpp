@@ -21,12 +21,17 @@
 
 #include <algorithm>
 #include <limits>
+#include <mutex>
 #include <unordered_set>
 #include <boost/filesystem/path.hpp>
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/regex.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 // Mark string for localization and translate.
 #define L(s) Slic3r::I18N::translate(s)
 
@@ -1035,21 +1040,40 @@ void Print::process()
     name_tbb_thread_pool_threads_set_locale();
     bool something_done = !is_step_done_unguarded(psSkirtBrim);
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
-    for (PrintObject* obj : m_objects) {
-        obj->make_perimeters();
-    }
-    //note: as object seems to be sliced independantly, it's maybe possible to add a tbb parallel_loop with simple partitioner on infill,
-    //  as prepare_infill has some function not // 
-    for (PrintObject* obj : m_objects) {
-        obj->infill();
-    }
-    for (PrintObject* obj : m_objects) {
-        obj->ironing();
-    }
-	this->set_status(50, L("Generating support material"));
-    for (PrintObject* obj : m_objects) {
-        obj->generate_support_material();
-    }
+    // The objects are sliced independently, thus each object runs its chain of steps concurrently with the other objects.
+    // The layers of the object steps are still processed by nested parallel loops, so while the last layers of a step
+    // (or the serial parts of prepare_infill()) keep a few threads busy, the idle threads work on the other objects.
+    // The progress of concurrently processed objects is reported from a single place as the number of finished object steps.
+    m_processing_objects_concurrently = m_objects.size() > 1;
+    ScopeGuard processing_objects_guard([this]() { m_processing_objects_concurrently = false; });
+    const size_t num_object_steps  = 4 * m_objects.size();
+    size_t       object_steps_done = 0;
+    std::mutex   object_steps_mutex;
+    auto         object_step_done  = [this, num_object_steps, &object_steps_done, &object_steps_mutex]() {
+        if (m_processing_objects_concurrently) {
+            // Serialized, so that the reported progress never goes backwards.
+            std::lock_guard<std::mutex> lock(object_steps_mutex);
+            ++ object_steps_done;
+            this->set_status(10 + int(45 * object_steps_done / num_object_steps), L("Processing objects: step %s / %s"),
+                { std::to_string(object_steps_done), std::to_string(num_object_steps) });
+        }
+    };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this, &object_step_done](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx_object = range.begin(); idx_object < range.end(); ++ idx_object)
+            // A thread waiting for the layers of its object must not pick up the steps of another object,
+            // it would block the waiting object until the other object is finished.
+            tbb::this_task_arena::isolate([obj = m_objects[idx_object], &object_step_done]() {
+                obj->make_perimeters();
+                object_step_done();
+                obj->infill();
+                object_step_done();
+                obj->ironing();
+                object_step_done();
+                obj->generate_support_material();
+                object_step_done();
+            });
+    });
+    this->report_peak_memory("objects processing");
     if (this->set_started(psWipeTower)) {
         m_wipe_tower_data.clear();
         m_tool_ordering.clear();
@@ -1186,6 +1210,7 @@ void Print::process()
         this->set_done(psSkirtBrim);
     }
     m_timestamp_last_change = std::time(0);
+    this->report_peak_memory("wipe tower, skirt and brim");
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
     //notify gui that the slicing/preview structs are ready to be drawed
     if (something_done)
@@ -1213,7 +1238,18 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
 
     // The following line may die for multiple reasons.
     GCode gcode;
+    gcode.set_release_layer_extrusions(m_release_layers_on_export);
+    // The extrusions released by the export, even by a failed one, have to be generated again by the next process().
+    ScopeGuard invalidate_released([this]() {
+        if (m_release_layers_on_export)
+            for (PrintObject *object : m_objects) {
+                // PrintObject::invalidate_step() propagates the invalidation to the dependent object and print steps.
+                object->invalidate_step(posPerimeters);
+                object->invalidate_step(posSupportMaterial);
+            }
+    });
     gcode.do_export(this, path.c_str(), result, thumbnail_cb);
+    this->report_peak_memory("G-code export");
     return path.c_str();
 }
 
@@ -23,6 +23,7 @@
 #include <ctime>
 #include <functional>
 #include <set>
+#include <unordered_map>
 
 namespace Slic3r {
 
@@ -354,7 +355,7 @@ protected:
     friend class Print;
 
 	PrintObject(Print* print, ModelObject* model_object, const Transform3d& trafo, PrintInstances&& instances);
-	~PrintObject() { if (m_shared_regions && -- m_shared_regions->m_ref_cnt == 0) delete m_shared_regions; }
+	~PrintObject() { this->clear_perimeters_cache(); if (m_shared_regions && -- m_shared_regions->m_ref_cnt == 0) delete m_shared_regions; }
  
     void                    config_apply(const ConfigBase &other, bool ignore_nonexistent = false) { m_config.apply(other, ignore_nonexistent); }
     void                    config_apply_only(const ConfigBase &other, const t_config_option_keys &keys, bool ignore_nonexistent = false) { m_config.apply_only(other, keys, ignore_nonexistent); }
@@ -380,6 +381,9 @@ private:
     void generate_support_material();
 
     void slice_volumes();
+    // Move the layers with generated perimeters into m_perimeters_cache before reslicing, delete the others.
+    void move_layers_to_perimeters_cache();
+    void clear_perimeters_cache();
     // Has any support (not counting the raft).
     ExPolygons _shrink_contour_holes(double contour_delta, double default_delta, double convex_delta, const ExPolygons& input) const;
     void _transform_hole_to_polyholes();
@@ -426,6 +430,10 @@ private:
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                                    m_typed_slices = false;
 
+    // Layers of the previous slicing with their perimeters, keyed by the hash of their Layer::perimeters_inputs.
+    // make_perimeters() takes over the perimeters of the new layers with unchanged inputs from them,
+    // so that after a local change (a modifier, a painted area) only the affected layers are regenerated.
+    std::unordered_map<size_t, Layer*>      m_perimeters_cache;
 
 };
 
@@ -575,6 +583,14 @@ public:
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
     std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // Streaming export: free the extrusions of each layer as soon as its G-code was generated, so that the memory needed by huge prints
+    // does not grow with the number of layers exported. The export invalidates the object steps producing the extrusions,
+    // thus this mode is meant for a Print discarded or processed again after the export, as done by the command line slicer.
+    void                set_release_layers_on_export(bool release) { m_release_layers_on_export = release; }
+    // Keep a copy of the inputs of the perimeter generator with the perimeters of each layer, so that the perimeters of the layers
+    // with unchanged inputs are reused when the print is processed again. Meant for a Print processed repeatedly, as done by the GUI.
+    void                set_reuse_perimeters(bool reuse) { m_reuse_perimeters = reuse; }
+    bool                reuse_perimeters() const { return m_reuse_perimeters; }
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -673,6 +689,13 @@ private:
     // Return 4 wipe tower corners in the world coordinates (shifted and rotated), including the wipe tower brim.
     std::vector<Point>  first_layer_wipe_tower_corners() const;
 
+    // Status of the PrintObject steps. While multiple objects are processed concurrently, their statuses would interleave
+    // and the progress would jump back and forth, thus it is not reported and process() reports the number of finished object steps instead.
+    void                set_object_status(int percent, const std::string &message, unsigned int flags = SlicingStatus::DEFAULT) const
+        { if (! m_processing_objects_concurrently) this->set_status(percent, message, flags); }
+    void                set_object_status(int percent, const std::string &message, const std::vector<std::string> &args, unsigned int flags = SlicingStatus::DEFAULT) const
+        { if (! m_processing_objects_concurrently) this->set_status(percent, message, args, flags); }
+
     PrintConfig                             m_config;
     PrintObjectConfig                       m_default_object_config;
     PrintRegionConfig                       m_default_region_config;
@@ -699,6 +722,10 @@ private:
     PrintStatistics                         m_print_statistics;
     // tiem of last change, to see if the gui need to be updated
     std::time_t                             m_timestamp_last_change;
+    bool                                    m_release_layers_on_export { false };
+    bool                                    m_reuse_perimeters { false };
+    // Set by process() for the time the PrintObject steps run concurrently, see set_object_status().
+    bool                                    m_processing_objects_concurrently { false };
 
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCode;
@@ -3,10 +3,12 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/log/trivial.hpp>
 
 #include <regex>
 
 #include "I18N.hpp"
+#include "Utils.hpp"
 
 //! macro used to mark string used at localization, 
 //! return same string
@@ -146,6 +148,17 @@ std::string PrintBase::output_filepath(const std::string &path, const std::strin
     return path;
 }
 
+void PrintBase::report_peak_memory(const std::string &stage) const
+{
+    const size_t peak = peak_memory_usage();
+    BOOST_LOG_TRIVIAL(info) << "Peak memory usage after " << stage << ": " << format_memsize_MB(peak);
+    if (m_status_callback) {
+        SlicingStatus status(-1, stage, SlicingStatus::PEAK_MEMORY);
+        status.peak_memory = peak;
+        m_status_callback(status);
+    }
+}
+
 void PrintBase::status_update_warnings(int step, PrintStateBase::WarningLevel /* warning_level */, const std::string &message, const PrintObjectBase* print_object)
 {
     if (this->m_status_callback) {
@@ -166,6 +179,11 @@ std::function<void()> PrintObjectBase::cancel_callback(PrintBase *print)
 	return print->cancel_callback();
 }
 
+void PrintObjectBase::step_event(PrintBase *print, int step, bool done, const PrintObjectBase *print_object)
+{
+    print->step_event(step, done, print_object);
+}
+
 void PrintObjectBase::status_update_warnings(PrintBase *print, int step, PrintStateBase::WarningLevel warning_level, const std::string &message)
 {
     print->status_update_warnings(step, warning_level, message, this);
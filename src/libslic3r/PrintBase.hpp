@@ -312,6 +312,8 @@ protected:
     // Declared here to allow access from PrintBase through friendship.
 	static std::mutex&                  state_mutex(PrintBase *print);
 	static std::function<void()>        cancel_callback(PrintBase *print);
+	// Notify the step callback registered on print, if any, that a step of this PrintObjectBase was started or finished.
+	static void                         step_event(PrintBase *print, int step, bool done, const PrintObjectBase *print_object);
 	// Notify UI about a new warning of a milestone "step" on this PrintObjectBase.
 	// The UI will be notified by calling a status callback registered on print.
 	// If no status callback is registered, the message is printed to console.
@@ -420,7 +422,9 @@ public:
             SLICING_ENDED                       = 1 << 6,
             GCODE_ENDED                         = 1 << 7,
             MAIN_STATE                          = 1 << 8,
-            SECONDARY_STATE                     = 1 << 9
+            SECONDARY_STATE                     = 1 << 9,
+            // Not a progress update: peak_memory holds the peak memory usage of the process at the end of the stage named by main_text.
+            PEAK_MEMORY                         = 1 << 10
         };
         // Bitmap of FlagBits
         unsigned int    flags;
@@ -429,6 +433,8 @@ public:
         ObjectID        warning_object_id;
         // For which Print or PrintObject step a new warning is being issued?
         int             warning_step { -1 };
+        // Peak memory usage of the process in bytes, set with PEAK_MEMORY.
+        size_t          peak_memory { 0 };
     };
     typedef std::function<void(const SlicingStatus&)>  status_callback_type;
     // Default status console print out in the form of percent => message.
@@ -465,12 +471,24 @@ public:
         }
         else printf("%d => %s\n", percent, message.c_str());
     }
+    // Report the peak memory usage of the process at the end of a processing stage to the log and to the status callback.
+    void                    report_peak_memory(const std::string &stage) const;
 
     typedef std::function<void()>  cancel_callback_type;
     // Various methods will call this callback to stop the background processing (the Print::process() call)
     // in case a successive change of the Print / PrintObject / PrintRegion instances changed
     // the state of the finished or running calculations.
     void                       set_cancel_callback(cancel_callback_type cancel_callback) { m_cancel_callback = cancel_callback; }
+    // Milestone "step" of this Print (print_object == nullptr) or of one of its PrintObjects being started or finished.
+    struct StepEvent {
+        const PrintObjectBase  *print_object;
+        int                     step;
+        bool                    done;
+    };
+    typedef std::function<void(const StepEvent&)>  step_callback_type;
+    // Register a callback to be called by the thread executing a step when the step is started and when it is finished.
+    // Only the steps being calculated are reported, not the ones already valid. Used for profiling of the slicing pipeline.
+    void                       set_step_callback(step_callback_type cb) { m_step_callback = cb; }
     // Has the calculation been canceled?
 	enum CancelStatus {
 		// No cancelation, background processing should run.
@@ -512,6 +530,8 @@ protected:
     std::mutex&            state_mutex() const { return m_state_mutex; }
     std::function<void()>  cancel_callback() { return m_cancel_callback; }
 	void				   call_cancel_callback() { m_cancel_callback(); }
+    void                   step_event(int step, bool done, const PrintObjectBase *print_object = nullptr) const
+        { if (m_step_callback) m_step_callback(StepEvent{ print_object, step, done }); }
 	// Notify UI about a new warning of a milestone "step" on this PrintBase.
 	// The UI will be notified by calling a status callback.
 	// If no status callback is registered, the message is printed to console.
@@ -532,6 +552,8 @@ protected:
 
     // Callback to be evoked regularly to update state of the UI thread.
     status_callback_type                    m_status_callback;
+    // Callback to be evoked when a Print or PrintObject step is started or finished.
+    step_callback_type                      m_step_callback;
 
     //for gui status update
     inline static std::chrono::time_point<std::chrono::system_clock>
@@ -561,9 +583,15 @@ public:
     PrintStateBase::StateWithWarnings  step_state_with_warnings(PrintStepEnum step) const { return m_state.state_with_warnings(step, this->state_mutex()); }
 
 protected:
-    bool            set_started(PrintStepEnum step) { return m_state.set_started(step, this->state_mutex(), [this](){ this->throw_if_canceled(); }); }
+    bool            set_started(PrintStepEnum step) {
+        bool started = m_state.set_started(step, this->state_mutex(), [this](){ this->throw_if_canceled(); });
+        if (started)
+            this->step_event(static_cast<int>(step), false);
+        return started;
+    }
 	PrintStateBase::TimeStamp set_done(PrintStepEnum step) { 
 		std::pair<PrintStateBase::TimeStamp, bool> status = m_state.set_done(step, this->state_mutex(), [this](){ this->throw_if_canceled(); });
+        this->step_event(static_cast<int>(step), true);
         if (status.second)
             this->status_update_warnings(static_cast<int>(step), PrintStateBase::WarningLevel::NON_CRITICAL, std::string());
         return status.first;
@@ -609,10 +637,15 @@ public:
 protected:
 	PrintObjectBaseWithState(PrintType *print, ModelObject *model_object) : PrintObjectBase(model_object), m_print(print) {}
 
-    bool            set_started(PrintObjectStepEnum step) 
-        { return m_state.set_started(step, PrintObjectBase::state_mutex(m_print), [this](){ this->throw_if_canceled(); }); }
+    bool            set_started(PrintObjectStepEnum step) {
+        bool started = m_state.set_started(step, PrintObjectBase::state_mutex(m_print), [this](){ this->throw_if_canceled(); });
+        if (started)
+            PrintObjectBase::step_event(m_print, static_cast<int>(step), false, this);
+        return started;
+    }
 	PrintStateBase::TimeStamp set_done(PrintObjectStepEnum step) { 
 		std::pair<PrintStateBase::TimeStamp, bool> status = m_state.set_done(step, PrintObjectBase::state_mutex(m_print), [this](){ this->throw_if_canceled(); });
+        PrintObjectBase::step_event(m_print, static_cast<int>(step), true, this);
         if (status.second)
             this->status_update_warnings(m_print, static_cast<int>(step), PrintStateBase::WarningLevel::NON_CRITICAL, std::string());
         return status.first;
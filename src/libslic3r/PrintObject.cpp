@@ -1,5 +1,6 @@
 #include "Exception.hpp"
 #include "Print.hpp"
+#include "Arena.hpp"
 #include "BoundingBox.hpp"
 #include "ClipperUtils.hpp"
 #include "ElephantFootCompensation.hpp"
@@ -21,6 +22,7 @@
 #include <string_view>
 #include <utility>
 
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 
 #include <tbb/parallel_for.h>
@@ -266,7 +268,7 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
         if (!this->set_started(posPerimeters))
             return;
 
-        m_print->set_status(10, L("Generating perimeters"));
+        m_print->set_object_status(10, L("Generating perimeters"));
         BOOST_LOG_TRIVIAL(info) << "Generating perimeters..." << log_memory_info();
 
         // Revert the typed slices into untyped slices.
@@ -352,42 +354,90 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
             BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
         }
 
+        // Layers with unchanged slices, neighbor islands and configs keep (or take over from the previous slicing) their perimeters.
+        // The candidates are found by a hash of the inputs, then their inputs are compared with the inputs stored with the perimeters.
+        const bool reuse = m_print->reuse_perimeters();
+        size_t configs_hash = 0;
+        std::shared_ptr<const PerimetersConfigs> configs;
+        // Whether the print and object configs stored with the perimeters of the old layers are equal to the current ones,
+        // the region configs are compared per layer. Filled in before the parallel loop, which only reads it.
+        // Usually there is a single stored config.
+        std::unordered_map<const PerimetersConfigs*, bool> configs_unchanged;
+        if (reuse) {
+            configs_hash = m_print->config().hash();
+            boost::hash_combine(configs_hash, m_config.hash());
+            auto new_configs = std::make_shared<PerimetersConfigs>();
+            new_configs->print  = m_print->config();
+            new_configs->object = m_config;
+            new_configs->regions.reserve(this->num_printing_regions());
+            for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id)
+                new_configs->regions.emplace_back(this->printing_region(region_id).config());
+            configs = std::move(new_configs);
+            auto check_configs = [&configs, &configs_unchanged](const Layer *layer) {
+                if (layer->perimeters_inputs) {
+                    const std::shared_ptr<const PerimetersConfigs> &old_configs = layer->perimeters_inputs->configs;
+                    if (configs_unchanged.find(old_configs.get()) == configs_unchanged.end()) {
+                        configs_unchanged.emplace(old_configs.get(), old_configs->print == configs->print && old_configs->object == configs->object);
+                        if (*old_configs == *configs)
+                            // Share a single copy of the configs.
+                            configs = old_configs;
+                    }
+                }
+            };
+            for (const Layer *layer : m_layers)
+                check_configs(layer);
+            for (const auto &kvp : m_perimeters_cache)
+                check_configs(kvp.second);
+        }
+        std::atomic<size_t> num_reused{ 0 };
+        // The milling post-process of a layer depends just on the layer itself, it's generated right after its perimeters.
+        const bool milling = ! print()->config().milling_diameter.empty();
+
         BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this, &atomic_count, nb_layers_update](const tbb::blocked_range<size_t>& range) {
+            [this, &atomic_count, nb_layers_update, reuse, configs_hash, &configs, &configs_unchanged, &num_reused, milling](const tbb::blocked_range<size_t>& range) {
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
                 std::chrono::time_point<std::chrono::system_clock> start_make_perimeter = std::chrono::system_clock::now();
                 m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
+                Layer *layer = m_layers[layer_idx];
+                const size_t hash = reuse ? layer->perimeters_inputs_hash(configs_hash) : 0;
+                // Only reuse perimeters generated from inputs equal to the current ones, a hash match alone is not enough.
+                auto can_reuse = [layer, hash, &configs_unchanged](const Layer &other) {
+                    const LayerPerimetersInputs *inputs = other.perimeters_inputs.get();
+                    return inputs != nullptr && inputs->hash == hash && configs_unchanged.at(inputs->configs.get()) && layer->perimeters_inputs_equal(*inputs);
+                };
+                decltype(m_perimeters_cache)::const_iterator it_cached;
+                if (reuse && can_reuse(*layer)) {
+                    layer->restore_perimeters();
+                    ++ num_reused;
+                } else if (reuse && (it_cached = m_perimeters_cache.find(hash)) != m_perimeters_cache.end() && can_reuse(*it_cached->second)) {
+                    layer->reuse_perimeters(*it_cached->second);
+                    ++ num_reused;
+                } else {
+                    // Snapshot the inputs before make_perimeters() modifies the layer.
+                    std::shared_ptr<LayerPerimetersInputs> inputs = reuse ? layer->perimeters_inputs_snapshot(hash, configs) : nullptr;
+                    layer->perimeters_inputs.reset();
+                    layer->make_perimeters();
+                    if (reuse)
+                        layer->store_perimeters_inputs(std::move(inputs));
+                }
+                if (milling)
+                    layer->make_milling_post_process();
 
                 // updating progress
                 int nb_layers_done = (++atomic_count);
                 std::chrono::time_point<std::chrono::system_clock> end_make_perimeter = std::chrono::system_clock::now();
                 if (nb_layers_done % nb_layers_update == 0 || (static_cast<std::chrono::duration<double>>(end_make_perimeter - start_make_perimeter)).count() > 5) {
-                    m_print->set_status( int((nb_layers_done * 100) / m_layers.size()), L("Generating perimeters: layer %s / %s"), { std::to_string(nb_layers_done), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+                    m_print->set_object_status( int((nb_layers_done * 100) / m_layers.size()), L("Generating perimeters: layer %s / %s"), { std::to_string(nb_layers_done), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
                 }
             }
         }
         );
-        m_print->set_status(100, "", PrintBase::SlicingStatus::SECONDARY_STATE);
+        m_print->set_object_status(100, "", PrintBase::SlicingStatus::SECONDARY_STATE);
         m_print->throw_if_canceled();
-        BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
-
-        if (print()->config().milling_diameter.size() > 0) {
-            BOOST_LOG_TRIVIAL(debug) << "Generating milling post-process in parallel - start";
-            tbb::parallel_for(
-                tbb::blocked_range<size_t>(0, m_layers.size()),
-                [this](const tbb::blocked_range<size_t>& range) {
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
-                    m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_milling_post_process();
-                }
-            }
-            );
-            m_print->throw_if_canceled();
-            BOOST_LOG_TRIVIAL(debug) << "Generating milling post-process in parallel - end";
-        }
+        this->clear_perimeters_cache();
+        BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end, " << num_reused << " of " << m_layers.size() << " layers reused";
 
         this->set_done(posPerimeters);
     }
@@ -397,7 +447,7 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
         if (!this->set_started(posPrepareInfill))
             return;
 
-        m_print->set_status(25, L("Preparing infill"));
+        m_print->set_object_status(25, L("Preparing infill"));
 
     if (m_typed_slices) {
         // To improve robustness of detect_surfaces_type() when reslicing (working with typed slices), see GH issue #7442.
@@ -548,8 +598,8 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
         // prerequisites
         this->prepare_infill();
 
-        m_print->set_status(40, L("Infilling layers"));
-        m_print->set_status(0, L("Infilling layer %s / %s"), { std::to_string(0), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+        m_print->set_object_status(40, L("Infilling layers"));
+        m_print->set_object_status(0, L("Infilling layer %s / %s"), { std::to_string(0), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
         if (this->set_started(posInfill)) {
             auto [adaptive_fill_octree, support_fill_octree] = this->prepare_adaptive_infill_data();
 
@@ -564,18 +614,22 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
                     std::chrono::time_point<std::chrono::system_clock> start_make_fill = std::chrono::system_clock::now();
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get());
+                    {
+                        // Temporaries of the infill generators are released at once at the end of the layer.
+                        ArenaScope arena_scope;
+                        m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get());
+                    }
 
                     // updating progress
                     int nb_layers_done = (++atomic_count);
                     std::chrono::time_point<std::chrono::system_clock> end_make_fill = std::chrono::system_clock::now();
                     if (nb_layers_done % nb_layers_update == 0 || (static_cast<std::chrono::duration<double>>(end_make_fill - start_make_fill)).count() > 5) {
-                        m_print->set_status( int((nb_layers_done * 100) / m_layers.size()), L("Infilling layer %s / %s"), { std::to_string(nb_layers_done), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+                        m_print->set_object_status( int((nb_layers_done * 100) / m_layers.size()), L("Infilling layer %s / %s"), { std::to_string(nb_layers_done), std::to_string(m_layers.size()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
                     }
                 }
             }
             );
-            m_print->set_status(100, "", PrintBase::SlicingStatus::SECONDARY_STATE);
+            m_print->set_object_status(100, "", PrintBase::SlicingStatus::SECONDARY_STATE);
             //for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx) {
             //    m_print->throw_if_canceled();
             //    m_layers[layer_idx]->make_fills();
@@ -612,6 +666,7 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
     void PrintObject::generate_support_material()
     {
         if (this->set_started(posSupportMaterial)) {
+            m_print->set_object_status(50, L("Generating support material"));
             this->clear_support_layers();
         if ((this->has_support() && m_layers.size() > 1) || (this->has_raft() && ! m_layers.empty())) {
                 this->_generate_support_material();
@@ -675,6 +730,38 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
         m_layers.clear();
     }
 
+    void PrintObject::move_layers_to_perimeters_cache()
+    {
+        this->clear_perimeters_cache();
+        for (Layer *layer : m_layers) {
+            if (! layer->perimeters_inputs || ! m_perimeters_cache.emplace(layer->perimeters_inputs->hash, layer).second) {
+                delete layer;
+                continue;
+            }
+            // Only keep what Layer::reuse_perimeters() takes over.
+            layer->lower_layer = layer->upper_layer = nullptr;
+            layer->lslices.clear();
+            layer->lslices_bboxes.clear();
+            for (LayerRegion *layerm : layer->m_regions) {
+                layerm->m_slices.clear();
+                layerm->raw_slices.clear();
+                layerm->fill_surfaces.clear();
+                layerm->unsupported_bridge_edges.clear();
+                layerm->milling.clear();
+                layerm->fills.clear();
+                layerm->ironings.clear();
+            }
+        }
+        m_layers.clear();
+    }
+
+    void PrintObject::clear_perimeters_cache()
+    {
+        for (auto &kvp : m_perimeters_cache)
+            delete kvp.second;
+        m_perimeters_cache.clear();
+    }
+
     Layer* PrintObject::add_layer(int id, coordf_t height, coordf_t print_z, coordf_t slice_z)
     {
         m_layers.emplace_back(new Layer(id, this, height, print_z, slice_z));
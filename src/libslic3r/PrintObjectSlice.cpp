@@ -4,6 +4,7 @@
 #include "MultiMaterialSegmentation.hpp"
 #include "Print.hpp"
 #include "ClipperUtils.hpp"
+#include "SliceCache.hpp"
 
 #include <boost/log/trivial.hpp>
 
@@ -429,6 +430,74 @@ static std::vector<std::vector<ExPolygons>> slices_to_regions(
     return slices_by_region;
 }
 
+// Key of the slices_to_regions() result in the SliceCache.
+// Holds everything slice_volumes_inner() and slices_to_regions() depend on, but only the few config options they read,
+// so that the cached slices are shared by the print profiles differing in non-slicing options.
+static SliceCache::Key slice_cache_key(const PrintObject &print_object, const std::vector<float> &zs)
+{
+    const PrintConfig        &print_config  = print_object.print()->config();
+    const PrintObjectConfig  &object_config = print_object.config();
+    const PrintObjectRegions &regions       = *print_object.shared_regions();
+    ModelVolumePtrs           model_volumes = print_object.model_object()->volumes;
+    model_volumes_sort_by_id(model_volumes);
+
+    SliceCache::Key key;
+    auto add_matrix = [&key](const Transform3d &trafo) {
+        key.add(trafo.matrix().data(), 16 * sizeof(double));
+    };
+    for (const ConfigOption *opt : std::initializer_list<const ConfigOption*>{
+            &print_config.resolution, &print_config.spiral_vase,
+            &object_config.slice_closing_radius, &object_config.model_precision, &object_config.slicing_mode,
+            &object_config.xy_size_compensation, &object_config.xy_inner_size_compensation, &object_config.hole_size_compensation,
+            &object_config.clip_multipart_objects })
+        key.add(opt->serialize());
+    key.add(print_config.nozzle_diameter.size());
+    add_matrix(print_object.trafo_centered());
+    key.add(zs.size());
+    key.add(zs.data(), zs.size() * sizeof(float));
+    // Volumes in the order they are sliced. Their IDs differ between runs, their indices do not.
+    key.add(model_volumes.size());
+    for (const ModelVolume *model_volume : model_volumes) {
+        key.add(int(model_volume->type()));
+        key.add(model_volume->is_mm_painted());
+        add_matrix(model_volume->get_matrix());
+        const indexed_triangle_set &its = model_volume->mesh().its;
+        key.add(its.vertices.size());
+        key.add(its.vertices.data(), its.vertices.size() * sizeof(stl_vertex));
+        key.add(its.indices.size());
+        key.add(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+    }
+    auto volume_idx = [&model_volumes](const ModelVolume *model_volume) {
+        return int64_t(std::find(model_volumes.begin(), model_volumes.end(), model_volume) - model_volumes.begin());
+    };
+    // Assignment of the volumes to the regions.
+    key.add(regions.all_regions.size());
+    key.add(regions.layer_ranges.size());
+    for (const PrintObjectRegions::LayerRangeRegions &layer_range : regions.layer_ranges) {
+        key.add(layer_range.layer_height_range.first);
+        key.add(layer_range.layer_height_range.second);
+        key.add(layer_range.volume_regions.size());
+        for (const PrintObjectRegions::VolumeRegion &volume_region : layer_range.volume_regions) {
+            key.add(volume_idx(volume_region.model_volume));
+            key.add(volume_region.parent);
+            key.add(volume_region.region ? volume_region.region->print_object_region_id() : -1);
+        }
+    }
+    // Region options read by slice_volumes_inner() and slices_to_regions().
+    for (const std::unique_ptr<PrintRegion> &region : regions.all_regions) {
+        key.add(bool(region));
+        if (! region)
+            continue;
+        const size_t extruder_id = region->extruder(FlowRole::frPerimeter, print_object) - 1;
+        key.add(print_config.filament_shrink.get_abs_value(extruder_id, 1));
+        if (print_config.spiral_vase) {
+            key.add(region->config().bottom_solid_layers.value);
+            key.add(region->config().bottom_solid_min_thickness.value);
+        }
+    }
+    return key;
+}
+
 std::string fix_slicing_errors(LayerPtrs &layers, const std::function<void()> &throw_if_canceled)
 {
     // Collect layers with slicing errors.
@@ -525,12 +594,13 @@ void PrintObject::slice()
 {
     if (! this->set_started(posSlice))
         return;
-    m_print->set_status(0, L("Processing triangulated mesh"));
+    m_print->set_object_status(0, L("Processing triangulated mesh"));
     std::vector<coordf_t> layer_height_profile;
     this->update_layer_height_profile(*this->model_object(), *m_slicing_params, layer_height_profile);
     m_print->throw_if_canceled();
     m_typed_slices = false;
-    this->clear_layers();
+    // Keep the perimeters of the old layers, make_perimeters() will reuse them for the layers that did not change.
+    this->move_layers_to_perimeters_cache();
     m_layers = new_layers(this, generate_object_layers(*m_slicing_params, layer_height_profile));
     this->slice_volumes();
     m_print->throw_if_canceled();
@@ -900,24 +970,33 @@ void PrintObject::slice_volumes()
     }
 
     std::vector<float>                   slice_zs      = zs_from_layers(m_layers);
-    std::vector<VolumeSlices> volume_slices = slice_volumes_inner(
-        print->config(),
-        this->config(),
-        this->trafo_centered(),
-        this->model_object()->volumes,
-        m_shared_regions->layer_ranges,
-        slice_zs,
-        throw_on_cancel_callback);
-
-    std::vector<std::vector<ExPolygons>> region_slices = slices_to_regions(
-        print->config(),
-        *this,
-        this->model_object()->volumes, 
-        *m_shared_regions, 
-        slice_zs,
-        std::move(volume_slices),
-        m_config.clip_multipart_objects,
-        throw_on_cancel_callback);
+    std::vector<std::vector<ExPolygons>> region_slices;
+    // Reuse the slices stored by a previous run of the command line slicer if possible.
+    const bool            use_cache = ! slice_cache_dir().empty();
+    const SliceCache::Key cache_key = use_cache ? slice_cache_key(*this, slice_zs) : SliceCache::Key();
+    if (! use_cache || ! SliceCache::load(cache_key, slice_zs, m_shared_regions->all_regions.size(), region_slices)) {
+        std::vector<VolumeSlices> volume_slices = slice_volumes_inner(
+            print->config(),
+            this->config(),
+            this->trafo_centered(),
+            this->model_object()->volumes,
+            m_shared_regions->layer_ranges,
+            slice_zs,
+            throw_on_cancel_callback);
+
+        region_slices = slices_to_regions(
+            print->config(),
+            *this,
+            this->model_object()->volumes, 
+            *m_shared_regions, 
+            slice_zs,
+            std::move(volume_slices),
+            m_config.clip_multipart_objects,
+            throw_on_cancel_callback);
+
+        if (use_cache)
+            SliceCache::save(cache_key, slice_zs, region_slices);
+    }
 
 
 
@@ -0,0 +1,285 @@
+#include "SliceCache.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/uuid/detail/sha1.hpp>
+
+namespace Slic3r {
+
+static std::string g_slice_cache_dir;
+
+void set_slice_cache_dir(const std::string &dir)
+{
+    g_slice_cache_dir = dir;
+}
+
+const std::string& slice_cache_dir()
+{
+    return g_slice_cache_dir;
+}
+
+namespace SliceCache {
+
+// File layout, all integers except for the CRC are LEB128 varints:
+//   magic, size of the key, key, number of layers, Z of the layers (4 bytes IEEE float each), number of regions,
+//   size of the payload, CRC32 of the payload (4 bytes little endian), payload.
+// Payload: for each region and each layer: number of ExPolygons, for each ExPolygon: number of holes, contour and holes,
+//   for each polygon: number of points and the points as zigzag encoded differences to the previous point of the layer.
+static constexpr const char s_magic[8] = { 'S', 'L', 'C', 'A', 'C', 'H', 'E', '2' };
+
+std::string Key::digest() const
+{
+    // Only addresses the entry, the key itself is compared on load.
+    // boost::uuids::detail::sha1 is an internal namespace thus it may change in the future.
+    using boost::uuids::detail::sha1;
+    sha1 sha1_hash;
+    sha1_hash.process_bytes(m_data.data(), m_data.size());
+    sha1::digest_type digest;
+    sha1_hash.get_digest(digest);
+    // The digest is stored in 32 bit words by older Boost, in bytes by newer Boost, both most significant digit first.
+    static constexpr const char hex[] = "0123456789abcdef";
+    std::string out;
+    for (auto word : digest)
+        for (int shift = int(sizeof(word)) * 8 - 4; shift >= 0; shift -= 4)
+            out += hex[(word >> shift) & 0xf];
+    // SHA-1 digest is 40 HEX digits long.
+    assert(out.size() == 40);
+    return out;
+}
+
+boost::filesystem::path entry_path(const Key &key)
+{
+    return boost::filesystem::path(g_slice_cache_dir) / (key.digest() + ".slices");
+}
+
+static uint32_t payload_crc(const char *data, size_t len)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, len);
+    return crc.checksum();
+}
+
+class Writer
+{
+public:
+    void raw(const void *data, size_t len) { m_data.append(reinterpret_cast<const char*>(data), len); }
+    void fixed32(uint32_t v) { for (int i = 0; i < 4; ++ i, v >>= 8) m_data += char(v & 0xff); }
+    void varint(uint64_t v) {
+        for (; v >= 0x80; v >>= 7)
+            m_data += char((v & 0x7f) | 0x80);
+        m_data += char(v);
+    }
+    void zigzag(int64_t v) { this->varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    void polygon(const Polygon &poly, Point &prev) {
+        this->varint(poly.points.size());
+        for (const Point &pt : poly.points) {
+            this->zigzag(int64_t(pt.x()) - int64_t(prev.x()));
+            this->zigzag(int64_t(pt.y()) - int64_t(prev.y()));
+            prev = pt;
+        }
+    }
+    const std::string& data() const { return m_data; }
+
+private:
+    std::string m_data;
+};
+
+// Decoder of a memory mapped cache entry. Any read past the end of the data or any implausible count
+// marks the reader as failed, the values read afterwards are zeros.
+class Reader
+{
+public:
+    Reader(const char *begin, const char *end) : m_ptr(reinterpret_cast<const unsigned char*>(begin)), m_end(reinterpret_cast<const unsigned char*>(end)) {}
+
+    bool ok() const { return m_ok; }
+    bool at_end() const { return m_ptr == m_end; }
+    bool raw(void *data, size_t len) {
+        if (! m_ok || size_t(m_end - m_ptr) < len)
+            return m_ok = false;
+        memcpy(data, m_ptr, len);
+        m_ptr += len;
+        return true;
+    }
+    uint32_t fixed32() {
+        unsigned char buf[4];
+        if (! this->raw(buf, 4))
+            return 0;
+        uint32_t v = 0;
+        for (int i = 3; i >= 0; -- i)
+            v = (v << 8) | buf[i];
+        return v;
+    }
+    void skip(size_t len) { assert(len <= this->remaining()); m_ptr += len; }
+    const char* ptr() const { return reinterpret_cast<const char*>(m_ptr); }
+    size_t      remaining() const { return m_end - m_ptr; }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; m_ok; shift += 7) {
+            if (m_ptr == m_end || shift > 63) {
+                m_ok = false;
+                break;
+            }
+            unsigned char c = *m_ptr ++;
+            v |= uint64_t(c & 0x7f) << shift;
+            if ((c & 0x80) == 0)
+                return v;
+        }
+        return 0;
+    }
+    int64_t zigzag() { uint64_t v = this->varint(); return int64_t(v >> 1) ^ - int64_t(v & 1); }
+    // Each stored item takes at least one byte, thus a count larger than the remaining data is corrupted.
+    size_t count() {
+        uint64_t v = this->varint();
+        if (v > uint64_t(m_end - m_ptr))
+            m_ok = false;
+        return m_ok ? size_t(v) : 0;
+    }
+    void polygon(Polygon &poly, Point &prev) {
+        poly.points.resize(this->count());
+        for (Point &pt : poly.points) {
+            prev.x() = coord_t(int64_t(prev.x()) + this->zigzag());
+            prev.y() = coord_t(int64_t(prev.y()) + this->zigzag());
+            pt = prev;
+        }
+    }
+
+private:
+    const unsigned char *m_ptr;
+    const unsigned char *m_end;
+    bool                 m_ok { true };
+};
+
+bool load(const Key &key, const std::vector<float> &zs, size_t num_regions, RegionSlices &out)
+{
+    if (g_slice_cache_dir.empty())
+        return false;
+
+    boost::filesystem::path path = entry_path(key);
+    boost::system::error_code ec;
+    if (! boost::filesystem::exists(path, ec) || boost::filesystem::file_size(path, ec) == 0 || ec)
+        return false;
+
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(path.string());
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Slice cache: failed to map " << path.string() << ": " << ex.what();
+        return false;
+    }
+    if (! file.is_open())
+        return false;
+
+    // Validate the header and the payload before decoding anything.
+    Reader reader(file.data(), file.data() + file.size());
+    char magic[sizeof(s_magic)];
+    if (! reader.raw(magic, sizeof(magic)) || memcmp(magic, s_magic, sizeof(s_magic)) != 0) {
+        BOOST_LOG_TRIVIAL(warning) << "Slice cache: ignoring entry of an unknown format " << path.string();
+        return false;
+    }
+    const size_t key_size = reader.count();
+    if (! reader.ok() || key_size != key.data().size() || memcmp(reader.ptr(), key.data().data(), key_size) != 0) {
+        // Hash collision or an entry of another object.
+        BOOST_LOG_TRIVIAL(info) << "Slice cache: key mismatch of " << path.string();
+        return false;
+    }
+    reader.skip(key_size);
+    if (reader.count() != zs.size())
+        return false;
+    for (float z : zs) {
+        float z_stored;
+        if (! reader.raw(&z_stored, sizeof(float)) || z_stored != z)
+            return false;
+    }
+    if (reader.varint() != num_regions)
+        return false;
+    const size_t   payload_size = reader.count();
+    const uint32_t crc          = reader.fixed32();
+    if (! reader.ok() || reader.remaining() != payload_size || payload_crc(reader.ptr(), payload_size) != crc) {
+        BOOST_LOG_TRIVIAL(warning) << "Slice cache: ignoring corrupted entry " << path.string();
+        return false;
+    }
+
+    out.assign(num_regions, std::vector<ExPolygons>(zs.size()));
+    for (std::vector<ExPolygons> &by_layer : out)
+        for (ExPolygons &expolygons : by_layer) {
+            Point prev(0, 0);
+            expolygons.resize(reader.count());
+            for (ExPolygon &expoly : expolygons) {
+                expoly.holes.resize(reader.count());
+                reader.polygon(expoly.contour, prev);
+                for (Polygon &hole : expoly.holes)
+                    reader.polygon(hole, prev);
+            }
+            if (! reader.ok())
+                break;
+        }
+    if (! reader.ok() || ! reader.at_end()) {
+        BOOST_LOG_TRIVIAL(warning) << "Slice cache: ignoring corrupted entry " << path.string();
+        out.clear();
+        return false;
+    }
+    BOOST_LOG_TRIVIAL(info) << "Slice cache: loaded " << path.string();
+    return true;
+}
+
+void save(const Key &key, const std::vector<float> &zs, const RegionSlices &slices)
+{
+    if (g_slice_cache_dir.empty())
+        return;
+
+    Writer payload;
+    for (const std::vector<ExPolygons> &by_layer : slices) {
+        assert(by_layer.size() == zs.size());
+        for (const ExPolygons &expolygons : by_layer) {
+            Point prev(0, 0);
+            payload.varint(expolygons.size());
+            for (const ExPolygon &expoly : expolygons) {
+                payload.varint(expoly.holes.size());
+                payload.polygon(expoly.contour, prev);
+                for (const Polygon &hole : expoly.holes)
+                    payload.polygon(hole, prev);
+            }
+        }
+    }
+
+    Writer writer;
+    writer.raw(s_magic, sizeof(s_magic));
+    writer.varint(key.data().size());
+    writer.raw(key.data().data(), key.data().size());
+    writer.varint(zs.size());
+    for (float z : zs)
+        writer.raw(&z, sizeof(float));
+    writer.varint(slices.size());
+    writer.varint(payload.data().size());
+    writer.fixed32(payload_crc(payload.data().data(), payload.data().size()));
+    writer.raw(payload.data().data(), payload.data().size());
+
+    // Write into a temporary file first and rename it, so that concurrently running instances never see a partially written entry.
+    boost::filesystem::path path = entry_path(key);
+    boost::filesystem::path temp = path;
+    temp += boost::filesystem::unique_path(".%%%%-%%%%.tmp");
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(path.parent_path(), ec);
+    bool written = false;
+    if (FILE *f = boost::nowide::fopen(temp.string().c_str(), "wb"); f != nullptr) {
+        written = ::fwrite(writer.data().data(), 1, writer.data().size(), f) == writer.data().size();
+        written &= ::fclose(f) == 0;
+    }
+    if (written)
+        boost::filesystem::rename(temp, path, ec);
+    if (! written || ec) {
+        BOOST_LOG_TRIVIAL(warning) << "Slice cache: failed to write " << path.string() << (ec ? ": " + ec.message() : std::string());
+        boost::filesystem::remove(temp, ec);
+    } else
+        BOOST_LOG_TRIVIAL(info) << "Slice cache: stored " << path.string() << ", " << writer.data().size() << " bytes";
+}
+
+} // namespace SliceCache
+} // namespace Slic3r
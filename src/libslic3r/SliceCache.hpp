@@ -0,0 +1,62 @@
+#ifndef slic3r_SliceCache_hpp_
+#define slic3r_SliceCache_hpp_
+
+#include "ExPolygon.hpp"
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+namespace Slic3r {
+
+// Persistent cache of the sliced volumes of PrintObjects, shared by subsequent runs of the command line slicer.
+// The cache is content addressed: the key holds everything the slices depend on (meshes, transformations,
+// Z heights of the layers, assignment of the volumes to regions and the few config options used by the mesh slicer),
+// so no invalidation is ever needed. Empty path disables the cache (default).
+void set_slice_cache_dir(const std::string &path);
+const std::string& slice_cache_dir();
+
+namespace SliceCache {
+
+// Slices of a PrintObject split by regions: slices[region_id][layer_id].
+using RegionSlices = std::vector<std::vector<ExPolygons>>;
+
+// Serialized inputs of the cached slices. The cache entry is addressed by the SHA-1 digest of the key, which does not depend
+// on the platform or on the standard library. The key itself is stored in the entry and compared on load,
+// thus a digest collision or an entry of another object is never loaded.
+class Key
+{
+public:
+    void add(const void *data, size_t len) { m_data.append(reinterpret_cast<const char*>(data), len); }
+    template<typename T>
+    void add(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "SliceCache::Key::add() accepts trivially copyable types only");
+        this->add(&value, sizeof(T));
+    }
+    // Length prefixed, so that the concatenation of strings is unambiguous.
+    void add(const std::string &str) { this->add(uint64_t(str.size())); this->add(str.data(), str.size()); }
+
+    const std::string&  data() const { return m_data; }
+    // SHA-1 digest of the key as 40 hex digits.
+    std::string         digest() const;
+
+private:
+    std::string m_data;
+};
+
+// Path of the cache entry of the key.
+boost::filesystem::path entry_path(const Key &key);
+
+// Load the slices stored under the key, validated against the key, the Z heights and the number of regions.
+// Returns false if the cache is disabled, the entry does not exist or it is not valid.
+bool load(const Key &key, const std::vector<float> &zs, size_t num_regions, RegionSlices &out);
+// Store the slices under the key. Failure to write the cache entry is only logged.
+void save(const Key &key, const std::vector<float> &zs, const RegionSlices &slices);
+
+} // namespace SliceCache
+} // namespace Slic3r
+
+#endif // slic3r_SliceCache_hpp_
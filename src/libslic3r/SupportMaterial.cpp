@@ -17,7 +17,6 @@
 #include <boost/container/static_vector.hpp>
 
 #include <tbb/parallel_for.h>
-#include <tbb/spin_mutex.h>
 #include <tbb/task_group.h>
 
 #define SUPPORT_USE_AGG_RASTERIZER
@@ -424,27 +423,28 @@ PrintObjectSupportMaterial::PrintObjectSupportMaterial(const PrintObject *object
             m_support_params.contact_fill_pattern = ipSupportBase;
 }
 
-// Using the std::deque as an allocator.
 inline PrintObjectSupportMaterial::MyLayer& layer_allocate(
-    std::deque<PrintObjectSupportMaterial::MyLayer> &layer_storage, 
+    PrintObjectSupportMaterial::MyLayerStorage      &layer_storage, 
     PrintObjectSupportMaterial::SupporLayerType      layer_type)
 { 
-    layer_storage.push_back(PrintObjectSupportMaterial::MyLayer());
-    layer_storage.back().layer_type = layer_type;
-    return layer_storage.back();
+    return layer_storage.allocate(layer_type);
 }
 
-inline PrintObjectSupportMaterial::MyLayer& layer_allocate(
-    std::deque<PrintObjectSupportMaterial::MyLayer> &layer_storage,
-    tbb::spin_mutex                                 &layer_storage_mutex,
-    PrintObjectSupportMaterial::SupporLayerType      layer_type)
-{ 
-    layer_storage_mutex.lock();
-    layer_storage.push_back(PrintObjectSupportMaterial::MyLayer());
-    PrintObjectSupportMaterial::MyLayer *layer_new = &layer_storage.back();
-    layer_storage_mutex.unlock();
-    layer_new->layer_type = layer_type;
-    return *layer_new;
+size_t PrintObjectSupportMaterial::MyLayerStorage::size() const
+{
+    size_t n = 0;
+    for (const ThreadPool &pool : m_pools)
+        if (! pool.chunks.empty())
+            n += (pool.chunks.size() - 1) * chunk_size + pool.last_chunk_used;
+    return n;
+}
+
+size_t PrintObjectSupportMaterial::MyLayerStorage::num_chunks() const
+{
+    size_t n = 0;
+    for (const ThreadPool &pool : m_pools)
+        n += pool.chunks.size();
+    return n;
 }
 
 inline void layers_append(PrintObjectSupportMaterial::MyLayersPtr &dst, const PrintObjectSupportMaterial::MyLayersPtr &src)
@@ -465,7 +465,7 @@ void PrintObjectSupportMaterial::generate(PrintObject &object)
     for (size_t i = 0; i < object.layer_count(); ++ i)
         max_object_layer_height = std::max(max_object_layer_height, object.layers()[i]->height);
 
-    // Layer instances will be allocated by std::deque and they will be kept until the end of this function call.
+    // Layer instances will be allocated by the layer storage and they will be kept until the end of this function call.
     // The layers will be referenced by various LayersPtr (of type std::vector<Layer*>)
     MyLayerStorage layer_storage;
 
@@ -718,6 +718,9 @@ void PrintObjectSupportMaterial::generate(PrintObject &object)
     }
 #endif /* SLIC3R_DEBUG */
 
+    BOOST_LOG_TRIVIAL(debug) << "Support generator - Releasing " << layer_storage.size() << " temporary layers allocated in " << layer_storage.num_chunks() << " chunks";
+    layer_storage.clear();
+
     BOOST_LOG_TRIVIAL(info) << "Support generator - End";
 }
 
@@ -1414,27 +1417,43 @@ namespace SupportMaterialInternal {
     }
 }
 
+std::vector<Polygons> running_union(const std::vector<Polygons> &layers)
+{
+    // Unfortunately this is an inherently serial process: the unions are folded in the order of the layers,
+    // so that the result does not depend on the rounding of Clipper unions calculated in a different order.
+    std::vector<Polygons> out(layers.size());
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id) {
+        Polygons &covered = out[layer_id];
+        if (layer_id > 0)
+            covered = out[layer_id - 1];
+        polygons_append(covered, layers[layer_id]);
+        covered = union_(covered);
+    }
+    return out;
+}
+
 std::vector<Polygons> PrintObjectSupportMaterial::buildplate_covered(const PrintObject &object) const
 {
     // Build support on a build plate only? If so, then collect and union all the surfaces below the current layer.
-    // Unfortunately this is an inherently serial process.
     const bool            buildplate_only = this->build_plate_only();
     std::vector<Polygons> buildplate_covered;
     if (buildplate_only) {
         BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() - start";
         buildplate_covered.assign(object.layers().size(), Polygons());
-        //FIXME prefix sum algorithm, parallelize it! Parallelization will also likely be more numerically stable.
-        for (size_t layer_id = 1; layer_id < object.layers().size(); ++ layer_id) {
-            const Layer &lower_layer = *object.layers()[layer_id-1];
-            // Merge the new slices with the preceding slices.
+        if (object.layers().size() > 1) {
             // Apply the safety offset to the newly added polygons, so they will connect
             // with the polygons collected before,
             // but don't apply the safety offset during the union operation as it would
             // inflate the polygons over and over.
-            Polygons &covered = buildplate_covered[layer_id];
-            covered = buildplate_covered[layer_id - 1];
-            polygons_append(covered, offset(lower_layer.lslices, scale_(0.01)));
-            covered = union_(covered);
+            std::vector<Polygons> layer_covered(object.layers().size() - 1);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, layer_covered.size()),
+                [&object, &layer_covered](const tbb::blocked_range<size_t> &range) {
+                    for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id)
+                        layer_covered[layer_id] = offset(object.layers()[layer_id]->lslices, scale_(0.01));
+                });
+            // Merge the slices of each layer with the slices of the layers below.
+            std::vector<Polygons> covered = running_union(layer_covered);
+            std::move(covered.begin(), covered.end(), buildplate_covered.begin() + 1);
         }
         BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() - end";
     }
@@ -1713,8 +1732,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
     const SlicingParameters                             &slicing_params,
     const coordf_t                                       support_layer_height_min,
     const Layer                                         &layer, 
-    std::deque<PrintObjectSupportMaterial::MyLayer>     &layer_storage,
-    tbb::spin_mutex                                     &layer_storage_mutex)
+    PrintObjectSupportMaterial::MyLayerStorage          &layer_storage)
 {
     double print_z, bottom_z, height;
     PrintObjectSupportMaterial::MyLayer* bridging_layer = nullptr;
@@ -1777,7 +1795,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
                 }
                 if (bridging_print_z < print_z - EPSILON) {
                     // Allocate the new layer.
-                    bridging_layer = &layer_allocate(layer_storage, layer_storage_mutex, PrintObjectSupportMaterial::sltTopContact);
+                    bridging_layer = &layer_allocate(layer_storage, PrintObjectSupportMaterial::sltTopContact);
                     bridging_layer->idx_object_layer_above = layer_id;
                     bridging_layer->print_z = bridging_print_z;
                     if (bridging_print_z == slicing_params.first_print_layer_height) {
@@ -1793,7 +1811,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
         }
     }
 
-    PrintObjectSupportMaterial::MyLayer &new_layer = layer_allocate(layer_storage, layer_storage_mutex, PrintObjectSupportMaterial::sltTopContact);
+    PrintObjectSupportMaterial::MyLayer &new_layer = layer_allocate(layer_storage, PrintObjectSupportMaterial::sltTopContact);
     new_layer.idx_object_layer_above = layer_id;
     new_layer.print_z  = print_z;
     new_layer.bottom_z = bottom_z;
@@ -2025,9 +2043,8 @@ PrintObjectSupportMaterial::MyLayersPtr PrintObjectSupportMaterial::top_contact_
     // For each overhang layer, two supporting layers may be generated: One for the overhangs extruded with a bridging flow, 
     // and the other for the overhangs extruded with a normal flow.
     contact_out.assign(num_layers * 2, nullptr);
-    tbb::spin_mutex layer_storage_mutex;
     tbb::parallel_for(tbb::blocked_range<size_t>(this->has_raft() ? 0 : 1, num_layers),
-        [this, &object, &annotations, &layer_storage, &layer_storage_mutex, &contact_out]
+        [this, &object, &annotations, &layer_storage, &contact_out]
         (const tbb::blocked_range<size_t>& range) {
             for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) 
             {
@@ -2045,7 +2062,7 @@ PrintObjectSupportMaterial::MyLayersPtr PrintObjectSupportMaterial::top_contact_
                 // Now apply the contact areas to the layer where they need to be made.
                 if (! contact_polygons.empty() || ! overhang_polygons.empty()) {
                     // Allocate the two empty layers.
-                    auto [new_layer, bridging_layer] = new_contact_layer(*m_print_config, *m_object_config, *m_slicing_params, m_support_params.support_layer_height_min, layer, layer_storage, layer_storage_mutex);
+                    auto [new_layer, bridging_layer] = new_contact_layer(*m_print_config, *m_object_config, *m_slicing_params, m_support_params.support_layer_height_min, layer, layer_storage);
                     if (new_layer) {
                         // Fill the non-bridging layer with polygons.
                         fill_contact_layer(*new_layer, layer_id, *m_slicing_params,
@@ -2095,7 +2112,7 @@ static inline PrintObjectSupportMaterial::MyLayer* detect_bottom_contacts(
     // First top contact layer index overlapping with this new bottom interface layer.
     size_t                                            contact_idx,
     // To allocate a new layer from.
-    std::deque<PrintObjectSupportMaterial::MyLayer>  &layer_storage,
+    PrintObjectSupportMaterial::MyLayerStorage       &layer_storage,
     // To trim the support areas above this bottom interface layer with this newly created bottom interface layer.
     std::vector<Polygons>                            &layer_support_areas,
     // Support areas projected from top to bottom, starting with top support interfaces.
@@ -3152,9 +3169,8 @@ std::pair<PrintObjectSupportMaterial::MyLayersPtr, PrintObjectSupportMaterial::M
         auto smoothing_distance              = m_support_params.support_material_interface_flow.scaled_spacing() * 1.5;
         auto minimum_island_radius           = m_support_params.support_material_interface_flow.scaled_spacing() / m_support_params.interface_density;
         auto closing_distance                = smoothing_distance; // scaled<float>(m_object_config->support_material_closing_radius.value);
-        tbb::spin_mutex layer_storage_mutex;
         // Insert a new layer into base_interface_layers, if intersection with base exists.
-        auto insert_layer = [&layer_storage, &layer_storage_mutex, snug_supports, closing_distance, smoothing_distance, minimum_island_radius](
+        auto insert_layer = [&layer_storage, snug_supports, closing_distance, smoothing_distance, minimum_island_radius](
                 MyLayer &intermediate_layer, Polygons &bottom, Polygons &&top, const Polygons *subtract, SupporLayerType type) -> MyLayer* {
             assert(! bottom.empty() || ! top.empty());
             // Merge top into bottom, unite them with a safety offset.
@@ -3169,7 +3185,7 @@ std::pair<PrintObjectSupportMaterial::MyLayersPtr, PrintObjectSupportMaterial::M
                 //FIXME Remove non-printable tiny islands, let them be printed using the base support.
                 //bottom = opening(std::move(bottom), minimum_island_radius);
                 if (! bottom.empty()) {
-                    MyLayer &layer_new = layer_allocate(layer_storage, layer_storage_mutex, type);
+                    MyLayer &layer_new = layer_allocate(layer_storage, type);
                     layer_new.polygons   = std::move(bottom);
                     layer_new.print_z    = intermediate_layer.print_z;
                     layer_new.bottom_z   = intermediate_layer.bottom_z;
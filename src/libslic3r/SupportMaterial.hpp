@@ -5,6 +5,11 @@
 #include "PrintConfig.hpp"
 #include "Slicing.hpp"
 
+#include <memory>
+#include <vector>
+
+#include <tbb/enumerable_thread_specific.h>
+
 namespace Slic3r {
 
 class PrintObject;
@@ -149,10 +154,39 @@ public:
 	    bool                    with_sheath;
 	};
 
-	// Layers are allocated and owned by a deque. Once a layer is allocated, it is maintained
-	// up to the end of a generate() method. The layer storage may be replaced by an allocator class in the future, 
-	// which would allocate layers by multiple chunks.
-	typedef std::deque<MyLayer> 				MyLayerStorage;
+	// Layers are allocated and owned by a layer storage. Once a layer is allocated, it is maintained
+	// up to the end of a generate() method, when all the layers are released at once.
+	// Each thread allocates its layers by chunks from its own pool, thus the worker threads
+	// allocating layers do not need to synchronize.
+	class MyLayerStorage
+	{
+	public:
+		MyLayer& allocate(SupporLayerType layer_type) {
+			ThreadPool &pool = m_pools.local();
+			if (pool.chunks.empty() || pool.last_chunk_used == chunk_size) {
+				pool.chunks.emplace_back(new MyLayer[chunk_size]);
+				pool.last_chunk_used = 0;
+			}
+			MyLayer &layer = pool.chunks.back()[pool.last_chunk_used ++];
+			layer.layer_type = layer_type;
+			return layer;
+		}
+		// Number of layers allocated.
+		size_t size() const;
+		// Number of chunks allocated.
+		size_t num_chunks() const;
+		// Release all layers. Not thread safe, none of the layers may be referenced anymore.
+		void   clear() { m_pools.clear(); }
+
+	private:
+		static constexpr const size_t chunk_size = 64;
+		struct ThreadPool {
+			std::vector<std::unique_ptr<MyLayer[]>> chunks;
+			// Number of layers allocated from the last chunk.
+			size_t                                  last_chunk_used { 0 };
+		};
+		tbb::enumerable_thread_specific<ThreadPool> m_pools;
+	};
 	typedef std::vector<MyLayer*> 				MyLayersPtr;
 
 public:
@@ -260,6 +294,10 @@ private:
 	SupportParams 			 m_support_params;
 };
 
+// Union of the polygons of each layer with the polygons of all the layers below it: out[i] = union(layers[0], ..., layers[i]).
+// Folded serially in the order of the layers, the caller may prepare the layers in parallel.
+std::vector<Polygons> running_union(const std::vector<Polygons> &layers);
+
 } // namespace Slic3r
 
 #endif /* slic3r_SupportMaterial_hpp_ */
@@ -35,6 +35,8 @@
 #define ENABLE_SMOOTH_NORMALS 0
 // Enable rendering markers for options in preview as fixed screen size points
 #define ENABLE_FIXED_SCREEN_SIZE_POINT_MARKERS 1
+// Enable rendering a level of detail of the toolpaths in the G-code viewer when zoomed out
+#define ENABLE_GCODE_VIEWER_TOOLPATHS_LOD 1
 
 
 //================
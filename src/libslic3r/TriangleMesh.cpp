@@ -29,6 +29,9 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
 #include <assert.h>
 
 namespace Slic3r {
@@ -669,7 +672,8 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
     auto sorted = reserve_vector<int>(its.vertices.size());
     for (int i = 0; i < int(its.vertices.size()); ++ i)
         sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
+    // The vertex index breaks the ties, thus the order is unique and the parallel sort produces the same result as a sequential one.
+    tbb::parallel_sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
         const Vec3f &l = its.vertices[il];
         const Vec3f &r = its.vertices[ir];
         // Sort lexicographically by coordinates AND vertex index.
@@ -714,9 +718,13 @@ int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
         // Shrink the vertices.
         its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
         // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 4096), [&its, &map_vertices](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                stl_triangle_vertex_indices &face = its.indices[i];
+                for (int j = 0; j < 3; ++ j)
+                    face(j) = map_vertices[face(j)];
+            }
+        });
         // Optionally shrink to fit (reallocate) vertices.
         if (shrink_to_fit)
             its.vertices.shrink_to_fit();
@@ -303,6 +303,61 @@ static FacetSliceType slice_facet(
     return FacetSliceType::NoSlice;
 }
 
+// Lookup of the slicing planes intersected by a facet, replacing a binary search over the Zs of all the slicing planes
+// with a table lookup: the Z span of the slicing planes is split into buckets of a uniform height, each bucket
+// storing the index of the first slicing plane at or above its bottom. Only the few planes of a single bucket are searched,
+// then the result is corrected for rounding errors, thus it is exactly the same as of std::lower_bound() resp. std::upper_bound().
+class SlicingPlanesIndex
+{
+public:
+    explicit SlicingPlanesIndex(const std::vector<float> &zs) : m_zs(zs) {
+        if (zs.size() > 1 && zs.back() > zs.front()) {
+            m_z0          = zs.front();
+            // Roughly one slicing plane per bucket.
+            m_inv_bucket  = float(zs.size()) / (zs.back() - zs.front());
+            m_first.assign(zs.size() + 2, 0);
+            for (size_t i = 0; i < m_first.size(); ++ i)
+                m_first[i] = uint32_t(std::lower_bound(zs.begin(), zs.end(), m_z0 + float(i) / m_inv_bucket) - zs.begin());
+        }
+    }
+
+    // Index of the first slicing plane with Z >= z.
+    size_t lower_bound(float z) const {
+        auto [lo, hi] = this->bucket(z);
+        size_t idx = std::lower_bound(m_zs.begin() + lo, m_zs.begin() + hi, z) - m_zs.begin();
+        for (; idx > 0 && m_zs[idx - 1] >= z; -- idx) ;
+        for (; idx < m_zs.size() && m_zs[idx] < z; ++ idx) ;
+        return idx;
+    }
+    // Index of the first slicing plane with Z > z.
+    size_t upper_bound(float z) const {
+        auto [lo, hi] = this->bucket(z);
+        size_t idx = std::upper_bound(m_zs.begin() + lo, m_zs.begin() + hi, z) - m_zs.begin();
+        for (; idx > 0 && m_zs[idx - 1] > z; -- idx) ;
+        for (; idx < m_zs.size() && m_zs[idx] <= z; ++ idx) ;
+        return idx;
+    }
+
+private:
+    // Range of the slicing planes likely to contain the result.
+    std::pair<size_t, size_t> bucket(float z) const {
+        if (m_first.empty())
+            return { 0, m_zs.size() };
+        if (! (z > m_z0))
+            return { 0, 0 };
+        float bucket = (z - m_z0) * m_inv_bucket;
+        if (! (bucket < float(m_first.size() - 2)))
+            return { m_zs.size(), m_zs.size() };
+        auto  i = size_t(bucket);
+        return { m_first[i], m_first[i + 1] };
+    }
+
+    const std::vector<float> &m_zs;
+    float                     m_z0          { 0.f };
+    float                     m_inv_bucket  { 0.f };
+    std::vector<uint32_t>     m_first;
+};
+
 template<typename TransformVertex>
 void slice_facet_at_zs(
     // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
@@ -312,27 +367,18 @@ void slice_facet_at_zs(
     const Vec3i32                                    &edge_ids,
     // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
     const std::vector<float>                         &zs,
-    std::vector<IntersectionLines>                   &lines,
-    std::array<std::mutex, 64>                       &lines_mutex)
+    // Range of the slicing planes intersecting the facet.
+    const size_t                                      first_layer,
+    const size_t                                      last_layer,
+    std::vector<IntersectionLines>                   &lines)
 {
     stl_vertex vertices[3] { transform_vertex_fn(mesh_vertices[indices(0)]), transform_vertex_fn(mesh_vertices[indices(1)]), transform_vertex_fn(mesh_vertices[indices(2)]) };
-
-    // find facet extents
     const float min_z = fminf(vertices[0].z(), fminf(vertices[1].z(), vertices[2].z()));
-    const float max_z = fmaxf(vertices[0].z(), fmaxf(vertices[1].z(), vertices[2].z()));
-    
-    // find layer extents
-    auto min_layer = std::lower_bound(zs.begin(), zs.end(), min_z); // first layer whose slice_z is >= min_z
-    auto max_layer = std::upper_bound(min_layer, zs.end(), max_z); // first layer whose slice_z is > max_z
     int  idx_vertex_lowest = (vertices[1].z() == min_z) ? 1 : ((vertices[2].z() == min_z) ? 2 : 0);
-    
-    for (auto it = min_layer; it != max_layer; ++ it) {
+    for (size_t slice_id = first_layer; slice_id < last_layer; ++ slice_id) {
         IntersectionLine il;
-        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
-        if (min_z != max_z && slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
+        if (slice_facet(zs[slice_id], vertices, indices, edge_ids, idx_vertex_lowest, false, il) == FacetSliceType::Slicing) {
             assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
-            size_t slice_id = it - zs.begin();
-            boost::lock_guard<std::mutex> l(lines_mutex[slice_id % lines_mutex.size()]);
             lines[slice_id].emplace_back(il);
         }
     }
@@ -347,18 +393,80 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     const std::vector<float>                        &zs,
     const ThrowOnCancel                              throw_on_cancel_fn)
 {
-    std::vector<IntersectionLines>  lines(zs.size(), IntersectionLines());
-    std::array<std::mutex, 64>      lines_mutex;
+    // Transformed Z of the vertices, so that classifying a facet against the slicing planes reads just three floats.
+    std::vector<float> vertices_z(vertices.size());
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
-        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
-            for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
-                if ((face_idx & 0x0ffff) == 0)
+        tbb::blocked_range<size_t>(0, vertices.size()),
+        [&vertices, &transform_vertex_fn, &vertices_z](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                vertices_z[i] = transform_vertex_fn(vertices[i]).z();
+        });
+
+    // The facets are processed in chunks, each chunk collecting its own intersection lines, which are then concatenated
+    // in the order of the chunks. No locking is needed and the order of the lines does not depend on the thread scheduling.
+    const SlicingPlanesIndex planes(zs);
+    const size_t num_faces  = indices.size();
+    const size_t chunk_size = std::max<size_t>(8192, (num_faces + 127) / 128);
+    const size_t num_chunks = (num_faces + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<IntersectionLines>> chunk_lines(num_chunks);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chunks, 1),
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &zs, &vertices_z, &planes, num_faces, chunk_size, &chunk_lines, throw_on_cancel_fn]
+        (const tbb::blocked_range<size_t> &range) {
+            static constexpr const size_t block_size = 256;
+            float min_z[block_size];
+            float max_z[block_size];
+            for (size_t chunk_id = range.begin(); chunk_id < range.end(); ++ chunk_id) {
+                std::vector<IntersectionLines> &lines = chunk_lines[chunk_id];
+                const size_t chunk_end = std::min(num_faces, (chunk_id + 1) * chunk_size);
+                for (size_t block_begin = chunk_id * chunk_size; block_begin < chunk_end; block_begin += block_size) {
                     throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, lines, lines_mutex);
+                    const size_t n = std::min(block_size, chunk_end - block_begin);
+                    // Find the facet extents. Branchless loop over a block of facets, which the compiler vectorizes.
+                    for (size_t i = 0; i < n; ++ i) {
+                        const stl_triangle_vertex_indices &face = indices[block_begin + i];
+                        const float z0 = vertices_z[face(0)];
+                        const float z1 = vertices_z[face(1)];
+                        const float z2 = vertices_z[face(2)];
+                        min_z[i] = std::min(z0, std::min(z1, z2));
+                        max_z[i] = std::max(z0, std::max(z1, z2));
+                    }
+                    for (size_t i = 0; i < n; ++ i) {
+                        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
+                        if (min_z[i] == max_z[i])
+                            continue;
+                        // Most facets of a finely tesselated mesh do not reach any slicing plane.
+                        const size_t first_layer = planes.lower_bound(min_z[i]); // first layer whose slice_z is >= min_z
+                        const size_t last_layer  = planes.upper_bound(max_z[i]); // first layer whose slice_z is > max_z
+                        if (first_layer >= last_layer)
+                            continue;
+                        if (lines.empty())
+                            lines.assign(zs.size(), IntersectionLines());
+                        const size_t face_idx = block_begin + i;
+                        slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, first_layer, last_layer, lines);
+                    }
+                }
             }
-        }
-    );
+        });
+
+    std::vector<IntersectionLines> lines(zs.size(), IntersectionLines());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, zs.size()),
+        [&chunk_lines, &lines](const tbb::blocked_range<size_t> &range) {
+            for (size_t slice_id = range.begin(); slice_id < range.end(); ++ slice_id) {
+                size_t num_lines = 0;
+                for (const std::vector<IntersectionLines> &src : chunk_lines)
+                    if (! src.empty())
+                        num_lines += src[slice_id].size();
+                IntersectionLines &dst = lines[slice_id];
+                dst.reserve(num_lines);
+                for (std::vector<IntersectionLines> &src : chunk_lines)
+                    if (! src.empty()) {
+                        append(dst, std::move(src[slice_id]));
+                        src[slice_id] = IntersectionLines();
+                    }
+            }
+        });
     return lines;
 }
 
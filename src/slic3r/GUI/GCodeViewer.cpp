@@ -35,13 +35,43 @@
 #include <wx/progdlg.h>
 #include <wx/numformatter.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
 #include <array>
 #include <algorithm>
 #include <chrono>
+#include <optional>
 
 namespace Slic3r {
 namespace GUI {
 
+// sends the given indices to the index buffer currently bound to GL_ELEMENT_ARRAY_BUFFER,
+// as unsigned short if the indices are not sent to gpu as unsigned int
+static void send_indices_to_gpu(const unsigned int* indices, size_t count, bool use_32bit_indices)
+{
+    if (use_32bit_indices)
+        glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW));
+    else {
+        const std::vector<unsigned short> short_indices(indices, indices + count);
+        glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), short_indices.data(), GL_STATIC_DRAW));
+    }
+}
+
+// returns the given count of indices, starting from the given one, from the index buffer currently bound to GL_ELEMENT_ARRAY_BUFFER
+static std::vector<unsigned int> get_indices_from_gpu(size_t first, size_t count, bool use_32bit_indices)
+{
+    std::vector<unsigned int> ret(count);
+    if (use_32bit_indices)
+        glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(unsigned int)), static_cast<GLsizeiptr>(count * sizeof(unsigned int)), static_cast<void*>(ret.data())));
+    else {
+        std::vector<unsigned short> short_indices(count);
+        glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(unsigned short)), static_cast<GLsizeiptr>(count * sizeof(unsigned short)), static_cast<void*>(short_indices.data())));
+        ret.assign(short_indices.begin(), short_indices.end());
+    }
+    return ret;
+}
+
 static unsigned char buffer_id(EMoveType type) {
     return static_cast<unsigned char>(type) - static_cast<unsigned char>(EMoveType::Retract);
 }
@@ -127,6 +157,12 @@ void GCodeViewer::IBuffer::reset()
         glsafe(::glDeleteBuffers(1, &ibo));
         ibo = 0;
     }
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    if (lod_ibo > 0) {
+        glsafe(::glDeleteBuffers(1, &lod_ibo));
+        lod_ibo = 0;
+    }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
 
     vbo = 0;
     count = 0;
@@ -712,9 +748,22 @@ void GCodeViewer::init()
     ::glGetIntegerv(GL_ALIASED_POINT_SIZE_RANGE, point_sizes.data());
     m_detected_point_sizes = { static_cast<float>(point_sizes[0]), static_cast<float>(point_sizes[1]) };
 
+    // initializes the type of the indices sent to gpu: unsigned int if the driver is able to efficiently render
+    // ranges of vertices larger than the ones addressable by unsigned short, unsigned short otherwise
+    GLint max_elements_vertices = 0;
+    ::glGetIntegerv(GL_MAX_ELEMENTS_VERTICES, &max_elements_vertices);
+    s_32bit_indices = max_elements_vertices > 65536;
+
     m_gl_data_initialized = true;
 }
 
+bool GCodeViewer::s_32bit_indices = false;
+
+unsigned int GCodeViewer::ibuffer_gl_type()
+{
+    return s_32bit_indices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+}
+
 bool GCodeViewer::is_loaded(const GCodeProcessorResult& gcode_result) {
     return (m_last_result_id == gcode_result.id);
 }
@@ -924,6 +973,9 @@ void GCodeViewer::reset()
     m_statistics.reset_all();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
     m_contained_in_bed = true;
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    m_lod_active = false;
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
 }
 
 void GCodeViewer::render()
@@ -1084,6 +1136,14 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
     if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Triangle)
         return;
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    // export the exact toolpaths, the level of detail is selected again by the next render
+    if (m_lod_active) {
+        m_lod_active = false;
+        refresh_render_paths(true, true);
+    }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
     // collect color information to generate materials
     std::vector<Color> colors;
     for (const RenderPath& path : t_buffer.render_paths) {
@@ -1193,9 +1253,7 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
             // get indices data from index buffer on gpu
             glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibuffer.ibo));
             for (size_t j = 0; j < render_path.sizes.size(); ++j) {
-                IndexBuffer indices(render_path.sizes[j]);
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(render_path.offsets[j]),
-                    static_cast<GLsizeiptr>(render_path.sizes[j] * sizeof(IBufferType)), static_cast<void*>(indices.data())));
+                const IndexBuffer indices = get_indices_from_gpu(render_path.offsets[j] / ibuffer_type_size(), render_path.sizes[j], s_32bit_indices);
 
                 const size_t triangles_count = render_path.sizes[j] / 3;
                 for (size_t k = 0; k < triangles_count; ++k) {
@@ -1490,6 +1548,134 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             sq_prev_length = sq_length;
     };
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    // level of detail of the toolpaths rendered as solid:
+    // consecutive segments of a sub path are merged into a single stem while all the merged vertices
+    // are closer than half of the extrusion width to it, the outer corner caps in between are skipped.
+    // It references the same vertices as the exact toolpaths, into a separate index buffer for each index buffer of the exact ones.
+    struct LodRun
+    {
+        // path and sub path being processed
+        size_t path_id{ size_t(-1) };
+        size_t sub_path_id{ size_t(-1) };
+        // whether there are merged segments not yet stored into the index buffer
+        bool open{ false };
+        // vertices of the starting and of the ending section of the merged segments
+        std::array<IBufferType, 4> first_v_offsets;
+        std::array<IBufferType, 4> last_v_offsets;
+        // starting position of the merged segments, followed by the positions of the merged vertices
+        std::vector<Vec3f> positions;
+    };
+    // max count of segments merged together, to bound the cost of the tolerance check
+    static const size_t LOD_MAX_MERGED_SEGMENTS = 64;
+    auto add_lod_indices_as_solid = [](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, const GCodeProcessorResult::MoveVertex* next,
+        TBuffer& buffer, size_t vbuffer_size, bool is_first_segment, MultiIndexBuffer& lod_multibuffer, LodRun& run) {
+            auto store_triangle = [](IndexBuffer& indices, IBufferType i1, IBufferType i2, IBufferType i3) {
+                indices.push_back(i1);
+                indices.push_back(i2);
+                indices.push_back(i3);
+            };
+            auto lod_indices = [&lod_multibuffer](const Path::Sub_Path& sub_path) -> IndexBuffer& {
+                if (lod_multibuffer.size() <= sub_path.first.b_id)
+                    lod_multibuffer.resize(sub_path.first.b_id + 1);
+                return lod_multibuffer[sub_path.first.b_id];
+            };
+            // stores the stem triangles of the merged segments, see append_stem_triangles() in add_indices_as_solid()
+            auto close_run = [&]() {
+                if (!run.open)
+                    return;
+                Path::Sub_Path& sub_path = buffer.paths[run.path_id].sub_paths[run.sub_path_id];
+                IndexBuffer& indices = lod_indices(sub_path);
+                const std::array<IBufferType, 4>& f = run.first_v_offsets;
+                const std::array<IBufferType, 4>& l = run.last_v_offsets;
+                store_triangle(indices, f[0], f[1], l[0]);
+                store_triangle(indices, f[1], l[1], l[0]);
+                store_triangle(indices, f[1], f[2], l[1]);
+                store_triangle(indices, f[2], l[2], l[1]);
+                store_triangle(indices, f[2], f[3], l[2]);
+                store_triangle(indices, f[3], l[3], l[2]);
+                store_triangle(indices, f[3], f[0], l[3]);
+                store_triangle(indices, f[0], l[0], l[3]);
+                sub_path.lod_i_count = indices.size() - sub_path.lod_i_id;
+                run.open = false;
+            };
+
+            const size_t path_id = buffer.paths.size() - 1;
+            Path& path = buffer.paths.back();
+            const size_t sub_path_id = path.sub_paths.size() - 1;
+            Path::Sub_Path& sub_path = path.sub_paths.back();
+
+            // vertices of the current segment, with the same layout used by add_indices_as_solid()
+            const bool restart = is_first_segment || vbuffer_size == 0;
+            const IBufferType base = static_cast<IBufferType>(vbuffer_size);
+            const std::array<IBufferType, 4> first_v_offsets = restart ?
+                std::array<IBufferType, 4>{ base, IBufferType(base + 1), IBufferType(base + 2), IBufferType(base + 3) } :
+                std::array<IBufferType, 4>{ IBufferType(base - 4), base, IBufferType(base - 2), IBufferType(base + 1) };
+            const std::array<IBufferType, 4> last_v_offsets = restart ?
+                std::array<IBufferType, 4>{ IBufferType(base + 4), IBufferType(base + 5), IBufferType(base + 6), IBufferType(base + 7) } :
+                std::array<IBufferType, 4>{ IBufferType(base + 2), IBufferType(base + 3), IBufferType(base + 4), IBufferType(base + 5) };
+
+            const bool same_sub_path = run.path_id == path_id && run.sub_path_id == sub_path_id;
+            auto can_merge = [&]() {
+                if (!run.open || !same_sub_path || restart || run.positions.size() > LOD_MAX_MERGED_SEGMENTS)
+                    return false;
+                // all the merged vertices have to be close to the segment from the starting position to the current position
+                const Vec3f& first = run.positions.front();
+                const Vec3f dir = curr.position - first;
+                const float sq_length = dir.squaredNorm();
+                const float sq_tolerance = sqr(0.5f * path.width);
+                auto sq_distance = [&first, &dir, sq_length](const Vec3f& position) {
+                    const float t = (sq_length > 0.0f) ? std::clamp((position - first).dot(dir) / sq_length, 0.0f, 1.0f) : 0.0f;
+                    return (first + t * dir - position).squaredNorm();
+                };
+                if (sq_distance(prev.position) > sq_tolerance)
+                    return false;
+                for (size_t i = 1; i < run.positions.size(); ++i) {
+                    if (sq_distance(run.positions[i]) > sq_tolerance)
+                        return false;
+                }
+                return true;
+            };
+
+            if (can_merge()) {
+                run.positions.push_back(prev.position);
+                run.last_v_offsets = last_v_offsets;
+            }
+            else {
+                close_run();
+                IndexBuffer& indices = lod_indices(sub_path);
+                if (!same_sub_path) {
+                    run.path_id = path_id;
+                    run.sub_path_id = sub_path_id;
+                    sub_path.lod_i_id = indices.size();
+                }
+                if (is_first_segment) {
+                    // starting cap triangles
+                    store_triangle(indices, first_v_offsets[0], first_v_offsets[2], first_v_offsets[1]);
+                    store_triangle(indices, first_v_offsets[0], first_v_offsets[3], first_v_offsets[2]);
+                }
+                sub_path.lod_i_count = indices.size() - sub_path.lod_i_id;
+                run.open = true;
+                run.first_v_offsets = first_v_offsets;
+                run.last_v_offsets = last_v_offsets;
+                run.positions.clear();
+                run.positions.push_back(prev.position);
+            }
+
+            if (next == nullptr || curr.type != next->type || !path.matches(*next)) {
+                // the path ends with the current segment
+                close_run();
+                if (next != nullptr) {
+                    // ending cap triangles
+                    IndexBuffer& indices = lod_indices(sub_path);
+                    store_triangle(indices, last_v_offsets[0], last_v_offsets[2], last_v_offsets[3]);
+                    store_triangle(indices, last_v_offsets[0], last_v_offsets[1], last_v_offsets[2]);
+                    sub_path.lod_i_count = indices.size() - sub_path.lod_i_id;
+                }
+            }
+    };
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
     // format data into the buffers to be rendered as instanced model
     auto add_model_instance = [](const GCodeProcessorResult::MoveVertex& curr, InstanceBuffer& instances, InstanceIdBuffer& instances_ids, size_t move_id) {
         // append position
@@ -1548,7 +1734,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
     auto start_time = std::chrono::high_resolution_clock::now();
-    m_statistics.results_size = SLIC3R_STDVEC_MEMSIZE(gcode_result.moves, GCodeProcessorResult::MoveVertex);
+    m_statistics.results_size = gcode_result.moves.memsize();
     m_statistics.results_time = gcode_result.time;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
@@ -1586,11 +1772,57 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
 
     m_sequential_view.gcode_ids.clear();
     for (size_t i = 0; i < gcode_result.moves.size(); ++i) {
-        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-        if (move.type != EMoveType::Seam)
-            m_sequential_view.gcode_ids.push_back(move.gcode_id);
+        if (gcode_result.moves.type(i) != EMoveType::Seam)
+            m_sequential_view.gcode_ids.push_back(gcode_result.moves.gcode_id(i));
     }
 
+    // layers zs / roles / extruder ids -> extract from result
+    // on a worker thread, while this thread generates the toolpaths buffers and sends them to gpu
+    Layers layers;
+    std::vector<ExtrusionRole> roles;
+    std::vector<unsigned char> extruder_ids;
+    tbb::task_group layers_task;
+    layers_task.run([&gcode_result, &layers, &roles, &extruder_ids, moves_count = m_moves_count]() {
+        size_t last_travel_s_id = 0;
+        size_t seams_count = 0;
+        for (size_t i = 0; i < moves_count; ++i) {
+            const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
+            if (move.type == EMoveType::Seam)
+                ++seams_count;
+
+            size_t move_id = i - seams_count;
+
+            if (move.type == EMoveType::Extrude) {
+                // layers zs
+                const double* const last_z = layers.empty() ? nullptr : &layers.get_zs().back();
+                const double z = static_cast<double>(move.position.z());
+                if (last_z == nullptr || z < *last_z - EPSILON || *last_z + EPSILON < z)
+                    layers.append(z, { last_travel_s_id, move_id });
+                else
+                    layers.get_endpoints().back().last = move_id;
+                // extruder ids
+                extruder_ids.emplace_back(move.extruder_id);
+                // roles
+                if (i > 0)
+                    roles.emplace_back(move.extrusion_role);
+            }
+            else if (move.type == EMoveType::Travel) {
+                if (move_id - last_travel_s_id > 1 && !layers.empty())
+                    layers.get_endpoints().back().last = move_id;
+
+                last_travel_s_id = move_id;
+            }
+        }
+
+        // roles -> remove duplicates
+        sort_remove_duplicates(roles);
+        roles.shrink_to_fit();
+
+        // extruder ids -> remove duplicates
+        sort_remove_duplicates(extruder_ids);
+        extruder_ids.shrink_to_fit();
+    });
+
     std::vector<MultiVertexBuffer> vertices(m_buffers.size());
     std::vector<MultiIndexBuffer> indices(m_buffers.size());
     std::vector<InstanceBuffer> instances(m_buffers.size());
@@ -1777,70 +2009,74 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         };
 
         const size_t vertex_size_floats = t_buffer.vertices.vertex_size_floats();
-        for (const Path& path : t_buffer.paths) {
-            // the two segments of the path sharing the current vertex may belong
-            // to two different vertex buffers
-            size_t prev_sub_path_id = 0;
-            size_t next_sub_path_id = 0;
-            const size_t path_vertices_count = path.vertices_count();
-            const float half_width = 0.5f * path.width;
-            for (size_t j = 1; j < path_vertices_count - 1; ++j) {
-                const size_t curr_s_id = path.sub_paths.front().first.s_id + j;
-                const size_t move_id = extract_move_id(curr_s_id);
-                const Vec3f& prev = gcode_result.moves[move_id - 1].position;
-                const Vec3f& curr = gcode_result.moves[move_id].position;
-                const Vec3f& next = gcode_result.moves[move_id + 1].position;
-
-                // select the subpaths which contains the previous/next segments
-                if (!path.sub_paths[prev_sub_path_id].contains(curr_s_id))
-                    ++prev_sub_path_id;
-                if (!path.sub_paths[next_sub_path_id].contains(curr_s_id + 1))
-                    ++next_sub_path_id;
-                const Path::Sub_Path& prev_sub_path = path.sub_paths[prev_sub_path_id];
-                const Path::Sub_Path& next_sub_path = path.sub_paths[next_sub_path_id];
-
-                const Vec3f prev_dir = (curr - prev).normalized();
-                const Vec3f prev_right = Vec3f(prev_dir.y(), -prev_dir.x(), 0.0f).normalized();
-                const Vec3f prev_up = prev_right.cross(prev_dir);
-
-                const Vec3f next_dir = (next - curr).normalized();
-
-                const bool is_right_turn = prev_up.dot(prev_dir.cross(next_dir)) <= 0.0f;
-                const float cos_dir = prev_dir.dot(next_dir);
-                // whether the angle between adjacent segments is greater than 45 degrees
-                const bool is_sharp = cos_dir < 0.7071068f;
-
-                float displacement = 0.0f;
-                if (cos_dir > -0.9998477f) {
-                    // if the angle between adjacent segments is smaller than 179 degrees
-                    const Vec3f med_dir = (prev_dir + next_dir).normalized();
-                    displacement = half_width * ::tan(::acos(std::clamp(next_dir.dot(med_dir), -1.0f, 1.0f)));
-                }
-
-                const float sq_prev_length = (curr - prev).squaredNorm();
-                const float sq_next_length = (next - curr).squaredNorm();
-                const float sq_displacement = sqr(displacement);
-                const bool can_displace = displacement > 0.0f && sq_displacement < sq_prev_length && sq_displacement < sq_next_length;
+        // the vertices of different paths do not overlap, so the paths are smoothed in parallel
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, t_buffer.paths.size()), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t path_id = range.begin(); path_id < range.end(); ++path_id) {
+                const Path& path = t_buffer.paths[path_id];
+                // the two segments of the path sharing the current vertex may belong
+                // to two different vertex buffers
+                size_t prev_sub_path_id = 0;
+                size_t next_sub_path_id = 0;
+                const size_t path_vertices_count = path.vertices_count();
+                const float half_width = 0.5f * path.width;
+                for (size_t j = 1; j < path_vertices_count - 1; ++j) {
+                    const size_t curr_s_id = path.sub_paths.front().first.s_id + j;
+                    const size_t move_id = extract_move_id(curr_s_id);
+                    const Vec3f& prev = gcode_result.moves.position(move_id - 1);
+                    const Vec3f& curr = gcode_result.moves.position(move_id);
+                    const Vec3f& next = gcode_result.moves.position(move_id + 1);
+
+                    // select the subpaths which contains the previous/next segments
+                    if (!path.sub_paths[prev_sub_path_id].contains(curr_s_id))
+                        ++prev_sub_path_id;
+                    if (!path.sub_paths[next_sub_path_id].contains(curr_s_id + 1))
+                        ++next_sub_path_id;
+                    const Path::Sub_Path& prev_sub_path = path.sub_paths[prev_sub_path_id];
+                    const Path::Sub_Path& next_sub_path = path.sub_paths[next_sub_path_id];
+
+                    const Vec3f prev_dir = (curr - prev).normalized();
+                    const Vec3f prev_right = Vec3f(prev_dir.y(), -prev_dir.x(), 0.0f).normalized();
+                    const Vec3f prev_up = prev_right.cross(prev_dir);
+
+                    const Vec3f next_dir = (next - curr).normalized();
+
+                    const bool is_right_turn = prev_up.dot(prev_dir.cross(next_dir)) <= 0.0f;
+                    const float cos_dir = prev_dir.dot(next_dir);
+                    // whether the angle between adjacent segments is greater than 45 degrees
+                    const bool is_sharp = cos_dir < 0.7071068f;
+
+                    float displacement = 0.0f;
+                    if (cos_dir > -0.9998477f) {
+                        // if the angle between adjacent segments is smaller than 179 degrees
+                        const Vec3f med_dir = (prev_dir + next_dir).normalized();
+                        displacement = half_width * ::tan(::acos(std::clamp(next_dir.dot(med_dir), -1.0f, 1.0f)));
+                    }
 
-                if (can_displace) {
-                    // displacement to apply to the vertices to match
-                    const Vec3f displacement_vec = displacement * prev_dir;
-                    // matches inner corner vertices
-                    if (is_right_turn)
-                        match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
-                    else
-                        match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
+                    const float sq_prev_length = (curr - prev).squaredNorm();
+                    const float sq_next_length = (next - curr).squaredNorm();
+                    const float sq_displacement = sqr(displacement);
+                    const bool can_displace = displacement > 0.0f && sq_displacement < sq_prev_length && sq_displacement < sq_next_length;
 
-                    if (!is_sharp) {
-                        // matches outer corner vertices
+                    if (can_displace) {
+                        // displacement to apply to the vertices to match
+                        const Vec3f displacement_vec = displacement * prev_dir;
+                        // matches inner corner vertices
                         if (is_right_turn)
-                            match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                            match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
                         else
-                            match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                            match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, -displacement_vec);
+
+                        if (!is_sharp) {
+                            // matches outer corner vertices
+                            if (is_right_turn)
+                                match_left_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                            else
+                                match_right_vertices(prev_sub_path, next_sub_path, curr_s_id, vertex_size_floats, displacement_vec);
+                        }
                     }
                 }
             }
-        }
+        });
     };
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
@@ -1943,6 +2179,11 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
     using VboIndexList = std::vector<unsigned int>;
     std::vector<VboIndexList> vbo_indices(m_buffers.size());
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    std::vector<MultiIndexBuffer> lod_indices(m_buffers.size());
+    std::vector<LodRun> lod_runs(m_buffers.size());
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
     seams_count = 0;
 
     for (size_t i = 0; i < m_moves_count; ++i) {
@@ -1959,9 +2200,9 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             continue;
 
         const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
-        const GCodeProcessorResult::MoveVertex* next = nullptr;
+        std::optional<GCodeProcessorResult::MoveVertex> next;
         if (i < m_moves_count - 1)
-            next = &gcode_result.moves[i + 1];
+            next = gcode_result.moves[i + 1];
 
         ++progress_count;
         if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
@@ -1988,7 +2229,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         // if adding the indices for the current segment exceeds the threshold size of the current index buffer
         // create another index buffer
         size_t indiced_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.indices_size_bytes() : t_buffer.max_indices_per_segment_size_bytes();
-        if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - indiced_size_to_add) {
+        if (i_multibuffer.back().size() * ibuffer_type_size() >= IBUFFER_THRESHOLD_BYTES - indiced_size_to_add) {
             i_multibuffer.push_back(IndexBuffer());
             vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
             if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::Point &&
@@ -2030,7 +2271,14 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             break;
         }
         case TBuffer::ERenderPrimitiveType::Triangle: {
-            add_indices_as_solid(prev, curr, next, t_buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id);
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            const size_t vbuffer_size = curr_vertex_buffer.second;
+            const size_t paths_count = t_buffer.paths.size();
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            add_indices_as_solid(prev, curr, next ? &(*next) : nullptr, t_buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id);
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            add_lod_indices_as_solid(prev, curr, next ? &(*next) : nullptr, t_buffer, vbuffer_size, t_buffer.paths.size() != paths_count, lod_indices[id], lod_runs[id]);
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
             break;
         }
         case TBuffer::ERenderPrimitiveType::BatchedModel: {
@@ -2055,7 +2303,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             const MultiIndexBuffer& i_multibuffer = indices[i];
             for (const IndexBuffer& i_buffer : i_multibuffer) {
                 const size_t size_elements = i_buffer.size();
-                const size_t size_bytes = size_elements * sizeof(IBufferType);
+                const size_t size_bytes = size_elements * ibuffer_type_size();
 
                 // stores index buffer informations into TBuffer
                 t_buffer.indices.push_back(IBuffer());
@@ -2071,12 +2319,32 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
 
                 glsafe(::glGenBuffers(1, &ibuf.ibo));
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibuf.ibo));
-                glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_bytes, i_buffer.data(), GL_STATIC_DRAW));
+                send_indices_to_gpu(i_buffer.data(), size_elements, s_32bit_indices);
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+                const size_t ibuffer_id = t_buffer.indices.size() - 1;
+                if (ibuffer_id < lod_indices[i].size() && !lod_indices[i][ibuffer_id].empty()) {
+                    const IndexBuffer& lod_buffer = lod_indices[i][ibuffer_id];
+                    const size_t lod_size_bytes = lod_buffer.size() * ibuffer_type_size();
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                    m_statistics.total_indices_gpu_size += static_cast<int64_t>(lod_size_bytes);
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+                    glsafe(::glGenBuffers(1, &ibuf.lod_ibo));
+                    glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibuf.lod_ibo));
+                    send_indices_to_gpu(lod_buffer.data(), lod_buffer.size(), s_32bit_indices);
+                    glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+                }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
             }
         }
     }
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    // dismiss level of detail indices data, no more needed
+    std::vector<MultiIndexBuffer>().swap(lod_indices);
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
     if (progress_dialog != nullptr) {
         progress_dialog->Update(100, "");
         progress_dialog->Fit();
@@ -2113,45 +2381,11 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
     // dismiss indices data, no more needed
     std::vector<MultiIndexBuffer>().swap(indices);
 
-    // layers zs / roles / extruder ids -> extract from result
-    size_t last_travel_s_id = 0;
-    seams_count = 0;
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-        if (move.type == EMoveType::Seam)
-            ++seams_count;
-
-        size_t move_id = i - seams_count;
-
-        if (move.type == EMoveType::Extrude) {
-            // layers zs
-            const double* const last_z = m_layers.empty() ? nullptr : &m_layers.get_zs().back();
-            const double z = static_cast<double>(move.position.z());
-            if (last_z == nullptr || z < *last_z - EPSILON || *last_z + EPSILON < z)
-                m_layers.append(z, { last_travel_s_id, move_id });
-            else
-                m_layers.get_endpoints().back().last = move_id;
-            // extruder ids
-            m_extruder_ids.emplace_back(move.extruder_id);
-            // roles
-            if (i > 0)
-                m_roles.emplace_back(move.extrusion_role);
-        }
-        else if (move.type == EMoveType::Travel) {
-            if (move_id - last_travel_s_id > 1 && !m_layers.empty())
-                m_layers.get_endpoints().back().last = move_id;
-
-            last_travel_s_id = move_id;
-        }
-    }
-
-    // roles -> remove duplicates
-    sort_remove_duplicates(m_roles);
-    m_roles.shrink_to_fit();
-
-    // extruder ids -> remove duplicates
-    sort_remove_duplicates(m_extruder_ids);
-    m_extruder_ids.shrink_to_fit();
+    // wait for the layers zs / roles / extruder ids extracted on the worker thread
+    layers_task.wait();
+    m_layers = std::move(layers);
+    m_roles = std::move(roles);
+    m_extruder_ids = std::move(extruder_ids);
 
 #if ENABLE_SPIRAL_VASE_LAYERS
     // replace layers for spiral vase mode
@@ -2458,9 +2692,8 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
 
                         // gets the vertex index from the index buffer on gpu
                         const IBuffer& i_buffer = buffer.indices[sub_path.first.b_id];
-                        unsigned int index = 0;
                         glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i_buffer.ibo));
-                        glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(offset * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&index)));
+                        const unsigned int index = get_indices_from_gpu(offset, 1, s_32bit_indices).front();
                         glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
                         // gets the position from the vertices buffer on gpu
@@ -2523,12 +2756,28 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
         default: { color = { 0.0f, 0.0f, 0.0f, 1.0f }; break; }
         }
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+        // the sub paths entirely contained into the sequential range are rendered using their level of detail, if active
+        const bool lod = m_lod_active && buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle &&
+            sub_path.lod_i_count > 0 && buffer.indices[ibuffer_id].lod_ibo > 0 &&
+            m_sequential_view.current.first <= sub_path.first.s_id && sub_path.last.s_id <= m_sequential_view.current.last;
+        RenderPath key{ tbuffer_id, color, static_cast<unsigned int>(ibuffer_id), lod, path_id };
+#else
         RenderPath key{ tbuffer_id, color, static_cast<unsigned int>(ibuffer_id), path_id };
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         if (render_path == nullptr || !RenderPathPropertyEqual()(*render_path, key)) {
             buffer.render_paths.emplace_back(key);
             render_path = const_cast<RenderPath*>(&buffer.render_paths.back());
         }
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+        if (lod) {
+            render_path->sizes.push_back(static_cast<unsigned int>(sub_path.lod_i_count));
+            render_path->offsets.push_back(sub_path.lod_i_id * ibuffer_type_size());
+            continue;
+        }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
         unsigned int delta_1st = 0;
         if (sub_path.first.s_id < m_sequential_view.current.first && m_sequential_view.current.first <= sub_path.last.s_id)
             delta_1st = static_cast<unsigned int>(m_sequential_view.current.first - sub_path.first.s_id);
@@ -2572,7 +2821,7 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
             }
         }
 
-        render_path->offsets.push_back(static_cast<size_t>((sub_path.first.i_id + delta_1st) * sizeof(IBufferType)));
+        render_path->offsets.push_back(static_cast<size_t>((sub_path.first.i_id + delta_1st) * ibuffer_type_size()));
 
 #if 0
         // check sizes and offsets against index buffer size on gpu
@@ -2580,7 +2829,7 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
         glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->indices[render_path->ibuffer_id].ibo));
         glsafe(::glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &buffer_size));
         glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-        if (render_path->offsets.back() + render_path->sizes.back() * sizeof(IBufferType) > buffer_size)
+        if (render_path->offsets.back() + render_path->sizes.back() * ibuffer_type_size() > buffer_size)
             BOOST_LOG_TRIVIAL(error) << "GCodeViewer::refresh_render_paths: Invalid render path data";
 #endif 
     }
@@ -2675,10 +2924,10 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
                 // extract indices from index buffer
                 std::array<IBufferType, 6> indices{ 0, 0, 0, 0, 0, 0 };
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i_buffer.ibo));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 0) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[0])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 7) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[1])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 1) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[2])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 13) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[4])));
+                indices[0] = get_indices_from_gpu(offset + 0, 1, s_32bit_indices).front();
+                indices[1] = get_indices_from_gpu(offset + 7, 1, s_32bit_indices).front();
+                indices[2] = get_indices_from_gpu(offset + 1, 1, s_32bit_indices).front();
+                indices[4] = get_indices_from_gpu(offset + 13, 1, s_32bit_indices).front();
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
                 indices[3] = indices[0];
                 indices[5] = indices[1];
@@ -2686,13 +2935,17 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
                 // send indices to gpu
                 glsafe(::glGenBuffers(1, &cap.ibo));
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cap.ibo));
-                glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(IBufferType), indices.data(), GL_STATIC_DRAW));
+                send_indices_to_gpu(indices.data(), indices.size(), s_32bit_indices);
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
                 // extract color from render path
-                size_t offset_bytes = offset * sizeof(IBufferType);
+                size_t offset_bytes = offset * ibuffer_type_size();
                 for (const RenderPath& render_path : buffer.render_paths) {
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+                    if (render_path.ibuffer_id == ibuffer_id && !render_path.lod) {
+#else
                     if (render_path.ibuffer_id == ibuffer_id) {
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
                         for (size_t j = 0; j < render_path.offsets.size(); ++j) {
                             if (render_path.contains(offset_bytes)) {
                                 cap.color = render_path.color;
@@ -2720,10 +2973,10 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
                 // extract indices from index buffer
                 std::array<IBufferType, 6> indices{ 0, 0, 0, 0, 0, 0 };
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, i_buffer.ibo));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 2) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[0])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 4) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[1])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 10) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[2])));
-                glsafe(::glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>((offset + 16) * sizeof(IBufferType)), static_cast<GLsizeiptr>(sizeof(IBufferType)), static_cast<void*>(&indices[5])));
+                indices[0] = get_indices_from_gpu(offset + 2, 1, s_32bit_indices).front();
+                indices[1] = get_indices_from_gpu(offset + 4, 1, s_32bit_indices).front();
+                indices[2] = get_indices_from_gpu(offset + 10, 1, s_32bit_indices).front();
+                indices[5] = get_indices_from_gpu(offset + 16, 1, s_32bit_indices).front();
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
                 indices[3] = indices[0];
                 indices[4] = indices[2];
@@ -2731,13 +2984,17 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
                 // send indices to gpu
                 glsafe(::glGenBuffers(1, &cap.ibo));
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cap.ibo));
-                glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(IBufferType), indices.data(), GL_STATIC_DRAW));
+                send_indices_to_gpu(indices.data(), indices.size(), s_32bit_indices);
                 glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
                 // extract color from render path
-                size_t offset_bytes = offset * sizeof(IBufferType);
+                size_t offset_bytes = offset * ibuffer_type_size();
                 for (const RenderPath& render_path : buffer.render_paths) {
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+                    if (render_path.ibuffer_id == ibuffer_id && !render_path.lod) {
+#else
                     if (render_path.ibuffer_id == ibuffer_id) {
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
                         for (size_t j = 0; j < render_path.offsets.size(); ++j) {
                             if (render_path.contains(offset_bytes)) {
                                 cap.color = render_path.color;
@@ -2784,6 +3041,17 @@ void GCodeViewer::render_toolpaths()
     float near_plane_height = camera.get_type() == Camera::EType::Perspective ? static_cast<float>(viewport[3]) / (2.0f * static_cast<float>(2.0 * std::tan(0.5 * Geometry::deg2rad(camera.get_fov())))) :
         static_cast<float>(viewport[3]) * 0.0005;
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    // use the level of detail of the toolpaths when zoomed out so much that the extrusions are thinner than a pixel
+    // (the inverse of the zoom is the size of a pixel at the camera target),
+    // so that the level of detail differs from the exact toolpaths by less than half a pixel
+    const bool lod_active = m_extrusions.ranges.width.max > 0.0f && camera.get_inv_zoom() > static_cast<double>(m_extrusions.ranges.width.max);
+    if (lod_active != m_lod_active) {
+        m_lod_active = lod_active;
+        refresh_render_paths(true, true);
+    }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
     auto shader_init_as_points = [zoom, point_size, near_plane_height](GLShaderProgram& shader) {
 #if ENABLE_FIXED_SCREEN_SIZE_POINT_MARKERS
         shader.set_uniform("use_fixed_screen_size", 1);
@@ -2811,7 +3079,7 @@ void GCodeViewer::render_toolpaths()
             assert(! path.sizes.empty());
             assert(! path.offsets.empty());
             glsafe(::glUniform4fv(uniform_color, 1, static_cast<const GLfloat*>(path.color.data())));
-            glsafe(::glMultiDrawElements(GL_POINTS, (const GLsizei*)path.sizes.data(), GL_UNSIGNED_SHORT, (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
+            glsafe(::glMultiDrawElements(GL_POINTS, (const GLsizei*)path.sizes.data(), ibuffer_gl_type(), (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
 #if ENABLE_GCODE_VIEWER_STATISTICS
             ++m_statistics.gl_multi_points_calls_count;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
@@ -2835,7 +3103,7 @@ void GCodeViewer::render_toolpaths()
             assert(! path.sizes.empty());
             assert(! path.offsets.empty());
             glsafe(::glUniform4fv(uniform_color, 1, static_cast<const GLfloat*>(path.color.data())));
-            glsafe(::glMultiDrawElements(GL_LINES, (const GLsizei*)path.sizes.data(), GL_UNSIGNED_SHORT, (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
+            glsafe(::glMultiDrawElements(GL_LINES, (const GLsizei*)path.sizes.data(), ibuffer_gl_type(), (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
 #if ENABLE_GCODE_VIEWER_STATISTICS
             ++m_statistics.gl_multi_lines_calls_count;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
@@ -2846,14 +3114,26 @@ void GCodeViewer::render_toolpaths()
 #if ENABLE_GCODE_VIEWER_STATISTICS
         this
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    ](std::vector<RenderPath>::iterator it_path, std::vector<RenderPath>::iterator it_end, const IBuffer& i_buffer, GLShaderProgram& shader, int uniform_color) {
+        // the exact index buffer is bound by the caller
+        bool lod = false;
+#else
     ](std::vector<RenderPath>::iterator it_path, std::vector<RenderPath>::iterator it_end, GLShaderProgram& shader, int uniform_color) {
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         for (auto it = it_path; it != it_end && it_path->ibuffer_id == it->ibuffer_id; ++it) {
             const RenderPath& path = *it;
             // Some OpenGL drivers crash on empty glMultiDrawElements, see GH #7415.
             assert(! path.sizes.empty());
             assert(! path.offsets.empty());
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            if (path.lod != lod) {
+                lod = path.lod;
+                glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod ? i_buffer.lod_ibo : i_buffer.ibo));
+            }
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
             glsafe(::glUniform4fv(uniform_color, 1, static_cast<const GLfloat*>(path.color.data())));
-            glsafe(::glMultiDrawElements(GL_TRIANGLES, (const GLsizei*)path.sizes.data(), GL_UNSIGNED_SHORT, (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
+            glsafe(::glMultiDrawElements(GL_TRIANGLES, (const GLsizei*)path.sizes.data(), ibuffer_gl_type(), (const void* const*)path.offsets.data(), (GLsizei)path.sizes.size()));
 #if ENABLE_GCODE_VIEWER_STATISTICS
             ++m_statistics.gl_multi_triangles_calls_count;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
@@ -2918,11 +3198,11 @@ void GCodeViewer::render_toolpaths()
                 if (range_range.intersects(buffer_range)) {
                     shader.set_uniform("uniform_color", range.color);
                     unsigned int offset = (range_range.first > buffer_range.first) ? range_range.first - buffer_range.first : 0;
-                    size_t offset_bytes = static_cast<size_t>(offset) * indices_per_instance * sizeof(IBufferType);
+                    size_t offset_bytes = static_cast<size_t>(offset) * indices_per_instance * ibuffer_type_size();
                     Range render_range = { std::max(range_range.first, buffer_range.first), std::min(range_range.last, buffer_range.last) };
                     size_t count = static_cast<size_t>(render_range.last - render_range.first) * indices_per_instance;
                     if (count > 0) {
-                        glsafe(::glDrawElements(GL_TRIANGLES, (GLsizei)count, GL_UNSIGNED_SHORT, (const void*)offset_bytes));
+                        glsafe(::glDrawElements(GL_TRIANGLES, (GLsizei)count, ibuffer_gl_type(), (const void*)offset_bytes));
 #if ENABLE_GCODE_VIEWER_STATISTICS
                         ++m_statistics.gl_batched_models_calls_count;
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
@@ -3008,7 +3288,11 @@ void GCodeViewer::render_toolpaths()
                         break;
                     }
                     case TBuffer::ERenderPrimitiveType::Triangle: {
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+                        render_as_triangles(it_path, buffer.render_paths.end(), i_buffer, *shader, uniform_color);
+#else
                         render_as_triangles(it_path, buffer.render_paths.end(), *shader, uniform_color);
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
                         break;
                     }
                     default: { break; }
@@ -3050,7 +3334,7 @@ void GCodeViewer::render_toolpaths()
             shader->set_uniform("uniform_color", cap.color);
 
             glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cap.ibo));
-            glsafe(::glDrawElements(GL_TRIANGLES, (GLsizei)cap.indices_count(), GL_UNSIGNED_SHORT, nullptr));
+            glsafe(::glDrawElements(GL_TRIANGLES, (GLsizei)cap.indices_count(), ibuffer_gl_type(), nullptr));
             glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
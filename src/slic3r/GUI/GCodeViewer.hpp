@@ -21,7 +21,15 @@ namespace GUI {
 
 class GCodeViewer
 {
-    using IBufferType = unsigned short;
+    // type of the indices generated for the index buffers
+    using IBufferType = unsigned int;
+    // whether the indices are sent to gpu as unsigned int or as unsigned short, detected in init()
+    // from the capabilities of the OpenGL driver
+    static bool s_32bit_indices;
+    // size of the indices stored into the index buffers on gpu
+    static size_t ibuffer_type_size() { return s_32bit_indices ? sizeof(unsigned int) : sizeof(unsigned short); }
+    // type of the indices stored into the index buffers on gpu
+    static unsigned int ibuffer_gl_type();
     using Color = std::array<float, 4>;
     using VertexBuffer = std::vector<float>;
     using MultiVertexBuffer = std::vector<VertexBuffer>;
@@ -71,9 +79,11 @@ class GCodeViewer
         size_t count{ 0 };
 
         size_t data_size_bytes() const { return count * vertex_size_bytes(); }
-        // We set 65536 as max count of vertices inside a vertex buffer to allow
-        // to use unsigned short in place of unsigned int for indices in the index buffer, to save memory
-        size_t max_size_bytes() const { return 65536 * vertex_size_bytes(); }
+        // With unsigned int indices the count of vertices inside a vertex buffer is limited only to keep the single buffers
+        // of a reasonable size, so that large G-codes are rendered with a few draw calls.
+        // Otherwise we set 65536 as max count of vertices inside a vertex buffer to allow
+        // to use unsigned short in place of unsigned int for indices in the index buffer
+        size_t max_size_bytes() const { return (s_32bit_indices ? 4 * 1024 * 1024 : 65536) * vertex_size_bytes(); }
 
         size_t vertex_size_floats() const { return position_size_floats() + normal_size_floats(); }
         size_t vertex_size_bytes() const { return vertex_size_floats() * sizeof(float); }
@@ -167,6 +177,10 @@ class GCodeViewer
         unsigned int vbo{ 0 };
         // ibo id
         unsigned int ibo{ 0 };
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+        // ibo id of the level of detail of the toolpaths, 0 if not available
+        unsigned int lod_ibo{ 0 };
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         // count of indices, updated after data are sent to gpu
         size_t count{ 0 };
 
@@ -194,6 +208,11 @@ class GCodeViewer
         {
             Endpoint first;
             Endpoint last;
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            // range of the indices of the sub path into the level of detail index buffer
+            size_t lod_i_id{ 0 };
+            size_t lod_i_count{ 0 };
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
 
             bool contains(size_t s_id) const {
                 return first.s_id <= s_id && s_id <= last.s_id;
@@ -249,6 +268,10 @@ class GCodeViewer
         Color                       color;
         // Index of the buffer in TBuffer::indices
         unsigned int                ibuffer_id;
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+        // Whether sizes and offsets refer to the level of detail index buffer
+        bool                        lod;
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         // Render path content
         // Index of the path in TBuffer::paths
         unsigned int                path_id;
@@ -256,7 +279,7 @@ class GCodeViewer
         std::vector<size_t>         offsets; // use size_t because we need an unsigned integer whose size matches pointer's size (used in the call glMultiDrawElements())
         bool contains(size_t offset) const {
             for (size_t i = 0; i < offsets.size(); ++i) {
-                if (offsets[i] <= offset && offset <= offsets[i] + static_cast<size_t>(sizes[i] * sizeof(IBufferType)))
+                if (offsets[i] <= offset && offset <= offsets[i] + static_cast<size_t>(sizes[i] * ibuffer_type_size()))
                     return true;
             }
             return false;
@@ -272,12 +295,22 @@ class GCodeViewer
                 else if (l.color[i] > r.color[i])
                     return false;
             }
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            if (l.ibuffer_id != r.ibuffer_id)
+                return l.ibuffer_id < r.ibuffer_id;
+            return l.lod < r.lod;
+#else
             return l.ibuffer_id < r.ibuffer_id;
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         }
     };
     struct RenderPathPropertyEqual {
         bool operator() (const RenderPath &l, const RenderPath &r) const {
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+            return l.tbuffer_id == r.tbuffer_id && l.ibuffer_id == r.ibuffer_id && l.lod == r.lod && l.color == r.color;
+#else
             return l.tbuffer_id == r.tbuffer_id && l.ibuffer_id == r.ibuffer_id && l.color == r.color;
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
         }
     };
 
@@ -345,7 +378,7 @@ class GCodeViewer
             default:                             { return 0; }
             }
         }
-        size_t indices_per_segment_size_bytes() const { return static_cast<size_t>(indices_per_segment() * sizeof(IBufferType)); }
+        size_t indices_per_segment_size_bytes() const { return static_cast<size_t>(indices_per_segment() * ibuffer_type_size()); }
         unsigned int max_indices_per_segment() const {
             switch (render_primitive_type)
             {
@@ -355,7 +388,7 @@ class GCodeViewer
             default:                             { return 0; }
             }
         }
-        size_t max_indices_per_segment_size_bytes() const { return max_indices_per_segment() * sizeof(IBufferType); }
+        size_t max_indices_per_segment_size_bytes() const { return max_indices_per_segment() * ibuffer_type_size(); }
 
         bool has_data() const {
             switch (render_primitive_type)
@@ -741,6 +774,12 @@ private:
 
     bool m_contained_in_bed{ true };
 
+#if ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+    // whether the toolpaths rendered with triangles are rendered using their level of detail,
+    // selected by the camera zoom in render_toolpaths()
+    mutable bool m_lod_active{ false };
+#endif // ENABLE_GCODE_VIEWER_TOOLPATHS_LOD
+
 public:
     GCodeViewer();
     ~GCodeViewer() { reset(); }
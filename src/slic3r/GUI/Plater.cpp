@@ -2065,6 +2065,8 @@ Plater::priv::priv(Plater *q, MainFrame *main_frame)
     this->q->SetFont(Slic3r::GUI::wxGetApp().normal_font());
 
     background_process.set_fff_print(&fff_print);
+    // The print is processed again after each change, reuse the perimeters of the layers not affected by the change.
+    fff_print.set_reuse_perimeters(true);
     background_process.set_sla_print(&sla_print);
     background_process.set_gcode_result(&gcode_result);
     background_process.set_thumbnail_cb([this](const ThumbnailsParams& params) { return this->generate_thumbnails(params, Camera::EType::Ortho); });
@@ -4077,6 +4079,10 @@ void Plater::priv::on_slicing_update(SlicingStatusEvent &evt)
 {
     //update dirty flags
 
+    if (0 != (evt.status.flags & Slic3r::PrintBase::SlicingStatus::FlagBits::PEAK_MEMORY)) {
+        // Already logged by PrintBase::report_peak_memory(), nothing to show.
+        return;
+    }
     if (0 != (evt.status.flags & Slic3r::PrintBase::SlicingStatus::FlagBits::GCODE_ENDED)) {
         notification_manager->set_slicing_progress_ended(_utf8(evt.status.main_text));
     } else {
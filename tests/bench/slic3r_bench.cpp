@@ -0,0 +1,391 @@
+// Benchmark of the FFF slicing pipeline.
+// Runs a fixed corpus of models through Print::process() and the G-code export, reports wall time and peak resident memory
+// of each PrintStep and PrintObjectStep and the time spent by GCode::process_layer() for each layer as JSON.
+// In addition, the shrink / grow / mask chain of the perimeter generator is timed on the sliced layers of each case
+// with the ClipperUtils free functions and with ClipperBatch.
+//
+// Usage: slic3r_bench [--output file.json] [--repeat N] [case_name ...]
+// If no case name is given, the whole corpus is run. The JSON is written to stdout if no output file is given.
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/GCode.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Utils.hpp"
+#include "libslic3r/libslic3r_version.h"
+
+#include "test_data.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Peak resident set size of the process in bytes. On Linux the peak may be reset by reset_peak_rss(),
+// thus the peak of each pipeline step could be measured. Elsewhere it is the peak since start of the process.
+size_t peak_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? size_t(pmc.PeakWorkingSetSize) : 0;
+#else
+  #ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);)
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return size_t(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+  #endif
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+  #ifdef __linux__
+    return size_t(usage.ru_maxrss) * 1024;
+  #else
+    return size_t(usage.ru_maxrss);
+  #endif
+#endif
+}
+
+// Reset the peak resident set size to the current resident set size. Returns false if not supported.
+bool reset_peak_rss()
+{
+#ifdef __linux__
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f == nullptr)
+        return false;
+    bool ok = fputs("5", f) >= 0;
+    return (fclose(f) == 0) && ok;
+#else
+    return false;
+#endif
+}
+
+struct StepRecord
+{
+    // Name of the PrintObject or empty for the Print steps.
+    std::string object;
+    std::string step;
+    double      seconds  { 0. };
+    size_t      peak_rss { 0 };
+};
+
+// Collects the timings of the Print and PrintObject steps reported by PrintBase::set_step_callback().
+// The steps may be nested (PrintObject::make_perimeters() slices the object), the peak memory of a nested step
+// is accounted to all the steps being active.
+// The steps of multiple objects run concurrently, thus the callback is called from multiple threads and it is serialized.
+// The peak memory is measured for the whole process, thus the peak memory of a step is the peak of the process while the step was active,
+// including the memory used by the steps of the other objects running at the same time. It is not the memory used by the step itself
+// unless a single object is sliced. Resetting the peak does not lose the peaks of the other active steps, they are updated just before.
+class StepProfiler
+{
+public:
+    explicit StepProfiler(bool peak_resettable) : m_peak_resettable(peak_resettable) {}
+
+    void operator()(const PrintBase::StepEvent &event) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t peak = peak_rss();
+        for (Active &active : m_active)
+            active.peak_rss = std::max(active.peak_rss, peak);
+        if (! event.done) {
+            if (m_peak_resettable)
+                reset_peak_rss();
+            m_active.push_back({ event.print_object, event.step, Clock::now(), m_peak_resettable ? peak_rss() : peak });
+        } else {
+            auto it = std::find_if(m_active.rbegin(), m_active.rend(), [&event](const Active &a){ return a.print_object == event.print_object && a.step == event.step; });
+            if (it == m_active.rend())
+                return;
+            const PrintObject *print_object = static_cast<const PrintObject*>(it->print_object);
+            StepRecord record;
+            if (print_object) {
+                record.object = print_object->model_object()->name;
+                record.step   = print_object_step_name(it->step);
+            } else
+                record.step   = print_step_name(it->step);
+            record.seconds  = std::chrono::duration<double>(Clock::now() - it->start).count();
+            record.peak_rss = it->peak_rss;
+            m_records.emplace_back(std::move(record));
+            m_active.erase(std::next(it).base());
+        }
+    }
+
+    // To be called after Print::process() and the G-code export finished.
+    const std::vector<StepRecord>& records() const { return m_records; }
+
+private:
+    static const char* print_step_name(int step) {
+        switch (PrintStep(step)) {
+        case psWipeTower:       return "psWipeTower";
+        case psSkirtBrim:       return "psSkirtBrim";
+        case psGCodeExport:     return "psGCodeExport";
+        default:                return "unknown";
+        }
+    }
+    static const char* print_object_step_name(int step) {
+        switch (PrintObjectStep(step)) {
+        case posSlice:          return "posSlice";
+        case posPerimeters:     return "posPerimeters";
+        case posPrepareInfill:  return "posPrepareInfill";
+        case posInfill:         return "posInfill";
+        case posIroning:        return "posIroning";
+        case posSupportMaterial:return "posSupportMaterial";
+        default:                return "unknown";
+        }
+    }
+
+    struct Active {
+        const PrintObjectBase *print_object;
+        int                    step;
+        Clock::time_point      start;
+        size_t                 peak_rss;
+    };
+    bool                    m_peak_resettable;
+    std::mutex              m_mutex;
+    std::vector<Active>     m_active;
+    std::vector<StepRecord> m_records;
+};
+
+struct BenchCase
+{
+    std::string                                         name;
+    std::function<std::vector<TriangleMesh>()>          meshes;
+    std::vector<ConfigBase::SetDeserializeItem>         config;
+};
+
+std::vector<TriangleMesh> test_meshes(std::initializer_list<TestMesh> ids)
+{
+    std::vector<TriangleMesh> out;
+    for (TestMesh id : ids)
+        out.emplace_back(mesh(id));
+    return out;
+}
+
+// The corpus. Keep the cases and their settings stable, otherwise the results are not comparable over time.
+std::vector<BenchCase> corpus()
+{
+    return {
+        { "cube_20x20x20",      [](){ return test_meshes({ TestMesh::cube_20x20x20 }); }, {} },
+        { "sphere_50mm",        [](){ return test_meshes({ TestMesh::sphere_50mm }); }, { { "fill_density", "20%" } } },
+        { "overhang_support",   [](){ return test_meshes({ TestMesh::overhang }); }, { { "support_material", 1 } } },
+        { "ipadstand_gyroid",   [](){ return test_meshes({ TestMesh::ipadstand }); }, { { "fill_pattern", "gyroid" }, { "fill_density", "40%" } } },
+        { "gt2_teeth",          [](){ return test_meshes({ TestMesh::gt2_teeth }); }, {} },
+        { "multi_object",       [](){ return test_meshes({ TestMesh::A, TestMesh::V, TestMesh::L, TestMesh::pyramid, TestMesh::bridge, TestMesh::two_hollow_squares }); }, {} },
+        // Generated stress meshes.
+        { "sphere_fine_1M",     [](){ return std::vector<TriangleMesh>{ TriangleMesh(its_make_sphere(40., 2. * PI / 1000.)) }; }, { { "layer_height", 0.1 } } },
+        { "cube_grid_64",       [](){
+            std::vector<TriangleMesh> out;
+            for (size_t i = 0; i < 64; ++ i)
+                out.emplace_back(its_make_cube(8., 8., 4. + double(i % 8)));
+            return out;
+        }, {} },
+    };
+}
+
+std::string json_escape(const std::string &s)
+{
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\t': out += "\\t";  break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", int(c));
+                out += buf;
+            } else
+                out += c;
+        }
+    }
+    return out;
+}
+
+struct ClipperChainRecord
+{
+    size_t num_layers        { 0 };
+    double functions_seconds { 0. };
+    double batch_seconds     { 0. };
+};
+
+// Time the chain shrinking, growing back and masking the layer islands, which is used for the external perimeters,
+// once with the free functions converting to ExPolygons after each operation and once with a single ClipperBatch.
+ClipperChainRecord time_clipper_chain(const Print &print)
+{
+    std::vector<const ExPolygons*> islands;
+    for (const PrintObject *object : print.objects())
+        for (const Layer *layer : object->layers())
+            islands.emplace_back(&layer->lslices);
+    const double shrink = scale_(0.45);
+    const double grow   = scale_(0.2);
+    const double mask   = scale_(0.2);
+
+    ClipperChainRecord out;
+    out.num_layers = islands.size();
+    size_t num_functions = 0;
+    auto t_start = Clock::now();
+    for (const ExPolygons *expolygons : islands)
+        num_functions += intersection_ex(offset2_ex(*expolygons, - shrink, grow, jtMiter, 3), offset_ex(*expolygons, - mask, jtMiter, 3)).size();
+    auto t_functions = Clock::now();
+    size_t num_batch = 0;
+    for (const ExPolygons *expolygons : islands)
+        num_batch += ClipperBatch(*expolygons).offset(- shrink, jtMiter, 3).offset(grow, jtMiter, 3)
+            .intersection(ClipperBatch(*expolygons).offset(- mask, jtMiter, 3)).expolygons().size();
+    auto t_batch = Clock::now();
+    if (num_functions != num_batch)
+        std::cerr << "Warning: ClipperBatch produced " << num_batch << " islands, the free functions " << num_functions << std::endl;
+    out.functions_seconds = std::chrono::duration<double>(t_functions - t_start).count();
+    out.batch_seconds     = std::chrono::duration<double>(t_batch - t_functions).count();
+    return out;
+}
+
+// Run a single case, append its JSON object to out.
+void run_case(const BenchCase &bench_case, int run, std::ostream &out)
+{
+    Print print;
+    Model model;
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    for (const ConfigBase::SetDeserializeItem &item : bench_case.config)
+        config.set_deserialize_strict(item.opt_key, item.opt_value, item.append);
+    std::vector<TriangleMesh> meshes = bench_case.meshes();
+    size_t num_triangles = 0;
+    for (const TriangleMesh &m : meshes)
+        num_triangles += m.facets_count();
+    init_print(std::move(meshes), print, model, config);
+
+    StepProfiler profiler(reset_peak_rss());
+    print.set_step_callback([&profiler](const PrintBase::StepEvent &event) { profiler(event); });
+
+    std::vector<std::pair<coordf_t, double>> layer_times;
+    boost::filesystem::path temp = boost::filesystem::unique_path();
+    auto t_start = Clock::now();
+    print.process();
+    auto t_processed = Clock::now();
+    {
+        GCode gcode;
+        gcode.set_process_layer_times(&layer_times);
+        gcode.do_export(&print, temp.string().c_str());
+    }
+    auto t_exported = Clock::now();
+    boost::system::error_code ec;
+    uintmax_t gcode_size = boost::filesystem::file_size(temp, ec);
+    boost::filesystem::remove(temp, ec);
+    ClipperChainRecord clipper_chain = time_clipper_chain(print);
+
+    out << "    {\n"
+        << "      \"name\": \"" << json_escape(bench_case.name) << "\",\n"
+        << "      \"run\": " << run << ",\n"
+        << "      \"objects\": " << print.objects().size() << ",\n"
+        << "      \"triangles\": " << num_triangles << ",\n"
+        << "      \"process_seconds\": " << std::chrono::duration<double>(t_processed - t_start).count() << ",\n"
+        << "      \"export_seconds\": " << std::chrono::duration<double>(t_exported - t_processed).count() << ",\n"
+        << "      \"gcode_bytes\": " << (ec ? 0 : gcode_size) << ",\n"
+        << "      \"peak_rss\": " << peak_rss() << ",\n"
+        << "      \"clipper_chain\": { \"layers\": " << clipper_chain.num_layers << ", \"functions_seconds\": " << clipper_chain.functions_seconds
+        << ", \"batch_seconds\": " << clipper_chain.batch_seconds << " },\n"
+        << "      \"steps\": [";
+    const std::vector<StepRecord> &records = profiler.records();
+    for (size_t i = 0; i < records.size(); ++ i) {
+        const StepRecord &r = records[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "        { \"object\": " << (r.object.empty() ? std::string("null") : "\"" + json_escape(r.object) + "\"")
+            << ", \"step\": \"" << r.step << "\", \"seconds\": " << r.seconds << ", \"peak_rss\": " << r.peak_rss << " }";
+    }
+    out << (records.empty() ? "],\n" : "\n      ],\n");
+    out << "      \"process_layer\": [";
+    for (size_t i = 0; i < layer_times.size(); ++ i)
+        out << (i == 0 ? "\n" : ",\n") << "        { \"print_z\": " << layer_times[i].first << ", \"seconds\": " << layer_times[i].second << " }";
+    out << (layer_times.empty() ? "]\n" : "\n      ]\n") << "    }";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string              output_path;
+    int                      repeat = 1;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; ++ i) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output_path = argv[++ i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++ i]));
+        else if (strcmp(argv[i], "--help") == 0 || argv[i][0] == '-') {
+            std::cout << "Usage: slic3r_bench [--output file.json] [--repeat N] [case_name ...]" << std::endl << "Cases:";
+            for (const BenchCase &c : corpus())
+                std::cout << " " << c.name;
+            std::cout << std::endl;
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        } else
+            selected.emplace_back(argv[i]);
+    }
+
+    // Only report errors, the benchmark output shall not be mixed with the slicer log.
+    set_logging_level(1);
+
+    std::vector<BenchCase> cases = corpus();
+    if (! selected.empty()) {
+        std::vector<BenchCase> filtered;
+        for (const std::string &name : selected) {
+            auto it = std::find_if(cases.begin(), cases.end(), [&name](const BenchCase &c){ return c.name == name; });
+            if (it == cases.end()) {
+                std::cerr << "Unknown benchmark case: " << name << std::endl;
+                return 1;
+            }
+            filtered.emplace_back(*it);
+        }
+        cases = std::move(filtered);
+    }
+
+    std::ostringstream json;
+    json.precision(6);
+    json << "{\n  \"version\": \"" << SLIC3R_VERSION << "\",\n  \"cases\": [\n";
+    bool first = true;
+    for (const BenchCase &bench_case : cases)
+        for (int run = 0; run < repeat; ++ run) {
+            if (! first)
+                json << ",\n";
+            first = false;
+            std::cerr << "Running " << bench_case.name << " (" << run + 1 << "/" << repeat << ")" << std::endl;
+            run_case(bench_case, run, json);
+        }
+    json << "\n  ]\n}\n";
+
+    if (output_path.empty())
+        std::cout << json.str();
+    else {
+        std::ofstream file(output_path, std::ios::binary);
+        file << json.str();
+        if (! file) {
+            std::cerr << "Failed to write " << output_path << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
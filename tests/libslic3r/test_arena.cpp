@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Arena.hpp"
+#include "libslic3r/Point.hpp"
+
+#include <tbb/parallel_for.h>
+
+using namespace Slic3r;
+
+using ArenaPoints = ArenaVector<Point>;
+
+SCENARIO("Arena allocated points", "[Arena]") {
+    GIVEN("No active ArenaScope") {
+        THEN("Points are allocated from the heap") {
+            ArenaPoints pts { { 1, 2 }, { 3, 4 } };
+            REQUIRE(MonotonicArena::current() == nullptr);
+            REQUIRE(pts.get_allocator().arena() == nullptr);
+        }
+    }
+    GIVEN("An active ArenaScope") {
+        ArenaScope scope;
+        MonotonicArena *arena = MonotonicArena::current();
+        REQUIRE(arena != nullptr);
+        WHEN("Points are allocated and released") {
+            // Make sure the arena owns a memory block, thus the mark points into it.
+            ArenaPoints first(1, Point(0, 0));
+            MonotonicArena::Mark mark = arena->mark();
+            {
+                ArenaPoints pts;
+                for (int i = 0; i < 100000; ++ i)
+                    pts.emplace_back(i, - i);
+                REQUIRE(pts.get_allocator().arena() == arena);
+                REQUIRE(pts[99999] == Point(99999, -99999));
+            }
+            THEN("A nested scope returns its memory to the arena") {
+                const Point *nested_data = nullptr;
+                {
+                    ArenaScope nested;
+                    REQUIRE(MonotonicArena::current() == arena);
+                    ArenaPoints pts(1000, Point(1, 1));
+                    nested_data = pts.data();
+                }
+                ArenaPoints pts(1000, Point(2, 2));
+                REQUIRE(pts.data() == nested_data);
+                REQUIRE(pts.front() == Point(2, 2));
+                REQUIRE(MonotonicArena::current() == arena);
+            }
+            THEN("Rewinding allows to reuse the memory") {
+                arena->rewind(mark);
+                ArenaPoints pts(10, Point(3, 3));
+                REQUIRE(reinterpret_cast<const char*>(pts.data()) == mark.ptr);
+            }
+            THEN("Rewinding allows to reuse the blocks allocated after the mark") {
+                arena->rewind(mark);
+                void *large = arena->allocate(1024 * 1024, 8);
+                arena->rewind(mark);
+                REQUIRE(arena->allocate(1024 * 1024, 8) == large);
+            }
+        }
+        WHEN("Large and aligned blocks are allocated") {
+            void *large = arena->allocate(10 * 1024 * 1024, 64);
+            void *small = arena->allocate(3, 1);
+            void *aligned = arena->allocate(16, 32);
+            THEN("The allocations are aligned and do not overlap") {
+                REQUIRE(reinterpret_cast<uintptr_t>(large) % 64 == 0);
+                REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 32 == 0);
+                REQUIRE((static_cast<char*>(small) >= static_cast<char*>(large) + 10 * 1024 * 1024 || static_cast<char*>(small) + 3 <= large));
+            }
+        }
+    }
+    GIVEN("Scopes active on multiple threads") {
+        std::vector<size_t> sums(256, 0);
+        tbb::parallel_for(size_t(0), sums.size(), [&sums](size_t i) {
+            ArenaScope scope;
+            ArenaPoints pts;
+            for (size_t j = 0; j <= i * 100; ++ j)
+                pts.emplace_back(coord_t(j), coord_t(i));
+            size_t sum = 0;
+            for (const Point &pt : pts)
+                sum += size_t(pt.x() + pt.y());
+            sums[i] = sum;
+        });
+        THEN("Each thread uses its own arena") {
+            for (size_t i = 0; i < sums.size(); ++ i) {
+                size_t n = i * 100 + 1;
+                REQUIRE(sums[i] == n * (n - 1) / 2 + n * i);
+            }
+        }
+    }
+}
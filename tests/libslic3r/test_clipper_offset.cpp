@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <iostream>
+#include <numeric>
 #include <boost/filesystem.hpp>
 
 #include "libslic3r/ClipperUtils.hpp"
@@ -212,3 +213,72 @@ SCENARIO("Constant offset", "[ClipperUtils]") {
 		}
 	}
 }
+
+SCENARIO("Batched Clipper operations", "[ClipperUtils]") {
+	int32_t s = 1000000;
+	GIVEN("Overlapping rectangles and a clip splitting them into islands") {
+		auto rectangle = [s](int x0, int y0, int x1, int y1) {
+			return Polygon{ Vec2crd{ x0 * s, y0 * s }, Vec2crd{ x1 * s, y0 * s }, Vec2crd{ x1 * s, y1 * s }, Vec2crd{ x0 * s, y1 * s } };
+		};
+		ExPolygons input = union_ex(Polygons{ rectangle(2, 10, 10, 15), rectangle(10, 7, 11, 18), rectangle(7, 3, 11, 4), rectangle(18, 2, 22, 4) });
+		Polygons   clip { rectangle(10, 14, 16, 20), rectangle(10, 9, 17, 13), rectangle(16, 10, 20, 11) };
+		WHEN("The difference is shrunk") {
+			ExPolygons reference = offset_ex(diff_ex(input, clip, ApplySafetyOffset::Yes), - 0.2 * s);
+			ExPolygons batched   = ClipperBatch(input).diff(clip, ApplySafetyOffset::Yes).offset(- 0.2 * s).expolygons();
+			THEN("The result matches offset_ex(diff_ex())") {
+				REQUIRE(batched == reference);
+			}
+		}
+		WHEN("The difference is shrunk, grown back and united with a shrunk difference") {
+			ExPolygons reference = union_ex(offset2_ex(diff_ex(input, clip, ApplySafetyOffset::Yes), - 0.4 * s, 0.2 * s), offset_ex(diff_ex(input, clip, ApplySafetyOffset::Yes), - 0.3 * s));
+			ExPolygons batched   = ClipperBatch(input).diff(clip, ApplySafetyOffset::Yes).offset(- 0.4 * s).offset(0.2 * s)
+				.union_(ClipperBatch(input).diff(clip, ApplySafetyOffset::Yes).offset(- 0.3 * s)).expolygons();
+			THEN("The result matches the chain of free functions") {
+				REQUIRE(batched == reference);
+			}
+		}
+	}
+	GIVEN("20mm box with a 10mm hole and a thin 20x0.6mm wall next to it") {
+		ExPolygon box20mm;
+		box20mm.contour.points = { Vec2crd{ 0, 0 }, Vec2crd{ 20 * s, 0 }, Vec2crd{ 20 * s, 20 * s }, Vec2crd{ 0, 20 * s } };
+		box20mm.holes.emplace_back(Points{ Vec2crd{ 5 * s, 5 * s }, Vec2crd{ 5 * s, 15 * s }, Vec2crd{ 15 * s, 15 * s }, Vec2crd{ 15 * s, 5 * s } });
+		ExPolygon wall;
+		wall.contour.points = { Vec2crd{ 21 * s, 0 }, Vec2crd{ 21 * s + 600000, 0 }, Vec2crd{ 21 * s + 600000, 20 * s }, Vec2crd{ 21 * s, 20 * s } };
+		ExPolygons input { box20mm, wall };
+		auto area = [](const ExPolygons &expolys) { return std::accumulate(expolys.begin(), expolys.end(), 0., [](double a, const ExPolygon &e) { return a + e.area(); }); };
+		WHEN("Shrinking and growing back") {
+			ExPolygons reference = offset2_ex(input, - 0.5 * s, 0.3 * s);
+			ExPolygons batched   = ClipperBatch(input).offset(- 0.5 * s).offset(0.3 * s).expolygons();
+			THEN("The result matches offset2_ex()") {
+				REQUIRE(batched == reference);
+				REQUIRE(batched.size() == 1);
+			}
+		}
+		WHEN("Shrinking, growing back and masking by a shrunk input") {
+			ExPolygons reference = intersection_ex(offset2_ex(input, - 0.5 * s, 0.4 * s), offset_ex(input, - 0.2 * s));
+			ExPolygons batched   = ClipperBatch(input).offset(- 0.5 * s).offset(0.4 * s).intersection(ClipperBatch(input).offset(- 0.2 * s)).expolygons();
+			THEN("The result matches the chain of free functions") {
+				REQUIRE(batched.size() == reference.size());
+				REQUIRE(area(batched) == Approx(area(reference)));
+			}
+		}
+		WHEN("Subtracting a grown input from the input") {
+			ExPolygons reference = diff_ex(input, offset_ex(offset_ex(input, - 0.4 * s), 0.45 * s), ApplySafetyOffset::Yes);
+			ExPolygons batched   = ClipperBatch(input).diff(ClipperBatch(input).offset(- 0.4 * s).offset(0.45 * s), ApplySafetyOffset::Yes).expolygons();
+			THEN("The thin wall remains") {
+				REQUIRE(batched.size() == reference.size());
+				REQUIRE(area(batched) == Approx(area(reference)));
+				REQUIRE(area(batched) == Approx(wall.area()).epsilon(0.05));
+			}
+		}
+		WHEN("Uniting the input with another polygon") {
+			Polygons other { Polygon{ Vec2crd{ 19 * s, 0 }, Vec2crd{ 22 * s, 0 }, Vec2crd{ 22 * s, 1 * s }, Vec2crd{ 19 * s, 1 * s } } };
+			ExPolygons reference = union_ex(input, union_ex(other));
+			ExPolygons batched   = ClipperBatch(input).union_(other).expolygons();
+			THEN("The result matches union_ex()") {
+				REQUIRE(batched.size() == reference.size());
+				REQUIRE(area(batched) == Approx(area(reference)));
+			}
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Surface.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Fill/FillAdaptive.hpp"
+
+using namespace Slic3r;
+
+SCENARIO("Adaptive cubic infill octree", "[Fill]") {
+    GIVEN("A 13mm cube aligned with the octree") {
+        const indexed_triangle_set mesh = its_make_cube(13., 13., 13.);
+        WHEN("The octree is built with 0.5mm line spacing") {
+            // The cube edges are 1, 2, 4, 8 and 16mm, the root cube is centered at the center of the mesh.
+            FillAdaptive::OctreePtr octree = FillAdaptive::build_octree(mesh, {}, 0.5, false);
+            THEN("The cubes intersecting the faces of the mesh are created at each depth") {
+                // Along each axis, A cubes of an edge length overlap the mesh, B of them are strictly inside the mesh:
+                // A^3 - B^3 cubes intersect the faces of the mesh.
+                auto num_cubes = [](size_t A, size_t B) { return A * A * A - B * B * B; };
+                REQUIRE(FillAdaptive::octree_cubes_per_depth(*octree) == std::vector<size_t>{
+                    num_cubes(14, 12), num_cubes(8, 6), num_cubes(4, 2), num_cubes(2, 0), 1 });
+            }
+        }
+    }
+    GIVEN("A mesh smaller than the smallest cube") {
+        const indexed_triangle_set mesh = its_make_cube(0.5, 0.5, 0.5);
+        THEN("The octree contains the root cube only") {
+            FillAdaptive::OctreePtr octree = FillAdaptive::build_octree(mesh, {}, 0.5, false);
+            REQUIRE(FillAdaptive::octree_cubes_per_depth(*octree) == std::vector<size_t>{ 1 });
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/EdgeGrid.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/Surface.hpp"
+#include "libslic3r/Fill/Lightning/DistanceField.hpp"
+#include "libslic3r/Fill/Lightning/Generator.hpp"
+#include "libslic3r/Fill/Lightning/TreeNode.hpp"
+
+#include <test_data.hpp>
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+using namespace Slic3r::FillLightning;
+
+// Generator propagating the trees layer by layer without preparing the layers in parallel bands,
+// as the trees were generated before the banded preparation was introduced.
+class SerialGenerator : public Generator
+{
+public:
+    SerialGenerator(const PrintObject &print_object) : Generator(print_object)
+    {
+        m_lightning_layers.clear();
+        m_lightning_layers.resize(print_object.layers().size());
+
+        std::vector<Polygons> infill_outlines(print_object.layers().size());
+        for (size_t layer_id = 0; layer_id < print_object.layers().size(); ++ layer_id)
+            for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
+                for (const Surface &surface : layerm->fill_surfaces.surfaces)
+                    if (surface.surface_type == (stPosInternal | stDensSparse))
+                        append(infill_outlines[layer_id], offset(surface.expolygon, - coord_t(m_infill_extrusion_width)));
+
+        auto create_locator = [](const Polygons &outlines) {
+            auto locator = std::make_unique<EdgeGrid::Grid>(get_extents(outlines).inflated(SCALED_EPSILON));
+            locator->create(outlines, locator_cell_size);
+            return locator;
+        };
+        std::unique_ptr<EdgeGrid::Grid> outlines_locator = create_locator(infill_outlines.back());
+        for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; -- layer_id) {
+            FillLightning::Layer &layer = m_lightning_layers[layer_id];
+            DistanceField         distance_field(m_supporting_radius, infill_outlines[layer_id], m_overhang_per_layer[layer_id]);
+            std::vector<NodeSPtr> to_be_reconnected_tree_roots = layer.tree_roots;
+            layer.generateNewTrees(distance_field, *outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+            layer.reconnectRoots(to_be_reconnected_tree_roots, *outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+            if (layer_id == 0)
+                break;
+            outlines_locator = create_locator(infill_outlines[layer_id - 1]);
+            for (NodeSPtr &tree : layer.tree_roots)
+                tree->propagateToNextLayer(m_lightning_layers[layer_id - 1].tree_roots, infill_outlines[layer_id - 1], *outlines_locator,
+                    m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        }
+    }
+};
+
+// Locations of the nodes of all trees of a layer, tree by tree in the order of their traversal.
+static std::vector<Points> tree_nodes(const FillLightning::Layer &layer)
+{
+    std::vector<Points> out;
+    for (const NodeSPtr &root : layer.tree_roots) {
+        out.emplace_back();
+        root->visitNodes([&out](NodeSPtr node) { out.back().emplace_back(node->getLocation()); });
+    }
+    return out;
+}
+
+SCENARIO("Lightning infill trees generated in bands of layers", "[Fill]") {
+    GIVEN("A sliced model with internal overhangs") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "first_layer_height",  0.2 },
+            { "layer_height",        0.2 },
+            { "fill_density",        "15%" },
+            // The generator does not resolve the automatic extrusion width.
+            { "infill_extrusion_width", 0.45 }
+        });
+        Model  model;
+        Print  print;
+        init_print({ TestMesh::overhang }, print, model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+
+        WHEN("The lightning trees are generated") {
+            Generator       generator(object);
+            SerialGenerator serial(object);
+            THEN("Some layers are supported by trees") {
+                size_t num_supported = 0;
+                for (size_t layer_id = 0; layer_id < object.layers().size(); ++ layer_id)
+                    num_supported += ! generator.getTreesForLayer(layer_id).tree_roots.empty();
+                REQUIRE(num_supported > 0);
+            }
+            THEN("The trees are the same as those propagated layer by layer") {
+                for (size_t layer_id = 0; layer_id < object.layers().size(); ++ layer_id)
+                    REQUIRE(tree_nodes(generator.getTreesForLayer(layer_id)) == tree_nodes(serial.getTreesForLayer(layer_id)));
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+
+#include <test_data.hpp>
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+SCENARIO("Print: Releasing the layers on G-code export", "[Print]") {
+    GIVEN("20mm cube with support material") {
+        auto init = [](Slic3r::Print &print, Slic3r::Model &model) {
+            Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, {
+                { "support_material",   1 },
+                { "raft_layers",        2 }
+            });
+        };
+        // Drop the line with the time stamp.
+        auto gcode_without_header = [](Slic3r::Print &print) {
+            std::string gcode = Slic3r::Test::gcode(print);
+            size_t pos = gcode.find("generated by");
+            return pos == std::string::npos ? gcode : gcode.erase(pos, gcode.find('\n', pos) - pos);
+        };
+        // Reference G-code exported by another Print, as a G-code export step already done is not started again.
+        Slic3r::Print reference;
+        Slic3r::Model reference_model;
+        init(reference, reference_model);
+        const std::string gcode = gcode_without_header(reference);
+        Slic3r::Print print;
+        Slic3r::Model model;
+        init(print, model);
+        WHEN("The G-code is exported with the layers released") {
+            print.set_release_layers_on_export(true);
+            const std::string gcode_released = gcode_without_header(print);
+            THEN("The G-code is the same") {
+                REQUIRE(gcode_released == gcode);
+            }
+            THEN("The extrusions are freed and their steps invalidated") {
+                for (const Layer *layer : print.objects().front()->layers())
+                    for (const LayerRegion *layerm : layer->regions())
+                        REQUIRE((layerm->perimeters.empty() && layerm->fills.empty()));
+                for (const SupportLayer *layer : print.objects().front()->support_layers())
+                    REQUIRE(layer->support_fills.empty());
+                REQUIRE(! print.is_step_done(posPerimeters));
+                REQUIRE(! print.is_step_done(posSupportMaterial));
+            }
+            THEN("Processing the print again generates the same G-code") {
+                print.set_release_layers_on_export(false);
+                REQUIRE(gcode_without_header(print) == gcode);
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/Utils.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+struct ParsedLine {
+    std::string raw;
+    float       x, y, z, e;
+    bool operator==(const ParsedLine &rhs) const { return raw == rhs.raw && x == rhs.x && y == rhs.y && z == rhs.z && e == rhs.e; }
+};
+
+static std::vector<ParsedLine> parse(const std::string &gcode, std::vector<size_t> *lines_ends = nullptr, size_t quit_after = size_t(-1))
+{
+    std::vector<ParsedLine> out;
+    GCodeReader reader;
+    auto callback = [&out, quit_after](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        out.push_back({ line.raw(), reader.x(), reader.y(), reader.z(), reader.e() });
+        if (out.size() == quit_after)
+            reader.quit_parsing();
+    };
+    if (lines_ends == nullptr) {
+        reader.parse_buffer(gcode, callback);
+    } else {
+        boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        ScopeGuard remove_temp([&temp]() { boost::nowide::remove(temp.string().c_str()); });
+        {
+            boost::nowide::ofstream f(temp.string(), std::ios::binary);
+            f << gcode;
+        }
+        reader.parse_file(temp.string(), callback, *lines_ends);
+    }
+    return out;
+}
+
+SCENARIO("GCodeReader parses a file the same way as a buffer", "[GCodeReader]") {
+    // Large enough to be split into multiple chunks, mixing line ends and empty lines.
+    std::string gcode = "G28 ; home\r\nG92 E0\n\n";
+    for (int i = 0; i < 40000; ++ i)
+        gcode += "G1 X" + std::to_string(i % 200) + ".5 Y" + std::to_string(i % 170) + " E" + std::to_string(i) + ".25 ; extrude\n" +
+                 (i % 7 == 0 ? "\r\n" : "") + (i % 1000 == 0 ? "G1 Z" + std::to_string(i / 1000) + "\r\n" : "");
+    std::vector<size_t> expected_ends;
+    for (size_t i = 0; i < gcode.size(); ++ i)
+        if (gcode[i] == '\n')
+            expected_ends.emplace_back(i + 1);
+
+    GIVEN("A file terminated by a newline") {
+        std::vector<size_t> lines_ends;
+        std::vector<ParsedLine> from_file = parse(gcode, &lines_ends);
+        THEN("The same lines and positions are reported") {
+            REQUIRE(from_file.size() > 40000);
+            REQUIRE(from_file == parse(gcode));
+        }
+        THEN("The line ends are reported") {
+            REQUIRE(lines_ends == expected_ends);
+        }
+    }
+    GIVEN("A file with the last line not terminated by a newline") {
+        gcode += "G1 X1 Y2 Z3";
+        std::vector<size_t> lines_ends;
+        std::vector<ParsedLine> from_file = parse(gcode, &lines_ends);
+        THEN("The last line is parsed") {
+            REQUIRE(from_file.back().raw == "G1 X1 Y2 Z3");
+            REQUIRE(from_file == parse(gcode));
+            REQUIRE(lines_ends == expected_ends);
+        }
+    }
+    GIVEN("A callback calling quit_parsing()") {
+        std::vector<size_t> lines_ends;
+        std::vector<ParsedLine> from_file = parse(gcode, &lines_ends, 30000);
+        THEN("No more lines are parsed") {
+            REQUIRE(from_file.size() == 30000);
+        }
+    }
+}
+
+static std::vector<ParsedLine> parse_tokenized(const std::string &gcode)
+{
+    std::vector<ParsedLine> out;
+    GCodeReader reader;
+    std::vector<GCodeReader::GCodeLine> lines;
+    reader.tokenize_buffer(gcode, lines);
+    reader.parse_tokenized(lines, [&out](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        out.push_back({ line.raw(), reader.x(), reader.y(), reader.z(), reader.e() });
+    });
+    return out;
+}
+
+SCENARIO("GCodeReader parses tokenized lines the same way as a buffer", "[GCodeReader]") {
+    GIVEN("G-code mixing line ends, empty lines and comments") {
+        std::string gcode = "G28 ; home\r\nG92 E0\n\n\r;TYPE:Perimeter\nG1 X10.5 Y2 E0.25\nG1 Z0.3 F1200 ; lift\nM106 S255\nG1 X3";
+        THEN("The same lines and positions are reported") {
+            std::vector<ParsedLine> lines = parse_tokenized(gcode);
+            REQUIRE(lines.size() == 9);
+            REQUIRE(lines.back().raw == "G1 X3");
+            REQUIRE(lines.back().z == 0.3f);
+            REQUIRE(lines == parse(gcode));
+        }
+    }
+}
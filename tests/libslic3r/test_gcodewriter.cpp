@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCodeWriter.hpp"
+#include "libslic3r/LocalesUtils.hpp"
+
+using namespace Slic3r;
+
+SCENARIO("Numbers are formatted for G-code without trailing zeros.", "[GCodeWriter]") {
+    GIVEN("append_nozero") {
+        WHEN("appending to a non-empty buffer") {
+            std::string out = "G1 X";
+            append_nozero(out, 12.34, 3);
+            THEN("The buffer is extended") {
+                REQUIRE_THAT(out, Catch::Equals("G1 X12.34"));
+            }
+        }
+        THEN("Integers are printed without decimal point") {
+            REQUIRE_THAT(to_string_nozero(5., 3), Catch::Equals("5"));
+            REQUIRE_THAT(to_string_nozero(-203., 3), Catch::Equals("-203"));
+        }
+        THEN("Values are rounded to the precision") {
+            REQUIRE_THAT(to_string_nozero(1.23456, 3), Catch::Equals("1.235"));
+            REQUIRE_THAT(to_string_nozero(-1.23456, 2), Catch::Equals("-1.23"));
+            REQUIRE_THAT(to_string_nozero(0.00004, 3), Catch::Equals("0"));
+        }
+        THEN("Precision is limited to the digits held by a double") {
+            REQUIRE_THAT(to_string_nozero(1234567.891, 15), Catch::Equals("1234567.891"));
+        }
+    }
+    GIVEN("append_defaultfloat") {
+        std::string out;
+        append_defaultfloat(out, 12345.200522, 8);
+        THEN("8 significant digits are printed") {
+            REQUIRE_THAT(out, Catch::Equals("12345.201"));
+        }
+    }
+}
+
+SCENARIO("Writer methods append the same G-code to the caller's buffer as they return.", "[GCodeWriter]") {
+    GIVEN("Two GCodeWriter instances with the same single extruder setup") {
+        GCodeWriter writer_str, writer_buf;
+        for (GCodeWriter *writer : { &writer_str, &writer_buf }) {
+            writer->config.gcode_comments.value = true;
+            writer->config.gcode_flavor.value = gcfMarlinFirmware;
+            writer->set_extruders({ 0 });
+            writer->set_tool(0);
+            writer->set_acceleration(1000);
+            writer->set_travel_acceleration(1500);
+        }
+        WHEN("The same moves are emitted") {
+            std::string gcode_str, gcode_buf = "; start\n";
+            gcode_str += writer_str.set_speed(40., "speed", ";_EXTRUDE_SET_SPEED");
+            gcode_str += writer_str.travel_to_xy(Vec2d(10.1234, -5.5), 0., "travel");
+            gcode_str += writer_str.extrude_to_xy(Vec2d(20.0004, 3.25), 0.123456, "extrude");
+            gcode_str += writer_str.extrude_to_xyz(Vec3d(1., 2., 0.2), 0.05);
+            writer_buf.set_speed(gcode_buf, 40., "speed", ";_EXTRUDE_SET_SPEED");
+            writer_buf.travel_to_xy(gcode_buf, Vec2d(10.1234, -5.5), 0., "travel");
+            writer_buf.extrude_to_xy(gcode_buf, Vec2d(20.0004, 3.25), 0.123456, "extrude");
+            writer_buf.extrude_to_xyz(gcode_buf, Vec3d(1., 2., 0.2), 0.05);
+            THEN("The output is identical and appended after the existing content") {
+                REQUIRE_THAT(gcode_buf, Catch::Equals("; start\n" + gcode_str));
+                REQUIRE(writer_str.get_position() == writer_buf.get_position());
+            }
+        }
+    }
+}
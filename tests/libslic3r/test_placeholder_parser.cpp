@@ -120,4 +120,23 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
     SECTION("complex expression") { REQUIRE(boolean_expression("printer_notes=~/.*PRINTER_VENDOR_PRUSA3D.*/ and printer_notes=~/.*PRINTER_MODEL_MK2.*/ and nozzle_diameter[0]==0.6 and num_extruders>1")); }
     SECTION("complex expression2") { REQUIRE(boolean_expression("printer_notes=~/.*PRINTER_VEwerfNDOR_PRUSA3D.*/ or printer_notes=~/.*PRINTertER_MODEL_MK2.*/ or (nozzle_diameter[0]==0.6 and num_extruders>1)")); }
     SECTION("complex expression3") { REQUIRE(! boolean_expression("printer_notes=~/.*PRINTER_VEwerfNDOR_PRUSA3D.*/ or printer_notes=~/.*PRINTertER_MODEL_MK2.*/ or (nozzle_diameter[0]==0.3 and num_extruders>1)")); }
+
+    SECTION("compiled template: constant") {
+        REQUIRE(PlaceholderParser::compile("G28 ; home\n\\[escaped\\{") != nullptr);
+        REQUIRE(parser.process("G28 ; home\n\\[escaped\\{") == "G28 ; home\n[escaped{");
+    }
+    SECTION("compiled template: variables") {
+        REQUIRE(PlaceholderParser::compile("M104 S[temperature_0] T[bar] {foo} [nozzle_diameter[foo]]") != nullptr);
+        REQUIRE(parser.process("M104 S[temperature_0] T[bar] {foo} [nozzle_diameter[foo]]") == "M104 S357 T2 0 0.6");
+        REQUIRE(parser.process("{first_layer_extrusion_width}") == "0.9");
+    }
+    SECTION("compiled template: expressions are not compiled") {
+        REQUIRE(PlaceholderParser::compile("{if foo == 0}a{endif}") == nullptr);
+        REQUIRE(PlaceholderParser::compile("{foo + 1}") == nullptr);
+        REQUIRE(parser.process("{foo + 1}") == "1");
+    }
+    SECTION("compiled template: errors are reported by the macro processor") {
+        REQUIRE(PlaceholderParser::compile("[nonexistent]") != nullptr);
+        REQUIRE_THROWS_AS(parser.process("[nonexistent]"), Slic3r::PlaceholderParserError);
+    }
 }
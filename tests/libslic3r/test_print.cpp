@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+
+#include <test_data.hpp>
+
+#include <set>
+
+using namespace Slic3r;
+using namespace Slic3r::Test;
+
+// Extrusions of all the layer regions of a print object, to compare the results of two Print::process() calls.
+static std::vector<Points> object_extrusions(const PrintObject &object)
+{
+    std::vector<Points> out;
+    for (const Layer *layer : object.layers())
+        for (const LayerRegion *layerm : layer->regions())
+            for (const ExtrusionEntityCollection *extrusions : { &layerm->perimeters, &layerm->thin_fills, &layerm->fills }) {
+                for (const Polyline &polyline : extrusions->as_polylines())
+                    out.emplace_back(polyline.points);
+                // Separator of the collections.
+                out.emplace_back();
+            }
+    return out;
+}
+
+SCENARIO("Reused perimeters match the regenerated ones", "[Print]") {
+    GIVEN("A 20mm cube with a layer range modifier processed with the reuse of perimeters enabled") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "first_layer_height",  0.3 },
+            { "layer_height",        0.3 },
+            { "perimeters",          2 },
+            { "fill_density",        "20%" }
+        });
+        Model  model;
+        Print  print;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        // The upper half of the cube is printed with a different infill density, thus it is sliced into a region of its own.
+        ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 10., 20. }];
+        // A layer range shall define its layer height.
+        range_config.set_key_value("layer_height", new ConfigOptionFloat(0.3));
+        range_config.set_key_value("fill_density", new ConfigOptionPercent(30));
+        print.set_reuse_perimeters(true);
+        print.apply(model, config);
+        print.process();
+        std::vector<std::shared_ptr<const LayerPerimetersInputs>> old_inputs;
+        for (const Layer *layer : print.objects().front()->layers())
+            old_inputs.emplace_back(layer->perimeters_inputs);
+        REQUIRE(old_inputs.front() != nullptr);
+
+        WHEN("The number of perimeters of the upper half of the cube is changed") {
+            range_config.set_key_value("perimeters", new ConfigOptionInt(3));
+            print.apply(model, config);
+            print.process();
+            const PrintObject &object = *print.objects().front();
+
+            Print  reference;
+            reference.apply(model, config);
+            reference.set_status_silent();
+            reference.process();
+
+            THEN("The perimeters of the lower half are reused") {
+                std::set<const LayerPerimetersInputs*> old_set;
+                for (const std::shared_ptr<const LayerPerimetersInputs> &inputs : old_inputs)
+                    old_set.insert(inputs.get());
+                size_t num_reused = 0;
+                for (const Layer *layer : object.layers())
+                    num_reused += old_set.count(layer->perimeters_inputs.get());
+                REQUIRE(num_reused > 10);
+                REQUIRE(num_reused < object.layers().size());
+            }
+            THEN("The extrusions are the same as those generated without reuse") {
+                REQUIRE(object.layers().size() == reference.objects().front()->layers().size());
+                REQUIRE(object_extrusions(object) == object_extrusions(*reference.objects().front()));
+            }
+        }
+        WHEN("The print is processed again with a config change invalidating the perimeters") {
+            config.set_deserialize_strict("perimeters", "3");
+            print.apply(model, config);
+            print.process();
+            THEN("No perimeters are reused") {
+                for (const Layer *layer : print.objects().front()->layers())
+                    REQUIRE(std::find(old_inputs.begin(), old_inputs.end(), layer->perimeters_inputs) == old_inputs.end());
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/SliceCache.hpp"
+#include "libslic3r/Utils.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+static SliceCache::RegionSlices test_slices(size_t num_regions, size_t num_layers)
+{
+    SliceCache::RegionSlices slices(num_regions, std::vector<ExPolygons>(num_layers));
+    for (size_t region_id = 0; region_id < num_regions; ++ region_id)
+        for (size_t layer_id = 0; layer_id < num_layers; ++ layer_id) {
+            // Some layers of some regions are empty.
+            if ((region_id + layer_id) % 3 == 2)
+                continue;
+            const coord_t d = coord_t(layer_id * 1000 + region_id * 100);
+            ExPolygon square;
+            square.contour.points = { { -scaled(10.) - d, -scaled(10.) }, { scaled(10.) + d, -scaled(10.) }, { scaled(10.) + d, scaled(10.) }, { -scaled(10.) - d, scaled(10.) } };
+            square.holes.emplace_back(Points{ { -scaled(1.), -scaled(1.) }, { -scaled(1.), scaled(1.) }, { scaled(1.), scaled(1.) }, { scaled(1.), -scaled(1.) } });
+            slices[region_id][layer_id].emplace_back(std::move(square));
+            slices[region_id][layer_id].emplace_back(Polygon{ { scaled(20.), scaled(20.) }, { scaled(25.) + d, scaled(20.) }, { scaled(20.), scaled(25.) } });
+        }
+    return slices;
+}
+
+static SliceCache::Key test_key(const std::string &mesh)
+{
+    SliceCache::Key key;
+    key.add(mesh);
+    key.add(0.0125);
+    return key;
+}
+
+static void overwrite_byte(const boost::filesystem::path &path, size_t offset_from_end)
+{
+    boost::nowide::fstream f(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+    f.seekg(0, std::ios::end);
+    const std::streamoff pos = std::streamoff(f.tellg()) - std::streamoff(offset_from_end);
+    f.seekg(pos);
+    char c = char(f.get());
+    f.seekp(pos);
+    f.put(char(c ^ 0x5a));
+}
+
+SCENARIO("Slice cache entries are validated on load", "[SliceCache]") {
+    const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    set_slice_cache_dir(dir.string());
+    ScopeGuard cleanup([&dir]() {
+        set_slice_cache_dir(std::string());
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(dir, ec);
+    });
+
+    const std::vector<float>        zs     = { 0.2f, 0.4f, 0.6f, 0.8f, 1.0f };
+    const SliceCache::RegionSlices  slices = test_slices(3, zs.size());
+    const SliceCache::Key           key    = test_key("mesh A");
+
+    GIVEN("Slices stored under a key") {
+        SliceCache::save(key, zs, slices);
+        REQUIRE(boost::filesystem::exists(SliceCache::entry_path(key)));
+        WHEN("They are loaded with the same key") {
+            SliceCache::RegionSlices loaded;
+            bool ok = SliceCache::load(key, zs, slices.size(), loaded);
+            THEN("The same slices are returned") {
+                REQUIRE(ok);
+                REQUIRE(loaded == slices);
+            }
+        }
+        WHEN("They are loaded with other Z heights or another number of regions") {
+            SliceCache::RegionSlices loaded;
+            THEN("The entry is rejected") {
+                REQUIRE(! SliceCache::load(key, { 0.2f, 0.4f, 0.6f, 0.8f, 1.1f }, slices.size(), loaded));
+                REQUIRE(! SliceCache::load(key, zs, slices.size() + 1, loaded));
+            }
+        }
+        WHEN("The entry is found under the file name of another key, as if the hashes of the keys collided") {
+            const SliceCache::Key other_key = test_key("mesh B");
+            boost::filesystem::copy_file(SliceCache::entry_path(key), SliceCache::entry_path(other_key));
+            SliceCache::RegionSlices loaded;
+            THEN("The entry is rejected") {
+                REQUIRE(! SliceCache::load(other_key, zs, slices.size(), loaded));
+                REQUIRE(loaded.empty());
+            }
+        }
+        WHEN("The payload of the entry is corrupted") {
+            overwrite_byte(SliceCache::entry_path(key), 10);
+            SliceCache::RegionSlices loaded;
+            THEN("The entry is rejected") {
+                REQUIRE(! SliceCache::load(key, zs, slices.size(), loaded));
+                REQUIRE(loaded.empty());
+            }
+        }
+        WHEN("The entry is truncated") {
+            boost::filesystem::resize_file(SliceCache::entry_path(key), boost::filesystem::file_size(SliceCache::entry_path(key)) - 7);
+            SliceCache::RegionSlices loaded;
+            THEN("The entry is rejected") {
+                REQUIRE(! SliceCache::load(key, zs, slices.size(), loaded));
+                REQUIRE(loaded.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Slice cache entries are named by the SHA-1 digest of the key", "[SliceCache]") {
+    GIVEN("A key") {
+        SliceCache::Key key;
+        key.add("abc", 3);
+        THEN("The file name of the entry is the same on all platforms") {
+            REQUIRE(key.digest() == "a9993e364706816aba3e25717850c26c9cd0d89d");
+            REQUIRE(SliceCache::entry_path(key).filename().string() == "a9993e364706816aba3e25717850c26c9cd0d89d.slices");
+        }
+    }
+}
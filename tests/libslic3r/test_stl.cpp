@@ -3,6 +3,10 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
 
+#include <admesh/stl.h>
+
+#include <array>
+
 using namespace Slic3r;
 
 static inline std::string stl_path(const char* path)
@@ -55,3 +59,90 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+using StlTriangle = std::array<stl_vertex, 3>;
+
+static stl_file stl_from_triangles(const std::vector<StlTriangle> &triangles)
+{
+	stl_file stl;
+	stl.stats.type = inmemory;
+	stl.stats.number_of_facets = uint32_t(triangles.size());
+	stl.stats.original_num_facets = int(triangles.size());
+	stl.facet_start.resize(triangles.size());
+	stl.neighbors_start.resize(triangles.size());
+	for (size_t i = 0; i < triangles.size(); ++ i)
+		for (int j = 0; j < 3; ++ j)
+			stl.facet_start[i].vertex[j] = triangles[i][j];
+	return stl;
+}
+
+// Verify the neighbors of each facet edge against the expected facet indices and the symmetry of the connections.
+// The shared edge of two neighbors shall be oriented oppositely, unless one of the facets is flipped.
+static void check_neighbors(const stl_file &stl, const std::vector<std::array<int, 3>> &expected, const std::vector<bool> &flipped)
+{
+	REQUIRE(stl.neighbors_start.size() == expected.size());
+	for (size_t i = 0; i < expected.size(); ++ i)
+		for (int j = 0; j < 3; ++ j) {
+			const int neighbor = stl.neighbors_start[i].neighbor[j];
+			REQUIRE(neighbor == expected[i][j]);
+			if (neighbor == -1)
+				continue;
+			const int vnot = stl.neighbors_start[i].which_vertex_not[j];
+			// The vertex not on the shared edge.
+			const stl_vertex &opposite = stl.facet_start[neighbor].vertex[vnot % 3];
+			REQUIRE(opposite != stl.facet_start[i].vertex[j]);
+			REQUIRE(opposite != stl.facet_start[i].vertex[(j + 1) % 3]);
+			REQUIRE((vnot > 2) == (flipped[i] != flipped[neighbor]));
+			// The neighbor is connected back to this facet.
+			REQUIRE(stl.neighbors_start[neighbor].neighbor[(vnot + 1) % 3] == int(i));
+		}
+}
+
+SCENARIO("Connecting the facets of an STL mesh by their shared edges", "[stl]") {
+	const stl_vertex p0(0.f, 0.f, 0.f), p1(1.f, 0.f, 0.f), p2(0.f, 1.f, 0.f), p3(0.f, 0.f, 1.f);
+	// Tetrahedron with outwards facing facets.
+	const std::vector<StlTriangle> tetrahedron { { p0, p2, p1 }, { p0, p1, p3 }, { p0, p3, p2 }, { p1, p2, p3 } };
+	// Neighbor facet of the edges (vertex[j], vertex[j + 1]).
+	const std::vector<std::array<int, 3>> tetrahedron_neighbors { { 2, 3, 1 }, { 0, 3, 2 }, { 1, 3, 0 }, { 0, 2, 1 } };
+
+	GIVEN("A closed mesh") {
+		stl_file stl = stl_from_triangles(tetrahedron);
+		stl_check_facets_exact(&stl);
+		THEN("All edges are connected") {
+			check_neighbors(stl, tetrahedron_neighbors, { false, false, false, false });
+			REQUIRE(stl.stats.connected_edges == 12);
+			REQUIRE(stl.stats.connected_facets_3_edge == 4);
+		}
+	}
+	GIVEN("An open mesh") {
+		stl_file stl = stl_from_triangles({ tetrahedron[0], tetrahedron[1], tetrahedron[2] });
+		stl_check_facets_exact(&stl);
+		THEN("The edges of the missing facet stay open") {
+			check_neighbors(stl, { { 2, -1, 1 }, { 0, -1, 2 }, { 1, -1, 0 } }, { false, false, false });
+			REQUIRE(stl.stats.connected_edges == 6);
+			REQUIRE(stl.stats.connected_facets_2_edge == 3);
+			REQUIRE(stl.stats.connected_facets_3_edge == 0);
+		}
+	}
+	GIVEN("A closed mesh with a flipped facet") {
+		std::vector<StlTriangle> triangles = tetrahedron;
+		std::swap(triangles[3][1], triangles[3][2]);
+		stl_file stl = stl_from_triangles(triangles);
+		stl_check_facets_exact(&stl);
+		THEN("All edges are connected, the edges of the flipped facet are marked") {
+			check_neighbors(stl, { { 2, 3, 1 }, { 0, 3, 2 }, { 1, 3, 0 }, { 1, 2, 0 } }, { false, false, false, true });
+			REQUIRE(stl.stats.connected_facets_3_edge == 4);
+		}
+	}
+	GIVEN("A closed mesh with a vertex stored with negative zero coordinates") {
+		std::vector<StlTriangle> triangles = tetrahedron;
+		triangles[1][0] = stl_vertex(-0.f, -0.f, 0.f);
+		triangles[2][0] = stl_vertex(0.f, -0.f, -0.f);
+		stl_file stl = stl_from_triangles(triangles);
+		stl_check_facets_exact(&stl);
+		THEN("The negative zeros match the positive zeros") {
+			check_neighbors(stl, tetrahedron_neighbors, { false, false, false, false });
+			REQUIRE(stl.stats.connected_facets_3_edge == 4);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/SupportMaterial.hpp"
+
+#include <cmath>
+
+using namespace Slic3r;
+
+SCENARIO("Running union of the layers below", "[SupportMaterial]") {
+    GIVEN("300 layers of circles and rectangles wandering around the build plate") {
+        std::vector<Polygons> layers(300);
+        for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id) {
+            const double a = 0.1 * double(layer_id);
+            Polygon circle;
+            for (int i = 0; i < 64; ++ i) {
+                const double b = 2. * M_PI * double(i) / 64.;
+                circle.points.emplace_back(scaled<coord_t>(30. * std::cos(a) + 5. * std::cos(b)), scaled<coord_t>(30. * std::sin(a) + 5. * std::sin(b)));
+            }
+            Polygon rectangle { { scaled<coord_t>(-40.), scaled<coord_t>(-1.) }, { scaled<coord_t>(40.), scaled<coord_t>(-1.) }, { scaled<coord_t>(40.), scaled<coord_t>(1.) }, { scaled<coord_t>(-40.), scaled<coord_t>(1.) } };
+            rectangle.rotate(0.37 * double(layer_id));
+            // Same as PrintObjectSupportMaterial::buildplate_covered() does with the layer slices.
+            layers[layer_id] = offset(Polygons{ circle, rectangle }, scale_(0.01));
+        }
+        WHEN("The running union is calculated") {
+            std::vector<Polygons> covered = running_union(layers);
+            THEN("It is the same as the serial running union of all the layers") {
+                REQUIRE(covered.size() == layers.size());
+                Polygons serial;
+                for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id) {
+                    // Same as PrintObjectSupportMaterial::buildplate_covered() did layer by layer.
+                    polygons_append(serial, layers[layer_id]);
+                    serial = union_(serial);
+                    REQUIRE(covered[layer_id] == serial);
+                }
+            }
+        }
+    }
+    GIVEN("No layers") {
+        THEN("The running union is empty") {
+            REQUIRE(running_union({}).empty());
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace Slic3r;
+
+SCENARIO( "TriangleMesh: slicing at many non-uniformly spaced planes.") {
+    GIVEN( "A sphere of radius 10mm") {
+        indexed_triangle_set sphere = its_make_sphere(10., 2. * PI / 120.);
+        WHEN( "sliced at planes crowded around the equator, at a vertex height and outside of the sphere") {
+            std::vector<float> zs { -12.f, -9.5f, -3.f };
+            for (float z = -0.5f; z < 0.5f; z += 0.01f)
+                zs.emplace_back(z);
+            for (float z : { 0.f, 0.5f, 7.f, 9.99f, 15.f })
+                zs.emplace_back(z);
+            std::sort(zs.begin(), zs.end());
+            std::vector<Polygons> layers = slice_mesh(sphere, zs, MeshSlicingParams{});
+            THEN( "every layer matches the slice at the single plane") {
+                REQUIRE(layers.size() == zs.size());
+                for (size_t i = 0; i < zs.size(); ++ i) {
+                    Polygons single = slice_mesh(sphere, zs[i], MeshSlicingParams{});
+                    REQUIRE(layers[i].size() == single.size());
+                    double area = 0., area_single = 0.;
+                    for (const Polygon &poly : layers[i])
+                        area += poly.area();
+                    for (const Polygon &poly : single)
+                        area_single += poly.area();
+                    REQUIRE(std::abs(area - area_single) <= 1e-6 * std::max(1., std::abs(area_single)));
+                }
+            }
+        }
+    }
+}
+
+#ifdef TEST_PERFORMANCE
+TEST_CASE("Slicing of a mesh with millions of triangles") {
+    // About 5.3M triangles.
+    indexed_triangle_set sphere = its_make_sphere(50., 2. * PI / 2300.);
+    std::vector<float> zs;
+    for (float z = -50.f + 0.1f; z < 50.f; z += 0.2f)
+        zs.emplace_back(z);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<ExPolygons> layers = slice_mesh_ex(sphere, zs, MeshSlicingParamsEx{});
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Slicing " << sphere.indices.size() << " triangles at " << zs.size() << " planes: " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << std::endl;
+    REQUIRE(layers.size() == zs.size());
+}
+#endif // TEST_PERFORMANCE